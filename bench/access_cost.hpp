@@ -0,0 +1,100 @@
+#ifndef GBAXX_BENCH_ACCESS_COST_HPP
+#define GBAXX_BENCH_ACCESS_COST_HPP
+
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+namespace bench {
+
+enum class region : uint8 {
+    bios,
+    ewram,
+    iwram,
+    io,
+    palette,
+    vram,
+    oam,
+    rom,
+    sram
+};
+
+/**
+ * CPU cycles per access to a memory region, non-sequential (N) and sequential (S), for 16 and 32-bit accesses
+ *
+ * Figures are GBATEK's memory timings. ROM uses the power-on waitstate setting (4/2, so N = 5 and S = 3 for a
+ * halfword; a word is two halfword accesses) and SRAM the power-on 4 wait states. Palette RAM, VRAM and OAM are
+ * listed without the extra cycle they cost while the display is reading them.
+ */
+struct access_cost {
+    const char * name;
+    uint8 bus_bits;
+    uint8 n16;
+    uint8 s16;
+    uint8 n32;
+    uint8 s32;
+};
+
+constexpr access_cost access_costs[] = {
+    { "bios", 32, 1, 1, 1, 1 },
+    { "ewram", 16, 3, 3, 6, 6 },
+    { "iwram", 32, 1, 1, 1, 1 },
+    { "io", 32, 1, 1, 1, 1 },
+    { "palette", 16, 1, 1, 2, 2 },
+    { "vram", 16, 1, 1, 2, 2 },
+    { "oam", 32, 1, 1, 1, 1 },
+    { "rom", 16, 5, 3, 8, 6 },
+    { "sram", 8, 5, 5, 5, 5 }
+};
+
+/**
+ * A run of data accesses to one region; the first is non-sequential and the rest sequential
+ */
+struct access {
+    region where;
+    uint8 bits; ///< 8, 16 or 32
+    uint32 count;
+};
+
+/**
+ * What one operation does on hardware, for estimating its cost
+ */
+struct profile {
+    region code; ///< where the instructions are fetched from
+    bool arm; ///< ARM (32-bit fetches) rather than Thumb
+    uint32 instructions; ///< executed per operation
+    uint32 internal; ///< extra internal cycles, such as multiplies (1 to 4) and loads (1)
+    access data[3];
+};
+
+/**
+ * Cycles for a run of accesses
+ */
+constexpr uint32 access_cycles( const access& run ) noexcept {
+    if ( !run.count ) {
+        return 0;
+    }
+    const auto& cost = access_costs[uint32( run.where )];
+    const auto wide = run.bits == 32;
+    return ( wide ? cost.n32 : cost.n16 ) + ( run.count - 1 ) * ( wide ? cost.s32 : cost.s16 );
+}
+
+/**
+ * Estimated cycles per operation: instruction fetches (all sequential; branches are not modelled), data accesses and
+ * internal cycles
+ */
+constexpr uint32 estimate_cycles( const profile& p ) noexcept {
+    const auto& code = access_costs[uint32( p.code )];
+    auto cycles = p.instructions * ( p.arm ? code.s32 : code.s16 ) + p.internal;
+    for ( const auto& run : p.data ) {
+        cycles += access_cycles( run );
+    }
+    return cycles;
+}
+
+static_assert( estimate_cycles( { region::iwram, true, 4, 0, { { region::iwram, 32, 2 } } } ) == 6, "one cycle per IWRAM fetch and access" );
+static_assert( estimate_cycles( { region::rom, false, 2, 0, { { region::ewram, 16, 2 } } } ) == 12, "ROM fetches 3 cycles, EWRAM halfwords 3" );
+
+} // bench
+} // gba
+
+#endif // define GBAXX_BENCH_ACCESS_COST_HPP
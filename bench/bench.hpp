@@ -0,0 +1,82 @@
+#ifndef GBAXX_BENCH_BENCH_HPP
+#define GBAXX_BENCH_BENCH_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <gba/types/cycles.hpp>
+#include <gba/types/int_type.hpp>
+
+#include "access_cost.hpp"
+
+namespace gba {
+namespace bench {
+
+/**
+ * Keeps the optimizer from removing a computation whose result is otherwise unused
+ */
+template <typename T>
+inline void keep( const T& value ) noexcept {
+    asm volatile( "" :: "g"( &value ) : "memory" );
+}
+
+/**
+ * A benchmark: run() performs ops operations per call
+ */
+struct benchmark {
+    const char * name;
+    uint32 ops;
+    void ( * run )();
+    profile cost;
+};
+
+/**
+ * Time each benchmark on the host and print ns and millions of operations per second next to the estimated GBA
+ * cycles per operation; the estimates come from each benchmark's hand-written profile, so only the host columns move
+ * with the code
+ * @param filter only run benchmarks whose name contains this, or everything if null
+ * @return benchmarks run
+ */
+template <unsigned N>
+inline uint32 run_all( const benchmark ( & benchmarks )[N], const char * filter ) noexcept {
+    using clock = std::chrono::steady_clock;
+    constexpr auto budget = std::chrono::milliseconds( 100 );
+
+    std::printf( "%-32s %12s %12s %12s %10s\n", "benchmark", "host ns/op", "host Mop/s", "est. cycles", "% frame" );
+
+    uint32 count = 0;
+    for ( const auto& b : benchmarks ) {
+        if ( filter && !std::strstr( b.name, filter ) ) {
+            continue;
+        }
+
+        b.run();
+
+        // Double the calls until the batch fills the time budget, so short operations are not dominated by the clock
+        uint32 calls = 1;
+        auto elapsed = clock::duration {};
+        for ( ; ; calls *= 2 ) {
+            const auto start = clock::now();
+            for ( uint32 ii = 0; ii < calls; ++ii ) {
+                b.run();
+            }
+            elapsed = clock::now() - start;
+            if ( elapsed >= budget || calls >= ( 1u << 30 ) ) {
+                break;
+            }
+        }
+
+        const auto ns = std::chrono::duration<double, std::nano>( elapsed ).count() / ( double( calls ) * b.ops );
+        const auto cycles = estimate_cycles( b.cost );
+        const auto frame = 100.0 * cycles / cycles_per_frame.count();
+        std::printf( "%-32s %12.2f %12.2f %12u %9.4f%%\n", b.name, ns, 1e3 / ns, cycles, frame );
+        ++count;
+    }
+    return count;
+}
+
+} // bench
+} // gba
+
+#endif // define GBAXX_BENCH_BENCH_HPP
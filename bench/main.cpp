@@ -0,0 +1,282 @@
+#include <gba/allocator/mode0.hpp>
+#include <gba/allocator/palette.hpp>
+#include <gba/display/bitmap.hpp>
+#include <gba/display/page_flip.hpp>
+#include <gba/display/rasterizer.hpp>
+#include <gba/display/text_renderer.hpp>
+#include <gba/sound/mixer.hpp>
+#include <gba/types/fixed_point.hpp>
+#include <gba/types/fixed_point_funcs.hpp>
+#include <gba/types/fixed_point_make.hpp>
+#include <gba/types/fixed_point_operators.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/matrix.hpp>
+
+#include "bench.hpp"
+
+using namespace gba;
+using namespace gba::bench;
+
+namespace {
+
+using fixed16 = make_fixed<15, 16>;
+using fixed8 = make_fixed<7, 8>;
+
+constexpr uint32 batch = 256;
+
+fixed16 operands_a[batch];
+fixed16 operands_b[batch];
+fixed16 results[batch];
+
+int8 sample_data[1024];
+
+uint16 page_pixels[240 * 160 / 2];
+uint8 texture_texels[32 * 32];
+
+
+void fixed_multiply() {
+    for ( uint32 ii = 0; ii < batch; ++ii ) {
+        results[ii] = fixed16( operands_a[ii] * operands_b[ii] );
+    }
+    keep( results );
+}
+
+void fixed_divide() {
+    for ( uint32 ii = 0; ii < batch; ++ii ) {
+        results[ii] = fixed16( operands_a[ii] / operands_b[ii] );
+    }
+    keep( results );
+}
+
+void fixed_sin() {
+    for ( uint32 ii = 0; ii < batch; ++ii ) {
+        results[ii] = fixed16( gba::sin( operands_a[ii] ) );
+    }
+    keep( results );
+}
+
+void fixed_cos() {
+    for ( uint32 ii = 0; ii < batch; ++ii ) {
+        results[ii] = fixed16( gba::cos( operands_a[ii] ) );
+    }
+    keep( results );
+}
+
+void matrix_multiply() {
+    static auto a = mat4x4<fixed8>( fixed8( 1.5 ) );
+    static auto b = mat4x4<fixed8>( fixed8( 0.75 ) );
+    keep( a );
+    keep( b );
+    const auto c = a * b;
+    keep( c );
+}
+
+void palette_allocate() {
+    static allocator::palette palette;
+    auto background = palette.allocate_background( 48 );
+    auto object = palette.allocate_object( 16 );
+    keep( background );
+    keep( object );
+    palette.deallocate( object );
+    palette.deallocate( background );
+}
+
+void tile_allocate() {
+    static allocator::mode<0>::background vram;
+    auto screen = vram.allocate_screen( screen_size_regular::_32x32 );
+    auto tiles = vram.allocate_tile4bpp( 256 );
+    keep( screen );
+    keep( tiles );
+    vram.deallocate( tiles );
+    vram.deallocate( screen );
+}
+
+constexpr uint32 mixer_channels = 8;
+constexpr uint32 mixer_samples = 304;
+
+void mixer_mix() {
+    static auto * const mix = [] {
+        static sound::mixer<mixer_channels, mixer_samples> m;
+        for ( uint32 cc = 0; cc < mixer_channels; ++cc ) {
+            // Every voice loops the whole sample at a different pitch, so none stops during the run
+            m.play( cc, sample_data, sizeof( sample_data ), m.step_for( 8000 + cc * 1500 ), sizeof( sample_data ) );
+            m.set_volume( cc, 48, int32( cc * 16 ) - 64 );
+        }
+        return &m;
+    }();
+    mix->mix();
+    keep( *mix );
+}
+
+constexpr uint32 line_count = 32;
+
+// Every line crosses the whole page and is clipped at both sides, lighting one pixel per column
+void bitmap_lines() {
+    bitmap_mode4 page { page_pixels };
+    for ( int32 ii = 0; ii < int32( line_count ); ++ii ) {
+        page.line( -20, ii * 5, 259, 159 - ii * 5, uint8( ii + 1 ) );
+    }
+    keep( page_pixels );
+}
+
+constexpr uint32 dirty_adds = 64;
+
+// A frame of scattered 16x16 sprites, each marking its old and new place; neighbours touch and merge
+void dirty_rect_merge() {
+    dirty_rects<16, 4> rects { 240, 160 };
+    for ( int32 ii = 0; ii < int32( dirty_adds ); ++ii ) {
+        rects.add( ( ii * 53 ) % 232, ( ii * 29 ) % 152, 16, 16 );
+    }
+    keep( rects );
+}
+
+constexpr int32 mesh_columns = 12;
+constexpr int32 mesh_rows = 8;
+constexpr uint32 mesh_triangles = mesh_columns * mesh_rows * 2;
+
+// A 12x8 grid of 20 pixel cells over the page, inner vertices jittered, two triangles per cell
+const raster_vertex * mesh() {
+    static raster_vertex grid[( mesh_rows + 1 ) * ( mesh_columns + 1 )];
+    static const auto once = [] {
+        for ( int32 y = 0; y <= mesh_rows; ++y ) {
+            for ( int32 x = 0; x <= mesh_columns; ++x ) {
+                const auto inner = x > 0 && x < mesh_columns && y > 0 && y < mesh_rows;
+                const auto jitter = inner ? ( ( x * 7 + y * 13 ) % 9 - 4 ) << 16 : 0;
+                grid[y * ( mesh_columns + 1 ) + x] = raster_vertex {
+                    raster_fixed::from_data( ( x * 20 << 16 ) + jitter ),
+                    raster_fixed::from_data( ( y * 20 << 16 ) - jitter ),
+                    raster_fixed( x * 8 ),
+                    raster_fixed( y * 8 )
+                };
+            }
+        }
+        return true;
+    }();
+    keep( once );
+    return grid;
+}
+
+template <class Fill>
+void mesh_triangles_each( Fill&& fill ) {
+    const auto * grid = mesh();
+    for ( int32 y = 0; y < mesh_rows; ++y ) {
+        for ( int32 x = 0; x < mesh_columns; ++x ) {
+            const auto * top = grid + y * ( mesh_columns + 1 ) + x;
+            const auto * bottom = top + mesh_columns + 1;
+            fill( top[0], top[1], bottom[0] );
+            fill( top[1], bottom[1], bottom[0] );
+        }
+    }
+}
+
+void raster_flat() {
+    rasterizer<bitmap_mode4> raster { bitmap_mode4 { page_pixels } };
+    uint8 color = 0;
+    mesh_triangles_each( [&]( const raster_vertex& a, const raster_vertex& b, const raster_vertex& c ) {
+        raster.fill( a, b, c, ++color );
+    } );
+    keep( page_pixels );
+}
+
+void raster_textured() {
+    rasterizer<bitmap_mode4> raster { bitmap_mode4 { page_pixels } };
+    const raster_texture texture { texture_texels, 5, 5 };
+    mesh_triangles_each( [&]( const raster_vertex& a, const raster_vertex& b, const raster_vertex& c ) {
+        raster.fill( a, b, c, texture );
+    } );
+    keep( page_pixels );
+}
+
+// A printable ASCII font of made up 8 row glyphs, 3 to 7 pixels wide
+const font_1bpp& text_font() {
+    static uint8 glyphs[95 * 8];
+    static uint8 widths[95];
+    static font_1bpp font { glyphs, widths, ' ', 95, 8 };
+    static const auto once = [] {
+        for ( uint32 ii = 0; ii < 95; ++ii ) {
+            widths[ii] = uint8( 3 + ii % 5 );
+            for ( uint32 row = 0; row < 7; ++row ) {
+                glyphs[ii * 8 + row] = uint8( ( ii * 37 + row * 11 ) & ( ( 1u << ( widths[ii] - 1 ) ) - 1 ) );
+            }
+        }
+        return true;
+    }();
+    keep( once );
+    return font;
+}
+
+uint32 text_tiles[1024 * 8];
+screen_tile text_screen[32 * 32];
+
+// A full 30x20 tile page of prose from an empty cache, as when a dialog page opens
+void text_page() {
+    static text_renderer<2048> text { text_tiles, 0, 1024, text_screen, screen_size_regular::_32x32, text_font() };
+    static const char * const lines[] = {
+        "The quick brown fox jumps over the lazy dog, ",
+        "then naps in the sun while packs of wolves eye",
+        "the hens. Five dozen liquor jugs, boxed, wait "
+    };
+    text.reset();
+    for ( uint32 row = 0; row < 20; ++row ) {
+        text.print( 0, row, lines[row % 3], uint8( 1 + row % 15 ) );
+    }
+    keep( text_screen );
+}
+
+/*
+ * Hardware profiles are hand estimates, not measurements: they describe the code when it was written and do not follow
+ * it when it changes, so only the host timings show regressions. Profiles are of Thumb code in ROM built with -O2, data
+ * in IWRAM unless noted:
+ * - 16.16 multiply: two loads, __aeabi_lmul (Thumb has no long multiply), shifts and a store
+ * - 16.16 divide: a 64 by 32-bit __aeabi_ldivmod, a few hundred instructions
+ * - sin/cos: radian to binary angle, then the polynomial in detail::sin_bam16 (two multiplies)
+ * - 4x4 7.8 matrix multiply: 64 multiplies of halfwords, 48 adds and 16 stores
+ * - mixer, per stereo output sample of 8 voices: ARM in IWRAM, per voice an end check, a signed byte load from ROM,
+ *   two multiply-accumulates into the IWRAM sums and a position step; then clearing and resolving both sums
+ * - bitmap line, per mode 4 pixel: a halfword read-modify-write of VRAM, then the error step and loop branch
+ * - triangles, per 200 pixel triangle of about 20 rows: sorting, three 16.16 edge divides (__aeabi_ldivmod), then per
+ *   row the edge steps and an hline of a halfword read-modify-write at each end and word fills between. Textured adds
+ *   four 64-bit gradient divides and per row two long multiplies; its span loop is ARM in IWRAM at about 8
+ *   instructions and a ROM texel load per pixel, counted here at the Thumb ROM rate, so that row overestimates
+ * - text page, 572 tiles from 913 glyphs: ARM in IWRAM, per glyph eight byte loads from ROM gathered into a register
+ *   pair and shifted into the pending tile and its spill, per tile a hash with one multiply and a probe of the table,
+ *   for the 415 missed tiles eight rows expanded with a multiply each and stored to VRAM, and for the 157 hits the
+ *   same eight rows expanded and compared against the tile read back from VRAM
+ * - dirty rect merge, per region added: clipping and alignment, then an edge test against each of up to 16 rects in
+ *   IWRAM, with about one merge and one best-growth search per add once the set is full
+ * - allocators: a few iterations of the bitset search per allocation
+ *
+ * Not covered, as the library paths cannot run on a host:
+ * - decompression, which is BIOS-only (SWI)
+ * - OAM and palette RAM copies, which are DMA3 or ARM assembly writing fixed addresses
+ */
+constexpr benchmark benchmarks[] = {
+    { "fixed 16.16 multiply", batch, fixed_multiply, { region::rom, false, 28, 4, { { region::iwram, 32, 3 } } } },
+    { "fixed 16.16 divide", batch, fixed_divide, { region::rom, false, 300, 0, { { region::iwram, 32, 3 } } } },
+    { "fixed sin", batch, fixed_sin, { region::rom, false, 16, 4, { { region::iwram, 32, 2 } } } },
+    { "fixed cos", batch, fixed_cos, { region::rom, false, 17, 4, { { region::iwram, 32, 2 } } } },
+    { "mat4x4 7.8 multiply", 1, matrix_multiply, { region::rom, false, 340, 128, { { region::iwram, 16, 128 }, { region::iwram, 16, 16 } } } },
+    { "mixer 8 voices (per sample)", mixer_samples, mixer_mix, { region::iwram, true, 82, 40, { { region::rom, 16, 8 }, { region::iwram, 32, 38 } } } },
+    { "bitmap mode 4 line (per pixel)", line_count * 240, bitmap_lines, { region::rom, false, 12, 1, { { region::vram, 16, 2 } } } },
+    { "mode 4 flat triangle", mesh_triangles, raster_flat, { region::rom, false, 1800, 40, { { region::vram, 16, 80 }, { region::vram, 32, 50 }, { region::iwram, 32, 60 } } } },
+    { "mode 4 textured triangle", mesh_triangles, raster_textured, { region::rom, false, 4800, 260, { { region::rom, 8, 200 }, { region::vram, 32, 50 }, { region::vram, 16, 80 } } } },
+    { "text page 30x20 tiles", 1, text_page, { region::iwram, true, 134000, 20500, { { region::rom, 8, 7300 }, { region::iwram, 32, 3000 }, { region::vram, 32, 4600 } } } },
+    { "dirty rect merge (per region)", dirty_adds, dirty_rect_merge, { region::rom, false, 220, 20, { { region::iwram, 16, 64 }, { region::iwram, 32, 4 } } } },
+    { "palette allocate/free", 1, palette_allocate, { region::rom, false, 90, 0, { { region::iwram, 32, 6 } } } },
+    { "mode 0 vram allocate/free", 1, tile_allocate, { region::rom, false, 160, 0, { { region::iwram, 32, 8 } } } }
+};
+
+} // namespace
+
+int main( int argc, char * argv[] ) {
+    for ( uint32 ii = 0; ii < batch; ++ii ) {
+        operands_a[ii] = fixed16::from_data( int32( ii * 0x1234 + 0x10000 ) );
+        operands_b[ii] = fixed16::from_data( int32( ii * 0x321 + 0x8000 ) );
+    }
+    for ( uint32 ii = 0; ii < sizeof( sample_data ); ++ii ) {
+        sample_data[ii] = int8( ( ii * 37 ) & 0xff );
+    }
+
+    const char * filter = argc > 1 ? argv[1] : nullptr;
+    return run_all( benchmarks, filter ) ? 0 : 1;
+}
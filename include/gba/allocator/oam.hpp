@@ -12,6 +12,7 @@ void __aeabi_memcpy4( void * dest, const void * src, std::size_t n );
 #endif
 
 #include <gba/object/attributes.hpp>
+#include <gba/types/int_cast.hpp>
 
 namespace gba {
 namespace allocator {
@@ -112,8 +113,8 @@ public:
         auto * dest = reinterpret_cast<void *>( 0x7000000 + start() );
 
         reg::dma3cnt_h::write( {} );
-        reg::dma3sad::write( reinterpret_cast<uint32>( data ) );
-        reg::dma3dad::write( reinterpret_cast<uint32>( dest ) );
+        reg::dma3sad::write( address_cast( data ) );
+        reg::dma3dad::write( address_cast( dest ) );
         reg::dma3cnt::write( {
             .transfers = uint16( size / 4 ),
             .control = { .type = dma_control::type::word, .enable = true }
@@ -125,8 +126,8 @@ public:
         auto * dest = reinterpret_cast<void *>( 0x7000000 + ( start() + offset ) );
 
         reg::dma3cnt_h::write( {} );
-        reg::dma3sad::write( reinterpret_cast<uint32>( data ) );
-        reg::dma3dad::write( reinterpret_cast<uint32>( dest ) );
+        reg::dma3sad::write( address_cast( data ) );
+        reg::dma3dad::write( address_cast( dest ) );
         reg::dma3cnt::write( {
             .transfers = uint16( size / 4 ),
             .control = { .type = dma_control::type::word, .enable = true }
@@ -188,7 +189,7 @@ public:
 
     [[nodiscard]]
     oam_buffer memory_protect( const void * const address, const uint32 length ) noexcept {
-        const auto shift = ( reinterpret_cast<uint32>( address ) - 0x7000000 ) / 32u;
+        const auto shift = ( address_cast( address ) - 0x7000000 ) / 32u;
         const auto bits = ( length + 31u ) / 32u;
 
         const auto mask = ( ( 1u << bits ) - 1 ) << shift;
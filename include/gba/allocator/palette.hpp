@@ -2,6 +2,7 @@
 #define GBAXX_ALLOCATOR_PALETTE_HPP
 
 #include <gba/registers/dma.hpp>
+#include <gba/types/int_cast.hpp>
 #include <gba/types/int_type.hpp>
 
 #if defined( __agb_abi )
@@ -96,8 +97,8 @@ public:
         auto * dest = reinterpret_cast<void *>( 0x5000000 + start() );
 
         reg::dma3cnt_h::write( {} );
-        reg::dma3sad::write( reinterpret_cast<uint32>( data ) );
-        reg::dma3dad::write( reinterpret_cast<uint32>( dest ) );
+        reg::dma3sad::write( address_cast( data ) );
+        reg::dma3dad::write( address_cast( dest ) );
         reg::dma3cnt::write( {
             .transfers = uint16( size / 2 ),
             .control = { .enable = true }
@@ -108,8 +109,8 @@ public:
         auto * dest = reinterpret_cast<void *>( 0x5000000 + ( start() + offset ) );
 
         reg::dma3cnt_h::write( {} );
-        reg::dma3sad::write( reinterpret_cast<uint32>( data ) );
-        reg::dma3dad::write( reinterpret_cast<uint32>( dest ) );
+        reg::dma3sad::write( address_cast( data ) );
+        reg::dma3dad::write( address_cast( dest ) );
         reg::dma3cnt::write( {
             .transfers = uint16( size / 2 ),
             .control = { .enable = true }
@@ -132,7 +133,7 @@ public:
 
     [[nodiscard]]
     palette_buffer memory_protect( const void * const address, const uint32 length ) noexcept {
-        const auto shift = ( reinterpret_cast<uint32>( address ) - 0x5000000 ) / 32u;
+        const auto shift = ( address_cast( address ) - 0x5000000 ) / 32u;
         const auto bits = ( length + 31u ) / 32u;
 
         const auto mask = ( ( 1u << bits ) - 1 ) << shift;
@@ -5,6 +5,7 @@
 
 #include <gba/allocator/buffer.hpp>
 #include <gba/registers/dma.hpp>
+#include <gba/types/int_cast.hpp>
 #include <gba/types/screen_size.hpp>
 #include <gba/types/screen_tile.hpp>
 
@@ -80,8 +81,8 @@ public:
         auto * dest = map();
 
         reg::dma3cnt_h::write( {} );
-        reg::dma3sad::write( reinterpret_cast<uint32>( data ) );
-        reg::dma3dad::write( reinterpret_cast<uint32>( dest ) );
+        reg::dma3sad::write( address_cast( data ) );
+        reg::dma3dad::write( address_cast( dest ) );
         reg::dma3cnt::write( {
             .transfers = uint16( size / 2 ),
             .control = { .enable = true }
@@ -94,8 +95,8 @@ public:
         auto * dest = map_range( offset );
 
         reg::dma3cnt_h::write( {} );
-        reg::dma3sad::write( reinterpret_cast<uint32>( data ) );
-        reg::dma3dad::write( reinterpret_cast<uint32>( dest ) );
+        reg::dma3sad::write( address_cast( data ) );
+        reg::dma3dad::write( address_cast( dest ) );
         reg::dma3cnt::write( {
             .transfers = uint16( size / 2 ),
             .control = { .enable = true }
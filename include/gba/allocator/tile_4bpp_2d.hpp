@@ -6,6 +6,7 @@
 #include <gba/allocator/buffer.hpp>
 #include <gba/registers/dma.hpp>
 #include <gba/types/color.hpp>
+#include <gba/types/int_cast.hpp>
 
 #if defined( __agb_abi )
 #include <cstddef>
@@ -72,8 +73,8 @@ public:
         auto * dest = map( index );
 
         reg::dma3cnt_h::write( {} );
-        reg::dma3sad::write( reinterpret_cast<uint32>( data ) );
-        reg::dma3dad::write( reinterpret_cast<uint32>( dest ) );
+        reg::dma3sad::write( address_cast( data ) );
+        reg::dma3dad::write( address_cast( dest ) );
         reg::dma3cnt::write( {
             .transfers = uint16( size / 4 ),
              .control = { .type = dma_control::type::word, .enable = true }
@@ -86,8 +87,8 @@ public:
         auto * dest = map_range( index, offset );
 
         reg::dma3cnt_h::write( {} );
-        reg::dma3sad::write( reinterpret_cast<uint32>( data ) );
-        reg::dma3dad::write( reinterpret_cast<uint32>( dest ) );
+        reg::dma3sad::write( address_cast( data ) );
+        reg::dma3dad::write( address_cast( dest ) );
         reg::dma3cnt::write( {
             .transfers = uint16( size / 4 ),
             .control = { .type = dma_control::type::word, .enable = true }
@@ -9,6 +9,8 @@ namespace bios {
 template <unsigned Swi, class Function>
 struct swi;
 
+#if defined( __arm__ ) || defined( __thumb__ )
+
 template <unsigned Swi>
 struct swi<Swi, void( void )> {
     [[gnu::always_inline]]
@@ -337,6 +339,26 @@ struct swi<Swi, void( const void *, void *, const void * )> {
     }
 };
 
+#else
+
+/**
+ * Off-target there is no BIOS; calls trap, so host builds can include headers that use it
+ */
+template <unsigned Swi, class Return, class... Args>
+struct swi<Swi, Return( Args... )> {
+    [[noreturn]]
+    static Return call( Args... ) noexcept {
+        __builtin_trap();
+    }
+
+    [[noreturn]]
+    static Return call_2( Args... ) noexcept {
+        __builtin_trap();
+    }
+};
+
+#endif
+
 } // bios
 } // gba
 
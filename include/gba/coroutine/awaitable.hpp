@@ -0,0 +1,118 @@
+#ifndef GBAXX_COROUTINE_AWAITABLE_HPP
+#define GBAXX_COROUTINE_AWAITABLE_HPP
+#if defined( __cpp_impl_coroutine )
+
+#include <coroutine>
+
+#include <gba/types/cycles.hpp>
+#include <gba/types/int_cast.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/interrupt_mask.hpp>
+
+namespace gba {
+namespace coroutine {
+namespace detail {
+
+enum class wait_kind : uint8 {
+    frames,
+    interrupt,
+    cycles
+};
+
+/**
+ * Type-erased view of the executor that is currently resuming a coroutine
+ */
+struct executor_link {
+    void * self;
+    void ( * suspend )( void * self, std::coroutine_handle<> handle, wait_kind kind, uint32 value ) noexcept;
+    uint16 ( * raised )( void * self ) noexcept;
+};
+
+inline const executor_link * current_executor = nullptr;
+
+inline void suspend_current( const std::coroutine_handle<> handle, const wait_kind kind, const uint32 value ) noexcept {
+    current_executor->suspend( current_executor->self, handle, kind, value );
+}
+
+} // detail
+
+/**
+ * Resume after a number of frames; co_await next_frame {} yields until the next frame
+ */
+struct frames {
+    [[nodiscard]]
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend( const std::coroutine_handle<> handle ) const noexcept {
+        detail::suspend_current( handle, detail::wait_kind::frames, count );
+    }
+
+    void await_resume() const noexcept {}
+
+    uint32 count;
+};
+
+struct next_frame : frames {
+    constexpr next_frame() noexcept : frames { 1 } {}
+};
+
+/**
+ * Resume once any of the interrupts in mask are raised; co_await yields the interrupts that were raised
+ */
+class interrupt {
+public:
+    explicit constexpr interrupt( const interrupt_mask mask ) noexcept : m_mask { uint16( uint_cast( mask ) ) } {}
+
+    [[nodiscard]]
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend( const std::coroutine_handle<> handle ) const noexcept {
+        detail::suspend_current( handle, detail::wait_kind::interrupt, m_mask );
+    }
+
+    interrupt_mask await_resume() const noexcept {
+        return make_interrupt_mask( detail::current_executor->raised( detail::current_executor->self ) );
+    }
+
+protected:
+    uint16 m_mask;
+};
+
+/**
+ * Resume on the VBlank interrupt, before tasks of the following frame run
+ */
+struct vblank : interrupt {
+    constexpr vblank() noexcept : interrupt( make_interrupt_mask( 0x1 ) ) {}
+};
+
+/**
+ * Resume once at least a number of cycles have elapsed
+ */
+class timer {
+public:
+    explicit constexpr timer( const cycles_type duration ) noexcept : m_cycles { duration.count() } {}
+
+    [[nodiscard]]
+    bool await_ready() const noexcept {
+        return m_cycles == 0;
+    }
+
+    void await_suspend( const std::coroutine_handle<> handle ) const noexcept {
+        detail::suspend_current( handle, detail::wait_kind::cycles, m_cycles );
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    uint32 m_cycles;
+};
+
+} // coroutine
+} // gba
+
+#endif // __cpp_impl_coroutine
+#endif // define GBAXX_COROUTINE_AWAITABLE_HPP
@@ -0,0 +1,277 @@
+#ifndef GBAXX_COROUTINE_EXECUTOR_HPP
+#define GBAXX_COROUTINE_EXECUTOR_HPP
+#if defined( __cpp_impl_coroutine )
+
+#include <coroutine>
+
+#include <gba/coroutine/awaitable.hpp>
+#include <gba/coroutine/task.hpp>
+#include <gba/task/scheduler_core.hpp>
+#include <gba/types/cycles.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+namespace coroutine {
+
+/**
+ * Simulated machine for driving an executor off-hardware
+ *
+ * Time only moves when wait() skips ahead to the next VBlank or armed timer, or when a task calls advance().
+ */
+class host_platform {
+public:
+    static constexpr uint16 vblank_mask = 0x1;
+    static constexpr uint16 timer_mask = 0x40;
+
+    constexpr host_platform() noexcept : m_now {}, m_deadline {}, m_raised {}, m_armed {} {}
+
+    [[nodiscard]]
+    constexpr uint32 now() const noexcept {
+        return m_now;
+    }
+
+    /**
+     * Spend cycles, as if the calling task were doing work
+     */
+    constexpr void advance( const uint32 cycles ) noexcept {
+        m_now += cycles;
+    }
+
+    /**
+     * Flag interrupts; they are delivered by the next wait() that asks for them
+     */
+    constexpr void raise( const uint16 mask ) noexcept {
+        m_raised |= mask;
+    }
+
+    constexpr void arm( const uint32 cycles ) noexcept {
+        m_deadline = m_now + cycles;
+        m_armed = true;
+    }
+
+    constexpr uint16 wait( const uint16 mask ) noexcept {
+        constexpr auto period = cycles_per_frame.count();
+
+        while ( ( m_raised & mask ) == 0 ) {
+            const auto nextVblank = m_now - ( m_now % period ) + period;
+            if ( m_armed && int32( m_deadline - nextVblank ) < 0 ) {
+                if ( int32( m_deadline - m_now ) > 0 ) {
+                    m_now = m_deadline;
+                }
+                m_armed = false;
+                m_raised |= timer_mask;
+            } else {
+                m_now = nextVblank;
+                m_raised |= vblank_mask;
+            }
+        }
+
+        const auto raised = uint16( m_raised & mask );
+        m_raised &= ~mask;
+        return raised;
+    }
+
+private:
+    uint32 m_now;
+    uint32 m_deadline;
+    uint16 m_raised;
+    bool m_armed;
+};
+
+/**
+ * Cooperative executor for task<void> coroutines
+ *
+ * Shares its scheduling policy with the fiber scheduler: tasks are resumed once per frame in priority order until
+ * the cycle budget is used, then the executor idles in Platform::wait() until VBlank or an interrupt a task awaits.
+ * A suspended coroutine costs its frame plus an 8 byte slot; frames come from a frame_arena.
+ * @tparam Capacity maximum number of tasks
+ * @tparam Platform provides now(), arm( cycles ), wait( mask ) and timer_mask; see host_platform and gba_platform
+ */
+template <unsigned Capacity, class Platform>
+class executor : detail::executor_link {
+    using core_type = gba::task::scheduler_core<Capacity>;
+
+    static constexpr uint16 vblank_mask = 0x1;
+public:
+    static constexpr int none = core_type::none;
+
+    executor( const executor& ) = delete;
+    executor& operator =( const executor& ) = delete;
+
+    executor() noexcept : executor_link { this, suspend_thunk, raised_thunk }, m_roots {}, m_resume {}, m_deadlines {}, m_platform {}, m_core {}, m_budget { core_type::unlimited }, m_timers {}, m_running { none } {}
+
+    ~executor() noexcept {
+        for ( unsigned ii = 0; ii < Capacity; ++ii ) {
+            if ( m_roots[ii] ) {
+                m_roots[ii].destroy();
+            }
+        }
+    }
+
+    /**
+     * Take ownership of a task and schedule its first resume for this frame
+     * @param priority lower values are resumed first
+     * @return task id, or none if the task is empty or the pool is full
+     */
+    int spawn( task<void>&& work, const uint8 priority = 0 ) noexcept {
+        if ( !work ) {
+            return none;
+        }
+
+        const auto id = m_core.spawn( priority );
+        if ( id == none ) {
+            return none;
+        }
+
+        m_roots[id] = work.release();
+        m_resume[id] = m_roots[id];
+        return id;
+    }
+
+    void kill( const int id ) noexcept {
+        m_roots[id].destroy();
+        m_roots[id] = nullptr;
+        m_timers &= ~( 1u << id );
+        m_core.kill( id );
+    }
+
+    /**
+     * Cycles that may be spent resuming tasks each frame
+     */
+    void set_budget( const cycles_type budget ) noexcept {
+        m_budget = budget.count();
+    }
+
+    /**
+     * Run one frame's time slice, returning once VBlank has been raised
+     */
+    void run_frame() noexcept {
+        m_core.begin_frame( m_budget );
+        while ( true ) {
+            for ( auto id = m_core.next(); id != none; id = m_core.next() ) {
+                resume( id );
+            }
+
+            if ( expire_timers() ) {
+                continue;
+            }
+
+            const auto raised = m_platform.wait( m_core.wait_mask() | vblank_mask | ( m_timers ? Platform::timer_mask : 0 ) );
+            m_core.signal( raised );
+            expire_timers();
+            if ( raised & vblank_mask ) {
+                m_core.tick();
+                return;
+            }
+        }
+    }
+
+    /**
+     * Run frames until every task has finished
+     */
+    void run() noexcept {
+        while ( !m_core.empty() ) {
+            run_frame();
+        }
+    }
+
+    [[nodiscard]]
+    Platform& platform() noexcept {
+        return m_platform;
+    }
+
+    [[nodiscard]]
+    const core_type& core() const noexcept {
+        return m_core;
+    }
+
+private:
+    static void suspend_thunk( void * self, const std::coroutine_handle<> handle, const detail::wait_kind kind, const uint32 value ) noexcept {
+        auto& ex = *static_cast<executor *>( self );
+        const auto id = ex.m_running;
+
+        ex.m_resume[id] = handle;
+        switch ( kind ) {
+            case detail::wait_kind::frames:
+                ex.m_core.sleep( id, value );
+                break;
+            case detail::wait_kind::interrupt:
+                ex.m_core.wait( id, uint16( value ) );
+                break;
+            case detail::wait_kind::cycles:
+                // An empty interrupt mask is never signalled; expire_timers() wakes the task
+                ex.m_deadlines[id] = ex.m_platform.now() + value;
+                ex.m_timers |= ( 1u << id );
+                ex.m_core.wait( id, 0 );
+                break;
+        }
+    }
+
+    static uint16 raised_thunk( void * self ) noexcept {
+        const auto& ex = *static_cast<const executor *>( self );
+        return ex.m_core.raised_mask( ex.m_running );
+    }
+
+    /**
+     * Wake tasks whose timer deadline has passed and arm the platform timer for the earliest remaining one
+     * @return true if any task was woken
+     */
+    bool expire_timers() noexcept {
+        if ( !m_timers ) {
+            return false;
+        }
+
+        const auto now = m_platform.now();
+        auto earliest = core_type::unlimited;
+        bool woken = false;
+        for ( unsigned ii = 0; ii < Capacity; ++ii ) {
+            if ( ( m_timers & ( 1u << ii ) ) == 0 ) {
+                continue;
+            }
+
+            const auto remaining = int32( m_deadlines[ii] - now );
+            if ( remaining <= 0 ) {
+                m_timers &= ~( 1u << ii );
+                m_core.wake( int( ii ) );
+                woken = true;
+            } else if ( uint32( remaining ) < earliest ) {
+                earliest = uint32( remaining );
+            }
+        }
+
+        if ( m_timers ) {
+            m_platform.arm( earliest );
+        }
+        return woken;
+    }
+
+    void resume( const int id ) noexcept {
+        const auto * previous = detail::current_executor;
+        detail::current_executor = this;
+        m_running = id;
+
+        const auto start = m_platform.now();
+        m_resume[id].resume();
+        m_core.charge( id, m_platform.now() - start );
+
+        detail::current_executor = previous;
+        if ( m_roots[id].done() ) {
+            kill( id );
+        }
+    }
+
+    std::coroutine_handle<> m_roots[Capacity];
+    std::coroutine_handle<> m_resume[Capacity];
+    uint32 m_deadlines[Capacity];
+    Platform m_platform;
+    core_type m_core;
+    uint32 m_budget;
+    uint32 m_timers;
+    int m_running;
+};
+
+} // coroutine
+} // gba
+
+#endif // __cpp_impl_coroutine
+#endif // define GBAXX_COROUTINE_EXECUTOR_HPP
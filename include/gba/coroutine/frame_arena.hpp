@@ -0,0 +1,92 @@
+#ifndef GBAXX_COROUTINE_FRAME_ARENA_HPP
+#define GBAXX_COROUTINE_FRAME_ARENA_HPP
+
+#include <cstddef>
+
+#include <gba/allocator/bitset_types.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+namespace coroutine {
+namespace detail {
+
+class frame_arena_base : protected allocator::simple_bitset {
+public:
+    frame_arena_base( const frame_arena_base& ) = delete;
+    frame_arena_base& operator =( const frame_arena_base& ) = delete;
+
+    /**
+     * @return storage for size bytes spanning consecutive blocks, or nullptr if no run is free
+     */
+    [[nodiscard]]
+    void * allocate( const std::size_t size ) noexcept {
+        const auto bits = int( ( size + m_blockSize - 1 ) / m_blockSize );
+        if ( bits == 0 || bits > int( m_blocks ) ) {
+            return nullptr;
+        }
+
+        // A frame over all 32 blocks needs the whole bitset, which bitset_find_free cannot shift a mask through
+        uint32 shift = 0;
+        const auto mask = bits == 32 ? ( m_bitset ? 0u : ~0u ) : bitset_find_free( bits, shift );
+        if ( !mask ) {
+            return nullptr;
+        }
+
+        m_bitset |= mask;
+        return m_data + shift * m_blockSize;
+    }
+
+    void deallocate( void * ptr, const std::size_t size ) noexcept {
+        const auto bits = uint32( ( size + m_blockSize - 1 ) / m_blockSize );
+        const auto shift = uint32( static_cast<uint8 *>( ptr ) - m_data ) / m_blockSize;
+        m_bitset &= bits == 32 ? 0u : ~( ( ( 1u << bits ) - 1u ) << shift );
+    }
+
+    [[nodiscard]]
+    bool owns( const void * ptr ) const noexcept {
+        const auto * p = static_cast<const uint8 *>( ptr );
+        return p >= m_data && p < m_data + m_blocks * m_blockSize;
+    }
+
+    [[nodiscard]]
+    uint32 blocks_used() const noexcept {
+        return uint32( __builtin_popcount( m_bitset & m_blockMask ) );
+    }
+
+protected:
+    frame_arena_base( uint8 * data, const uint32 blocks, const uint32 blockSize ) noexcept : simple_bitset(), m_data { data }, m_blockMask { blocks == 32 ? ~0u : ( 1u << blocks ) - 1u }, m_blocks { uint16( blocks ) }, m_blockSize { uint16( blockSize ) } {
+        // Blocks past the end of the arena are never free
+        m_bitset = ~m_blockMask;
+    }
+
+private:
+    uint8 * m_data;
+    uint32 m_blockMask;
+    uint16 m_blocks;
+    uint16 m_blockSize;
+};
+
+} // detail
+
+/**
+ * Fixed pool of coroutine frames, so spawning a coroutine never touches the heap
+ *
+ * A frame occupies consecutive blocks; size BlockSize to the typical frame so most take one.
+ * @tparam Blocks number of blocks (1 to 32)
+ * @tparam BlockSize bytes per block (multiple of 8)
+ */
+template <unsigned Blocks, unsigned BlockSize = 64>
+class frame_arena : public detail::frame_arena_base {
+    static_assert( Blocks > 0 && Blocks <= 32, "frame_arena Blocks must be between 1 and 32" );
+    static_assert( BlockSize > 0 && BlockSize % 8 == 0, "frame_arena BlockSize must be a multiple of 8" );
+public:
+    frame_arena() noexcept : frame_arena_base( m_storage, Blocks, BlockSize ) {}
+
+private:
+    alignas( 8 ) uint8 m_storage[Blocks * BlockSize];
+};
+
+} // coroutine
+} // gba
+
+#endif // define GBAXX_COROUTINE_FRAME_ARENA_HPP
@@ -0,0 +1,82 @@
+#ifndef GBAXX_COROUTINE_GBA_PLATFORM_HPP
+#define GBAXX_COROUTINE_GBA_PLATFORM_HPP
+
+#include <gba/registers/display.hpp>
+#include <gba/task/interrupt_wait.hpp>
+#include <gba/time/timer_control.hpp>
+#include <gba/types/cycles.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/memmap.hpp>
+
+namespace gba {
+namespace coroutine {
+
+/**
+ * Hardware platform for executor
+ *
+ * Time is counted in frames plus scanlines since the last VBlank, so it only advances correctly while the executor
+ * is idling in wait(). The VBlank and Timer interrupts must be enabled with a handler that acknowledges REG_IFBIOS.
+ * @tparam Timer hardware timer used for coroutine::timer wake-ups
+ */
+template <unsigned Timer = 3>
+class gba_platform {
+    static_assert( Timer < 4, "gba_platform Timer must be between 0 and 3" );
+
+    using tmcnt = iomemmap<timer_counter_control, 0x4000100 + Timer * 4>;
+public:
+    static constexpr uint16 timer_mask = uint16( 0x8u << Timer );
+
+    gba_platform() noexcept : m_frames {} {}
+
+    [[nodiscard]]
+    uint32 now() const noexcept {
+        // VBlank starts on line 160
+        const auto lines = ( reg::vcount::read() + 228u - 160u ) % 228u;
+        return m_frames * cycles_per_frame.count() + lines * cycles_per_scanline.count();
+    }
+
+    /**
+     * Raise the timer interrupt once after at least cycles have elapsed (up to 2^26 cycles)
+     */
+    void arm( const uint32 cycles ) noexcept {
+        auto prescaler = timer_control::cycles::_1;
+        auto ticks = cycles;
+        if ( ticks > 0x10000 ) {
+            prescaler = timer_control::cycles::_64;
+            ticks = ( cycles + 63 ) >> 6;
+        }
+        if ( ticks > 0x10000 ) {
+            prescaler = timer_control::cycles::_256;
+            ticks = ( cycles + 255 ) >> 8;
+        }
+        if ( ticks > 0x10000 ) {
+            prescaler = timer_control::cycles::_1024;
+            ticks = ( cycles + 1023 ) >> 10;
+        }
+        if ( ticks > 0x10000 ) {
+            ticks = 0x10000;
+        }
+
+        tmcnt::write( {} );
+        tmcnt::write( timer_counter_control { uint16( 0x10000 - ticks ), timer_control { .cycles = prescaler, .timer_irq = true, .enable = true } } );
+    }
+
+    uint16 wait( const uint16 mask ) noexcept {
+        const auto raised = gba::task::intr_wait( mask );
+        if ( raised & 0x1 ) {
+            ++m_frames;
+        }
+        if ( raised & timer_mask ) {
+            tmcnt::write( {} );
+        }
+        return raised;
+    }
+
+private:
+    uint32 m_frames;
+};
+
+} // coroutine
+} // gba
+
+#endif // define GBAXX_COROUTINE_GBA_PLATFORM_HPP
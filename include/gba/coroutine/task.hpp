@@ -0,0 +1,227 @@
+#ifndef GBAXX_COROUTINE_TASK_HPP
+#define GBAXX_COROUTINE_TASK_HPP
+#if defined( __cpp_impl_coroutine )
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <gba/coroutine/frame_arena.hpp>
+
+namespace gba {
+namespace coroutine {
+namespace detail {
+
+inline frame_arena_base * default_arena = nullptr;
+
+// Frames are prefixed with the arena they came from, keeping 8 byte alignment
+constexpr std::size_t frame_header = 8;
+
+inline void * allocate_frame( frame_arena_base * arena, const std::size_t size ) noexcept {
+    auto * p = static_cast<uint8 *>( arena->allocate( size + frame_header ) );
+    if ( !p ) {
+        return nullptr;
+    }
+    *reinterpret_cast<frame_arena_base **>( p ) = arena;
+    return p + frame_header;
+}
+
+inline void deallocate_frame( void * ptr, const std::size_t size ) noexcept {
+    auto * p = static_cast<uint8 *>( ptr ) - frame_header;
+    auto * arena = *reinterpret_cast<frame_arena_base **>( p );
+    arena->deallocate( p, size + frame_header );
+}
+
+class promise_base {
+public:
+    struct final_awaiter {
+        [[nodiscard]]
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <class Promise>
+        std::coroutine_handle<> await_suspend( std::coroutine_handle<Promise> handle ) const noexcept {
+            const auto continuation = handle.promise().m_continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * Allocate from the default arena; terminates if set_frame_arena() was never called, as frames never come from the heap
+     */
+    static void * operator new( const std::size_t size ) noexcept {
+        if ( !default_arena ) {
+            std::terminate();
+        }
+        return allocate_frame( default_arena, size );
+    }
+
+    static void operator delete( void * ptr, const std::size_t size ) noexcept {
+        deallocate_frame( ptr, size );
+    }
+
+    std::suspend_always initial_suspend() const noexcept {
+        return {};
+    }
+
+    final_awaiter final_suspend() const noexcept {
+        return {};
+    }
+
+    void unhandled_exception() const noexcept {
+        std::terminate();
+    }
+
+    std::coroutine_handle<> m_continuation;
+};
+
+template <typename Type>
+class promise_value {
+public:
+    template <class Value>
+    void return_value( Value&& value ) noexcept {
+        m_value.emplace( std::forward<Value>( value ) );
+    }
+
+    Type result() noexcept {
+        return std::move( *m_value );
+    }
+
+private:
+    std::optional<Type> m_value;
+};
+
+template <>
+class promise_value<void> {
+public:
+    void return_void() const noexcept {}
+
+    void result() const noexcept {}
+};
+
+/**
+ * Promise of a coroutine whose first argument is the arena its frame comes from
+ *
+ * operator new takes exactly the coroutine's parameter types, so it need not be a template, and is paired with an
+ * operator delete of the same class.
+ */
+template <class Promise, class... Args>
+class arena_promise : public Promise {
+public:
+    static void * operator new( const std::size_t size, frame_arena_base& arena, std::add_lvalue_reference_t<Args>... ) noexcept {
+        return allocate_frame( &arena, size );
+    }
+
+    static void operator delete( void * ptr, const std::size_t size ) noexcept {
+        deallocate_frame( ptr, size );
+    }
+};
+
+} // detail
+
+/**
+ * Arena used by coroutines that are not given one as their first argument; must be set before the first such
+ * coroutine is called
+ */
+inline void set_frame_arena( detail::frame_arena_base& arena ) noexcept {
+    detail::default_arena = &arena;
+}
+
+/**
+ * Lazily started coroutine; runs when awaited or spawned on an executor
+ *
+ * A task whose frame could not be allocated is empty (operator bool returns false) and must not be awaited.
+ * @tparam Type value produced with co_return
+ */
+template <typename Type = void>
+class task {
+public:
+    class promise_type : public detail::promise_base, public detail::promise_value<Type> {
+    public:
+        task get_return_object() noexcept {
+            return task( handle_type::from_promise( *this ) );
+        }
+
+        static task get_return_object_on_allocation_failure() noexcept {
+            return task( nullptr );
+        }
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    task( const task& ) = delete;
+    task& operator =( const task& ) = delete;
+
+    task( task&& other ) noexcept : m_handle { std::exchange( other.m_handle, nullptr ) } {}
+
+    task& operator =( task&& other ) noexcept {
+        if ( m_handle ) {
+            m_handle.destroy();
+        }
+        m_handle = std::exchange( other.m_handle, nullptr );
+        return *this;
+    }
+
+    ~task() noexcept {
+        if ( m_handle ) {
+            m_handle.destroy();
+        }
+    }
+
+    [[nodiscard]]
+    explicit operator bool() const noexcept {
+        return static_cast<bool>( m_handle );
+    }
+
+    [[nodiscard]]
+    bool done() const noexcept {
+        return m_handle.done();
+    }
+
+    /**
+     * Give up ownership of the coroutine frame
+     */
+    [[nodiscard]]
+    handle_type release() noexcept {
+        return std::exchange( m_handle, nullptr );
+    }
+
+    [[nodiscard]]
+    bool await_ready() const noexcept {
+        return m_handle.done();
+    }
+
+    std::coroutine_handle<> await_suspend( const std::coroutine_handle<> awaiting ) noexcept {
+        m_handle.promise().m_continuation = awaiting;
+        return m_handle;
+    }
+
+    Type await_resume() noexcept {
+        return m_handle.promise().result();
+    }
+
+private:
+    explicit task( const handle_type handle ) noexcept : m_handle { handle } {}
+
+    handle_type m_handle;
+};
+
+} // coroutine
+} // gba
+
+/**
+ * Coroutines returning a task and taking an arena first allocate their frame from it
+ */
+template <typename Type, class Arena, class... Args> requires std::is_base_of_v<gba::coroutine::detail::frame_arena_base, Arena>
+struct std::coroutine_traits<gba::coroutine::task<Type>, Arena&, Args...> {
+    using promise_type = gba::coroutine::detail::arena_promise<typename gba::coroutine::task<Type>::promise_type, Args...>;
+};
+
+#endif // __cpp_impl_coroutine
+#endif // define GBAXX_COROUTINE_TASK_HPP
@@ -0,0 +1,407 @@
+#ifndef GBAXX_DISPLAY_BITMAP_HPP
+#define GBAXX_DISPLAY_BITMAP_HPP
+
+#include <gba/ext/agbabi/memcpy.hpp>
+#include <gba/system/iwram.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+
+/**
+ * Fill words with value; agbabi::wordset4 when available
+ */
+[[GBAXX_IWRAM_ARM]]
+inline void bitmap_fill_words( uint32 * dest, const uint32 words, const uint32 value ) noexcept {
+#if defined( __agb_abi )
+    agbabi::wordset4( dest, words * 4, int( value ) );
+#else
+    for ( uint32 ii = 0; ii < words; ++ii ) {
+        dest[ii] = value;
+    }
+#endif
+}
+
+/**
+ * Drawing on a bitmap background layer, or on a buffer of the same layout
+ *
+ * VRAM ignores byte writes, so 8-bit pixels are written in pairs and lone pixels with a halfword read-modify-write.
+ * Spans fill whole words in between. Everything is clipped to the bitmap.
+ * @tparam Width pixels per row
+ * @tparam Height rows
+ * @tparam Bits 16 for direct color (modes 3 and 5), 8 for palette indices (mode 4)
+ */
+template <unsigned Width, unsigned Height, unsigned Bits>
+class bitmap {
+    static_assert( Bits == 8 || Bits == 16, "bitmap Bits must be 8 or 16" );
+    static_assert( ( Width * Bits / 8 ) % 4 == 0, "bitmap rows must be word aligned" );
+public:
+    using pixel = typename uint_type<Bits>::type;
+
+    static constexpr int32 width = Width;
+    static constexpr int32 height = Height;
+    static constexpr uint32 pitch = Width * Bits / 8;
+
+    /**
+     * @param pixels word aligned start of the bitmap
+     */
+    explicit constexpr bitmap( void * pixels ) noexcept : m_pixels { static_cast<uint16 *>( pixels ) } {}
+
+    [[nodiscard]]
+    constexpr void * data() const noexcept {
+        return m_pixels;
+    }
+
+    [[nodiscard]]
+    pixel get( const int32 x, const int32 y ) const noexcept {
+        if ( !inside( x, y ) ) {
+            return 0;
+        }
+        if constexpr ( Bits == 16 ) {
+            return m_pixels[y * Width + x];
+        } else {
+            const auto pair = m_pixels[( y * Width + x ) / 2];
+            return pixel( x & 1 ? pair >> 8 : pair );
+        }
+    }
+
+    void plot( const int32 x, const int32 y, const pixel color ) noexcept {
+        if ( inside( x, y ) ) {
+            put( x, y, color );
+        }
+    }
+
+    void clear( const pixel color ) noexcept {
+        bitmap_fill_words( reinterpret_cast<uint32 *>( m_pixels ), pitch * Height / 4, pattern( color ) );
+    }
+
+    /**
+     * Horizontal span from x0 to x1 inclusive
+     */
+    void hline( int32 x0, int32 x1, const int32 y, const pixel color ) noexcept {
+        if ( x0 > x1 ) {
+            const auto t = x0;
+            x0 = x1;
+            x1 = t;
+        }
+        if ( y < 0 || y >= height || x1 < 0 || x0 >= width ) {
+            return;
+        }
+        span( x0 < 0 ? 0 : x0, x1 >= width ? width - 1 : x1, y, color );
+    }
+
+    /**
+     * Vertical span from y0 to y1 inclusive
+     */
+    void vline( const int32 x, int32 y0, int32 y1, const pixel color ) noexcept {
+        if ( y0 > y1 ) {
+            const auto t = y0;
+            y0 = y1;
+            y1 = t;
+        }
+        if ( x < 0 || x >= width || y1 < 0 || y0 >= height ) {
+            return;
+        }
+        y0 = y0 < 0 ? 0 : y0;
+        y1 = y1 >= height ? height - 1 : y1;
+        for ( auto y = y0; y <= y1; ++y ) {
+            put( x, y, color );
+        }
+    }
+
+    void fill_rect( int32 x, int32 y, int32 w, int32 h, const pixel color ) noexcept {
+        if ( !clip( x, y, w, h ) ) {
+            return;
+        }
+        for ( int32 row = 0; row < h; ++row ) {
+            span( x, x + w - 1, y + row, color );
+        }
+    }
+
+    void rect( const int32 x, const int32 y, const int32 w, const int32 h, const pixel color ) noexcept {
+        if ( w <= 0 || h <= 0 ) {
+            return;
+        }
+        hline( x, x + w - 1, y, color );
+        hline( x, x + w - 1, y + h - 1, color );
+        vline( x, y + 1, y + h - 2, color );
+        vline( x + w - 1, y + 1, y + h - 2, color );
+    }
+
+    /**
+     * Bresenham line, endpoints inclusive
+     *
+     * The segment is clipped once, as a range of steps along its major axis, and the pixels in range are written
+     * without further checks; a clipped line lights the same pixels the unclipped line would.
+     */
+    void line( const int32 x0, const int32 y0, const int32 x1, const int32 y1, const pixel color ) noexcept {
+        if ( ( x0 < 0 && x1 < 0 ) || ( x0 >= width && x1 >= width ) || ( y0 < 0 && y1 < 0 ) || ( y0 >= height && y1 >= height ) ) {
+            return;
+        }
+        if ( y0 == y1 ) {
+            hline( x0, x1, y0, color );
+            return;
+        }
+        if ( x0 == x1 ) {
+            vline( x0, y0, y1, color );
+            return;
+        }
+
+        const auto dx = x1 > x0 ? x1 - x0 : x0 - x1;
+        const auto dy = y1 > y0 ? y1 - y0 : y0 - y1;
+        const auto sx = x0 < x1 ? 1 : -1;
+        const auto sy = y0 < y1 ? 1 : -1;
+        if ( dx >= dy ) {
+            line_steps<true>( x0, y0, sx, sy, dx, dy, color );
+        } else {
+            line_steps<false>( y0, x0, sy, sx, dy, dx, color );
+        }
+    }
+
+    /**
+     * Midpoint circle outline
+     */
+    void circle( const int32 cx, const int32 cy, const int32 radius, const pixel color ) noexcept {
+        int32 x = radius;
+        int32 y = 0;
+        int32 error = 1 - radius;
+        while ( x >= y ) {
+            plot( cx + x, cy + y, color );
+            plot( cx - x, cy + y, color );
+            plot( cx + x, cy - y, color );
+            plot( cx - x, cy - y, color );
+            plot( cx + y, cy + x, color );
+            plot( cx - y, cy + x, color );
+            plot( cx + y, cy - x, color );
+            plot( cx - y, cy - x, color );
+            step( x, y, error );
+        }
+    }
+
+    /**
+     * Filled circle drawn as one span per row
+     */
+    void fill_circle( const int32 cx, const int32 cy, const int32 radius, const pixel color ) noexcept {
+        int32 x = radius;
+        int32 y = 0;
+        int32 error = 1 - radius;
+        while ( x >= y ) {
+            hline( cx - x, cx + x, cy + y, color );
+            if ( y ) {
+                hline( cx - x, cx + x, cy - y, color );
+            }
+
+            const auto previous = x;
+            step( x, y, error );
+            // The rows at +-x are only final once x is about to change
+            if ( x != previous && previous >= y ) {
+                hline( cx - y + 1, cx + y - 1, cy + previous, color );
+                hline( cx - y + 1, cx + y - 1, cy - previous, color );
+            }
+        }
+    }
+
+    /**
+     * Copy a w by h block of pixels, clipped to the bitmap
+     * @param srcPitch pixels between rows of src
+     */
+    void blit( int32 x, int32 y, const pixel * src, int32 w, int32 h, const int32 srcPitch ) noexcept {
+        const auto x0 = x;
+        const auto y0 = y;
+        if ( !clip( x, y, w, h ) ) {
+            return;
+        }
+        src += ( y - y0 ) * srcPitch + ( x - x0 );
+
+        for ( int32 row = 0; row < h; ++row, src += srcPitch ) {
+            if constexpr ( Bits == 16 ) {
+                auto * dest = m_pixels + ( y + row ) * Width + x;
+                for ( int32 ii = 0; ii < w; ++ii ) {
+                    dest[ii] = src[ii];
+                }
+            } else {
+                blit_row( x, y + row, src, w );
+            }
+        }
+    }
+
+private:
+    [[nodiscard]]
+    static constexpr bool inside( const int32 x, const int32 y ) noexcept {
+        return uint32( x ) < Width && uint32( y ) < Height;
+    }
+
+    [[nodiscard]]
+    static constexpr uint32 pattern( const pixel color ) noexcept {
+        if constexpr ( Bits == 16 ) {
+            return color | uint32( color ) << 16;
+        } else {
+            return color * 0x01010101u;
+        }
+    }
+
+    static constexpr bool clip( int32& x, int32& y, int32& w, int32& h ) noexcept {
+        if ( x < 0 ) {
+            w += x;
+            x = 0;
+        }
+        if ( y < 0 ) {
+            h += y;
+            y = 0;
+        }
+        w = x + w > width ? width - x : w;
+        h = y + h > height ? height - y : h;
+        return w > 0 && h > 0;
+    }
+
+    static constexpr void step( int32& x, int32& y, int32& error ) noexcept {
+        ++y;
+        if ( error < 0 ) {
+            error += 2 * y + 1;
+        } else {
+            --x;
+            error += 2 * ( y - x ) + 1;
+        }
+    }
+
+    /**
+     * Steps of a line along its major axis a, with the minor axis b advancing by rounding: step i is at minor offset
+     * ( 2 * i * minor + major ) / ( 2 * major ). The minor offset never decreases, so each axis bounds a range of steps.
+     */
+    template <bool XMajor>
+    void line_steps( int32 a, int32 b, const int32 sa, const int32 sb, const int32 major, const int32 minor, const pixel color ) noexcept {
+        using wide = typename int_type<64>::type;
+        constexpr int32 limitA = XMajor ? width : height;
+        constexpr int32 limitB = XMajor ? height : width;
+
+        // Steps with the major coordinate inside the bitmap
+        int32 first = sa > 0 ? -a : a - ( limitA - 1 );
+        int32 last = sa > 0 ? limitA - 1 - a : a;
+        first = first < 0 ? 0 : first;
+        last = last > major ? major : last;
+
+        // Steps with the minor offset between low and high
+        const auto low = sb > 0 ? -b : b - ( limitB - 1 );
+        const auto high = sb > 0 ? limitB - 1 - b : b;
+        if ( high < 0 ) {
+            return;
+        }
+        if ( low > 0 ) {
+            const auto entry = int32( ( wide( 2 ) * major * low - major + 2 * minor - 1 ) / ( 2 * wide( minor ) ) );
+            first = entry > first ? entry : first;
+        }
+        const auto exit = ( wide( 2 ) * major * ( high + 1 ) - major + 2 * minor - 1 ) / ( 2 * wide( minor ) ) - 1;
+        last = exit < last ? int32( exit ) : last;
+        if ( first > last ) {
+            return;
+        }
+
+        // Jump to the first visible step
+        const auto start = wide( 2 ) * first * minor + major;
+        auto error = int32( start % ( 2 * wide( major ) ) );
+        a += sa * first;
+        b += sb * int32( start / ( 2 * wide( major ) ) );
+        for ( auto step = first; step <= last; ++step ) {
+            if constexpr ( XMajor ) {
+                put( a, b, color );
+            } else {
+                put( b, a, color );
+            }
+            a += sa;
+            error += 2 * minor;
+            if ( error >= 2 * major ) {
+                error -= 2 * major;
+                b += sb;
+            }
+        }
+    }
+
+    void put( const int32 x, const int32 y, const pixel color ) noexcept {
+        if constexpr ( Bits == 16 ) {
+            m_pixels[y * Width + x] = color;
+        } else {
+            auto& pair = m_pixels[( y * Width + x ) / 2];
+            pair = x & 1 ? uint16( ( pair & 0x00ff ) | color << 8 ) : uint16( ( pair & 0xff00 ) | color );
+        }
+    }
+
+    // x0 <= x1, both inside the row
+    void span( int32 x0, const int32 x1, const int32 y, const pixel color ) noexcept {
+        const auto fill = pattern( color );
+        if constexpr ( Bits == 16 ) {
+            auto * row = m_pixels + y * Width;
+            if ( x0 & 1 ) {
+                row[x0++] = color;
+            }
+            const auto words = uint32( x1 - x0 + 1 ) / 2;
+            bitmap_fill_words( reinterpret_cast<uint32 *>( row + x0 ), words, fill );
+            x0 += int32( words * 2 );
+            if ( x0 <= x1 ) {
+                row[x0] = color;
+            }
+        } else {
+            if ( x0 & 1 ) {
+                put( x0++, y, color );
+            }
+            auto * row = m_pixels + y * Width / 2;
+            auto count = x1 - x0 + 1;
+            auto half = x0 / 2;
+            if ( ( half & 1 ) && count >= 2 ) {
+                row[half++] = uint16( fill );
+                count -= 2;
+            }
+            const auto words = uint32( count ) / 4;
+            bitmap_fill_words( reinterpret_cast<uint32 *>( row + half ), words, fill );
+            half += int32( words * 2 );
+            count -= int32( words * 4 );
+            if ( count >= 2 ) {
+                row[half++] = uint16( fill );
+                count -= 2;
+            }
+            if ( count ) {
+                put( half * 2, y, color );
+            }
+        }
+    }
+
+    void blit_row( int32 x, const int32 y, const pixel * src, int32 w ) noexcept {
+        if ( x & 1 ) {
+            put( x++, y, *src++ );
+            --w;
+        }
+        auto * dest = m_pixels + ( y * Width + x ) / 2;
+        for ( ; w >= 2; w -= 2, src += 2 ) {
+            *dest++ = uint16( src[0] | src[1] << 8 );
+        }
+        if ( w ) {
+            *dest = uint16( ( *dest & 0xff00 ) | *src );
+        }
+    }
+
+    uint16 * m_pixels;
+};
+
+using bitmap_mode3 = bitmap<240, 160, 16>;
+using bitmap_mode4 = bitmap<240, 160, 8>;
+using bitmap_mode5 = bitmap<160, 128, 16>;
+
+/**
+ * The mode 3 frame buffer
+ */
+inline bitmap_mode3 mode3_vram() noexcept {
+    return bitmap_mode3( reinterpret_cast<void *>( 0x6000000 ) );
+}
+
+/**
+ * A mode 4 page; the display shows the one selected by display_control::page
+ */
+inline bitmap_mode4 mode4_vram( const uint32 page ) noexcept {
+    return bitmap_mode4( reinterpret_cast<void *>( 0x6000000 + page * 0xa000 ) );
+}
+
+inline bitmap_mode5 mode5_vram( const uint32 page ) noexcept {
+    return bitmap_mode5( reinterpret_cast<void *>( 0x6000000 + page * 0xa000 ) );
+}
+
+} // gba
+
+#endif // define GBAXX_DISPLAY_BITMAP_HPP
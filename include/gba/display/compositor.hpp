@@ -0,0 +1,310 @@
+#ifndef GBAXX_DISPLAY_COMPOSITOR_HPP
+#define GBAXX_DISPLAY_COMPOSITOR_HPP
+
+#include <cstring>
+
+#include <gba/display/color_blend.hpp>
+#include <gba/display/mosaic.hpp>
+#include <gba/display/window.hpp>
+#include <gba/registers/display.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+
+/**
+ * Layout of the window, mosaic and blend registers, 4000040h to 4000055h
+ */
+struct compositor_registers {
+    window_dimension win0h;
+    window_dimension win1h;
+    window_dimension win0v;
+    window_dimension win1v;
+    window_control winin;
+    window_control winout; ///< win0 fields are outside both windows, win1 fields are inside the object window
+    mosaic_size mosaic;
+    blend_control bldcnt;
+    blend_alpha bldalpha;
+    uint16 bldy;
+};
+
+static_assert( sizeof( compositor_registers ) == 22, "compositor_registers must match the register block" );
+
+enum class tween_curve : uint8 {
+    linear,
+    ease_in_out
+};
+
+/**
+ * Integer value moving towards a target over a number of frames
+ */
+class tween {
+public:
+    constexpr tween() noexcept : m_from {}, m_to {}, m_frame {}, m_frames {}, m_curve {} {}
+
+    constexpr void start( const int32 from, const int32 to, const uint32 frames, const tween_curve curve = tween_curve::linear ) noexcept {
+        m_from = from;
+        m_to = to;
+        m_frame = 0;
+        m_frames = frames;
+        m_curve = curve;
+    }
+
+    /**
+     * Advance one frame
+     * @return the new value
+     */
+    constexpr int32 step() noexcept {
+        if ( m_frame < m_frames ) {
+            ++m_frame;
+        }
+        return value();
+    }
+
+    [[nodiscard]]
+    constexpr int32 value() const noexcept {
+        if ( m_frame >= m_frames ) {
+            return m_to;
+        }
+
+        // Progress as 0.12 fixed point, so the smoothstep 3t^2 - 2t^3 stays within 32 bits
+        auto t = int32( ( m_frame << 12 ) / m_frames );
+        if ( m_curve == tween_curve::ease_in_out ) {
+            const auto t2 = ( t * t ) >> 12;
+            t = 3 * t2 - 2 * ( ( t2 * t ) >> 12 );
+        }
+        return m_from + ( ( m_to - m_from ) * t >> 12 );
+    }
+
+    [[nodiscard]]
+    constexpr bool active() const noexcept {
+        return m_frame < m_frames;
+    }
+
+private:
+    int32 m_from;
+    int32 m_to;
+    uint32 m_frame;
+    uint32 m_frames;
+    tween_curve m_curve;
+};
+
+/**
+ * Windows, mosaic and color effects kept in a shadow block and committed together in VBlank
+ *
+ * Setters and tweens only touch the shadow. commit() compares it with what was last written and copies the changed
+ * range of halfwords in one pass, so effects never change part way down the frame and idle frames write nothing.
+ * Where a display_shadow manages the display registers, commit( shadow ) hands the block to it instead.
+ */
+class compositor {
+public:
+    enum layer : uint8 {
+        bg0 = 0x01,
+        bg1 = 0x02,
+        bg2 = 0x04,
+        bg3 = 0x08,
+        obj = 0x10,
+        effects = 0x20,
+        all = 0x3f
+    };
+
+    static constexpr uint32 halfwords = sizeof( compositor_registers ) / 2;
+
+    compositor() noexcept : compositor( reinterpret_cast<volatile uint16 *>( 0x4000040 ) ) {}
+
+    /**
+     * @param io destination of commit(); the register block, or a buffer off-hardware
+     */
+    explicit compositor( volatile uint16 * io ) noexcept : m_io { io }, m_shadow {}, m_committed {}, m_eva {}, m_evb {}, m_evy {}, m_valid {} {}
+
+    /**
+     * Place a window; an empty size hides it
+     * @param index 0 or 1
+     */
+    void set_window( const uint32 index, const uint32 x, const uint32 y, const uint32 width, const uint32 height ) noexcept {
+        auto& h = index ? m_shadow.win1h : m_shadow.win0h;
+        auto& v = index ? m_shadow.win1v : m_shadow.win0v;
+        h = make_window_dimension( x, width );
+        v = make_window_dimension( y, height );
+    }
+
+    /**
+     * Layers visible inside window 0 or 1
+     */
+    void set_window_layers( const uint32 index, const uint8 layers ) noexcept {
+        set_half( index ? 1 : 0, m_shadow.winin, layers );
+    }
+
+    void set_outside_layers( const uint8 layers ) noexcept {
+        set_half( 0, m_shadow.winout, layers );
+    }
+
+    void set_object_window_layers( const uint8 layers ) noexcept {
+        set_half( 1, m_shadow.winout, layers );
+    }
+
+    void set_mosaic( const mosaic_size& size ) noexcept {
+        m_shadow.mosaic = size;
+    }
+
+    /**
+     * Which layers blend, and how; alpha and fade values are set separately
+     */
+    void set_blend( const blend_control& control ) noexcept {
+        m_shadow.bldcnt = control;
+    }
+
+    /**
+     * Alpha blend weights in sixteenths (0 to 16)
+     */
+    void set_alpha( const uint32 eva, const uint32 evb ) noexcept {
+        m_eva.start( int32( eva ), int32( eva ), 0 );
+        m_evb.start( int32( evb ), int32( evb ), 0 );
+        apply();
+    }
+
+    /**
+     * Brightness change in sixteenths (0 to 16) for the white and black modes
+     */
+    void set_fade( const uint32 evy ) noexcept {
+        m_evy.start( int32( evy ), int32( evy ), 0 );
+        apply();
+    }
+
+    void tween_alpha( const uint32 eva, const uint32 evb, const uint32 frames, const tween_curve curve = tween_curve::linear ) noexcept {
+        m_eva.start( m_eva.value(), int32( eva ), frames, curve );
+        m_evb.start( m_evb.value(), int32( evb ), frames, curve );
+    }
+
+    void tween_fade( const uint32 evy, const uint32 frames, const tween_curve curve = tween_curve::linear ) noexcept {
+        m_evy.start( m_evy.value(), int32( evy ), frames, curve );
+    }
+
+    /**
+     * Fade every layer and the backdrop to black (or white), or back with evy 0
+     */
+    void fade( const uint32 evy, const uint32 frames, const bool white = false ) noexcept {
+        auto control = blend_control {};
+        control.src_bg0 = control.src_bg1 = control.src_bg2 = control.src_bg3 = true;
+        control.src_obj = control.src_backdrop = true;
+        control.mode = white ? blend_mode::white : blend_mode::black;
+        set_blend( control );
+        tween_fade( evy, frames );
+    }
+
+    /**
+     * Show everything inside a rectangle and only the listed layers outside it, using window 0
+     */
+    void spotlight( const uint32 x, const uint32 y, const uint32 width, const uint32 height, const uint8 outside = 0 ) noexcept {
+        set_window( 0, x, y, width, height );
+        set_window_layers( 0, all );
+        set_outside_layers( outside );
+    }
+
+    /**
+     * Advance tweens; call once per frame before commit()
+     */
+    void update() noexcept {
+        if ( m_eva.active() || m_evb.active() || m_evy.active() ) {
+            m_eva.step();
+            m_evb.step();
+            m_evy.step();
+            apply();
+        }
+    }
+
+    [[nodiscard]]
+    bool tweening() const noexcept {
+        return m_eva.active() || m_evb.active() || m_evy.active();
+    }
+
+    /**
+     * Write the changed part of the shadow; call in VBlank
+     * @return halfwords written
+     */
+    uint32 commit() noexcept {
+        uint16 shadow[halfwords];
+        std::memcpy( shadow, &m_shadow, sizeof( shadow ) );
+
+        uint32 first = 0;
+        uint32 last = halfwords;
+        if ( m_valid ) {
+            while ( first < halfwords && shadow[first] == m_committed[first] ) {
+                ++first;
+            }
+            while ( last > first && shadow[last - 1] == m_committed[last - 1] ) {
+                --last;
+            }
+        }
+
+        for ( auto ii = first; ii < last; ++ii ) {
+            m_io[ii] = shadow[ii];
+            m_committed[ii] = shadow[ii];
+        }
+        m_valid = true;
+        return last - first;
+    }
+
+    /**
+     * Write the block into a display_shadow, to be committed with the rest of the display registers
+     */
+    template <class Shadow>
+    void commit( Shadow& shadow ) const noexcept {
+        shadow.template write<reg::win0h>( m_shadow.win0h );
+        shadow.template write<reg::win1h>( m_shadow.win1h );
+        shadow.template write<reg::win0v>( m_shadow.win0v );
+        shadow.template write<reg::win1v>( m_shadow.win1v );
+        shadow.template write<reg::winin>( m_shadow.winin );
+        shadow.template write<reg::winout>( m_shadow.winout );
+        shadow.template write<reg::mosaic>( m_shadow.mosaic );
+        shadow.template write<reg::bldcnt>( m_shadow.bldcnt );
+        shadow.template write<reg::bldalpha>( m_shadow.bldalpha );
+        shadow.template write<reg::bldy>( reg::bldy::type::from_data( m_shadow.bldy ) );
+    }
+
+    /**
+     * Write the whole block on the next commit(), such as after other code changed the registers
+     */
+    void invalidate() noexcept {
+        m_valid = false;
+    }
+
+    [[nodiscard]]
+    compositor_registers& registers() noexcept {
+        return m_shadow;
+    }
+
+    [[nodiscard]]
+    const compositor_registers& registers() const noexcept {
+        return m_shadow;
+    }
+
+private:
+    static void set_half( const uint32 half, window_control& control, const uint8 layers ) noexcept {
+        uint16 bits {};
+        std::memcpy( &bits, &control, sizeof( bits ) );
+        const auto shift = half * 8;
+        bits = uint16( ( bits & ~( 0xff << shift ) ) | ( layers & all ) << shift );
+        std::memcpy( &control, &bits, sizeof( bits ) );
+    }
+
+    void apply() noexcept {
+        const auto clamp = []( const int32 value ) noexcept {
+            return uint8( value < 0 ? 0 : value > 16 ? 16 : value );
+        };
+        m_shadow.bldalpha.eva = make_ufixed<4, 4>::from_data( clamp( m_eva.value() ) );
+        m_shadow.bldalpha.evb = make_ufixed<4, 4>::from_data( clamp( m_evb.value() ) );
+        m_shadow.bldy = clamp( m_evy.value() );
+    }
+
+    volatile uint16 * m_io;
+    compositor_registers m_shadow;
+    uint16 m_committed[halfwords];
+    tween m_eva;
+    tween m_evb;
+    tween m_evy;
+    bool m_valid;
+};
+
+} // gba
+
+#endif // define GBAXX_DISPLAY_COMPOSITOR_HPP
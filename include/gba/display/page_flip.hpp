@@ -0,0 +1,299 @@
+#ifndef GBAXX_DISPLAY_PAGE_FLIP_HPP
+#define GBAXX_DISPLAY_PAGE_FLIP_HPP
+
+#include <gba/display/bitmap.hpp>
+#include <gba/dma/dma3_copy.hpp>
+#include <gba/registers/display.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+
+struct dirty_rect {
+    int16 x0;
+    int16 y0;
+    int16 x1; ///< exclusive
+    int16 y1; ///< exclusive
+
+    [[nodiscard]]
+    constexpr int32 area() const noexcept {
+        return int32( x1 - x0 ) * ( y1 - y0 );
+    }
+
+    /**
+     * Overlapping or sharing an edge
+     */
+    [[nodiscard]]
+    constexpr bool touches( const dirty_rect& o ) const noexcept {
+        return x0 <= o.x1 && o.x0 <= x1 && y0 <= o.y1 && o.y0 <= y1;
+    }
+
+    [[nodiscard]]
+    constexpr dirty_rect merged( const dirty_rect& o ) const noexcept {
+        return dirty_rect {
+            x0 < o.x0 ? x0 : o.x0,
+            y0 < o.y0 ? y0 : o.y0,
+            x1 > o.x1 ? x1 : o.x1,
+            y1 > o.y1 ? y1 : o.y1
+        };
+    }
+};
+
+/**
+ * Bounded set of regions, merged as they are added
+ *
+ * Touching regions are always merged. Once the set is full, a new region merges with whichever existing region grows
+ * the least, so the set only ever over-approximates.
+ * @tparam Rects most regions kept
+ * @tparam Align horizontal alignment in pixels (power of two), so rows copy in whole words
+ */
+template <unsigned Rects, unsigned Align = 1>
+class dirty_rects {
+    static_assert( Rects > 0, "dirty_rects needs at least one rect" );
+    static_assert( Align > 0 && ( Align & ( Align - 1 ) ) == 0, "dirty_rects Align must be a power of two" );
+public:
+    constexpr dirty_rects( const int32 width, const int32 height ) noexcept : m_rects {}, m_count {}, m_width { width }, m_height { height } {}
+
+    constexpr void add( int32 x, int32 y, int32 w, int32 h ) noexcept {
+        auto x1 = x + w;
+        auto y1 = y + h;
+        x = x < 0 ? 0 : x & ~int32( Align - 1 );
+        y = y < 0 ? 0 : y;
+        x1 = x1 > m_width ? m_width : ( x1 + int32( Align - 1 ) ) & ~int32( Align - 1 );
+        y1 = y1 > m_height ? m_height : y1;
+        if ( x >= x1 || y >= y1 ) {
+            return;
+        }
+
+        auto rect = dirty_rect { int16( x ), int16( y ), int16( x1 ), int16( y1 ) };
+
+        // A merge can make the result touch rects it did not before, so keep absorbing until nothing changes
+        for ( uint32 ii = 0; ii < m_count; ) {
+            if ( m_rects[ii].touches( rect ) ) {
+                rect = rect.merged( m_rects[ii] );
+                m_rects[ii] = m_rects[--m_count];
+                ii = 0;
+            } else {
+                ++ii;
+            }
+        }
+
+        if ( m_count < Rects ) {
+            m_rects[m_count++] = rect;
+            return;
+        }
+
+        uint32 best = 0;
+        auto bestGrowth = m_rects[0].merged( rect ).area() - m_rects[0].area();
+        for ( uint32 ii = 1; ii < m_count; ++ii ) {
+            const auto growth = m_rects[ii].merged( rect ).area() - m_rects[ii].area();
+            if ( growth < bestGrowth ) {
+                best = ii;
+                bestGrowth = growth;
+            }
+        }
+        rect = rect.merged( m_rects[best] );
+        m_rects[best] = m_rects[--m_count];
+        add( rect.x0, rect.y0, rect.x1 - rect.x0, rect.y1 - rect.y0 );
+    }
+
+    constexpr void add_all() noexcept {
+        m_rects[0] = dirty_rect { 0, 0, int16( m_width ), int16( m_height ) };
+        m_count = 1;
+    }
+
+    constexpr void clear() noexcept {
+        m_count = 0;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 size() const noexcept {
+        return m_count;
+    }
+
+    [[nodiscard]]
+    constexpr const dirty_rect& operator []( const uint32 index ) const noexcept {
+        return m_rects[index];
+    }
+
+    /**
+     * Pixels covered; rects never overlap
+     */
+    [[nodiscard]]
+    constexpr int32 area() const noexcept {
+        int32 total = 0;
+        for ( uint32 ii = 0; ii < m_count; ++ii ) {
+            total += m_rects[ii].area();
+        }
+        return total;
+    }
+
+private:
+    dirty_rect m_rects[Rects];
+    uint32 m_count;
+    int32 m_width;
+    int32 m_height;
+};
+
+/**
+ * Double buffering for the paged bitmap modes (4 and 5)
+ *
+ * Each frame: begin(), draw on back() and mark() what changed, present(), then vblank() during VBlank flips the
+ * displayed page. The next begin() brings the new back page up to date by copying only the regions marked on the
+ * previous frame, rather than redrawing everything.
+ * @tparam Bitmap bitmap_mode4 or bitmap_mode5
+ * @tparam Rects regions tracked per frame
+ * @tparam Copy dma3_copy, or cpu_copy off-hardware
+ */
+template <class Bitmap, unsigned Rects = 16, class Copy = dma3_copy>
+class page_flipper {
+    static constexpr uint32 pixels_per_word = 4 / ( Bitmap::pitch / Bitmap::width );
+public:
+    using rects_type = dirty_rects<Rects, pixels_per_word>;
+
+    page_flipper() noexcept : page_flipper( reinterpret_cast<void *>( 0x6000000 ), reinterpret_cast<void *>( 0x600a000 ) ) {}
+
+    page_flipper( void * page0, void * page1 ) noexcept : m_pages { static_cast<uint32 *>( page0 ), static_cast<uint32 *>( page1 ) }, m_drawn { Bitmap::width, Bitmap::height },
+        m_copy { Bitmap::width, Bitmap::height }, m_front {}, m_pending {}, m_copied {} {}
+
+    /**
+     * Start drawing a frame, copying last frame's regions forward onto the back page
+     * @return false while a presented frame is still waiting for VBlank; do not draw yet
+     */
+    bool begin() noexcept {
+        if ( m_pending ) {
+            return false;
+        }
+
+        m_copied = 0;
+        const auto * src = m_pages[m_front];
+        auto * dest = m_pages[m_front ^ 1];
+        for ( uint32 ii = 0; ii < m_copy.size(); ++ii ) {
+            const auto& rect = m_copy[ii];
+            const auto first = ( rect.y0 * Bitmap::pitch ) / 4 + rect.x0 / pixels_per_word;
+            const auto words = uint32( rect.x1 - rect.x0 ) / pixels_per_word;
+            for ( auto row = rect.y0; row < rect.y1; ++row ) {
+                const auto offset = first + ( row - rect.y0 ) * ( Bitmap::pitch / 4 );
+                Copy::copy( src + offset, dest + offset, words );
+            }
+            m_copied += words * 4 * uint32( rect.y1 - rect.y0 );
+        }
+        m_copy.clear();
+        return true;
+    }
+
+    /**
+     * Record a region drawn on the back page this frame
+     */
+    constexpr void mark( const int32 x, const int32 y, const int32 w, const int32 h ) noexcept {
+        m_drawn.add( x, y, w, h );
+    }
+
+    /**
+     * Record that the whole back page changed, such as after clearing it
+     */
+    constexpr void mark_all() noexcept {
+        m_drawn.add_all();
+    }
+
+    /**
+     * Show the back page at the next vblank()
+     */
+    void present() noexcept {
+        m_pending = true;
+    }
+
+    /**
+     * Call during VBlank; writes DISPCNT directly, so where a display_shadow manages the display registers use
+     * vblank( shadow ) instead, or its next commit() of a changed DISPCNT puts the old page back
+     * @return true if the page flipped
+     */
+    bool vblank() noexcept {
+        if ( !m_pending ) {
+            return false;
+        }
+
+        auto control = reg::dispcnt::read();
+        control.page = m_front ^ 1;
+        reg::dispcnt::write( control );
+
+        flip();
+        return true;
+    }
+
+    /**
+     * Call during VBlank, before committing the shadow: the page bit goes into the shadow's DISPCNT
+     * @return true if the page flipped
+     */
+    template <class Shadow>
+    bool vblank( Shadow& shadow ) noexcept {
+        if ( !m_pending ) {
+            return false;
+        }
+
+        const auto page = m_front ^ 1;
+        shadow.template transform<reg::dispcnt>( [page]( auto& control ) noexcept {
+            control.page = page;
+        } );
+
+        flip();
+        return true;
+    }
+
+    /**
+     * Swap pages without touching the display registers; vblank() uses this after writing the page bit
+     */
+    void flip() noexcept {
+        m_front ^= 1;
+        m_pending = false;
+        m_copy = m_drawn;
+        m_drawn.clear();
+    }
+
+    [[nodiscard]]
+    constexpr Bitmap back() const noexcept {
+        return Bitmap( m_pages[m_front ^ 1] );
+    }
+
+    [[nodiscard]]
+    constexpr Bitmap front() const noexcept {
+        return Bitmap( m_pages[m_front] );
+    }
+
+    [[nodiscard]]
+    constexpr uint32 front_page() const noexcept {
+        return m_front;
+    }
+
+    [[nodiscard]]
+    bool pending() const noexcept {
+        return m_pending;
+    }
+
+    /**
+     * Regions marked so far this frame
+     */
+    [[nodiscard]]
+    constexpr const rects_type& dirty() const noexcept {
+        return m_drawn;
+    }
+
+    /**
+     * Bytes copied forward by the last begin()
+     */
+    [[nodiscard]]
+    constexpr uint32 copied_bytes() const noexcept {
+        return m_copied;
+    }
+
+private:
+    uint32 * m_pages[2];
+    rects_type m_drawn;
+    rects_type m_copy;
+    uint32 m_front;
+    volatile bool m_pending;
+    uint32 m_copied;
+};
+
+} // gba
+
+#endif // define GBAXX_DISPLAY_PAGE_FLIP_HPP
@@ -0,0 +1,245 @@
+#ifndef GBAXX_DISPLAY_PARALLAX_HPP
+#define GBAXX_DISPLAY_PARALLAX_HPP
+
+#include <gba/display/mosaic.hpp>
+#include <gba/registers/display.hpp>
+#include <gba/registers/dma.hpp>
+#include <gba/types/fixed_point.hpp>
+#include <gba/types/fixed_point_make.hpp>
+#include <gba/types/fixed_point_operators.hpp>
+#include <gba/types/int_cast.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+
+/// Fraction of the camera's movement a layer follows; 1 moves with the camera, 0 stays still
+using parallax_factor = make_fixed<7, 8>;
+/// Camera position in pixels
+using parallax_position = make_fixed<23, 8>;
+
+/**
+ * Scanlines from first_line down to the next band's first_line, scrolling horizontally at their own rate
+ */
+struct parallax_band {
+    uint8 first_line;
+    parallax_factor factor_x;
+    int16 origin_x;
+};
+
+/**
+ * Background scroll offsets following a camera at per-layer rates
+ *
+ * update() makes one pass over the four regular backgrounds, one fixed_point multiply per axis. One layer may be split
+ * into horizontal bands (sky, hills, ground) that each follow the camera at their own horizontal rate; its offsets
+ * go into a per-scanline table that start_hdma() feeds to the layer's offset registers with HBlank DMA0.
+ *
+ * MOSAIC is only written once set_mosaic() or set_object_mosaic() has been called, so a compositor may own it instead.
+ */
+class parallax {
+public:
+    static constexpr uint32 layers = 4;
+    static constexpr uint32 lines = 160;
+
+    struct offset {
+        int16 x;
+        int16 y;
+    };
+
+    constexpr parallax() noexcept : m_layers {}, m_cameraX {}, m_cameraY {}, m_offsets {}, m_table {}, m_bands {}, m_bandCount {}, m_bandLayer {}, m_mosaic {}, m_mosaicSet {} {}
+
+    /**
+     * @param factorX,factorY camera rate on each axis
+     * @param originX,originY offset added after the camera, such as to align a layer's start
+     */
+    constexpr void set_layer( const uint32 background, const parallax_factor factorX, const parallax_factor factorY, const int16 originX = 0, const int16 originY = 0 ) noexcept {
+        m_layers[background] = layer { factorX, factorY, originX, originY, true };
+    }
+
+    /**
+     * Stop updating a layer's offsets
+     */
+    constexpr void disable( const uint32 background ) noexcept {
+        m_layers[background].enabled = false;
+        if ( m_bandCount && m_bandLayer == background ) {
+            m_bandCount = 0;
+        }
+    }
+
+    /**
+     * Split one layer into horizontal bands; bands are sorted by first_line, and the first covers from line 0.
+     * A count of 0 removes the bands
+     */
+    constexpr void set_bands( const uint32 background, const parallax_band * bands, const uint32 count ) noexcept {
+        m_bands = bands;
+        m_bandCount = count;
+        m_bandLayer = background;
+    }
+
+    constexpr void set_camera( const parallax_position x, const parallax_position y ) noexcept {
+        m_cameraX = x;
+        m_cameraY = y;
+    }
+
+    /**
+     * Background mosaic block size in pixels (1 to 16); layers enable mosaic in their background_control
+     */
+    constexpr void set_mosaic( const uint32 width, const uint32 height ) noexcept {
+        m_mosaic.background = dimension( width, height );
+        m_mosaicSet = true;
+    }
+
+    /**
+     * Object mosaic block size in pixels (1 to 16), written with the background size; objects enable mosaic in their
+     * attributes
+     */
+    constexpr void set_object_mosaic( const uint32 width, const uint32 height ) noexcept {
+        m_mosaic.object = dimension( width, height );
+        m_mosaicSet = true;
+    }
+
+    /**
+     * Recompute every enabled layer's offsets, and the banded layer's scanline table
+     */
+    void update() noexcept {
+        for ( uint32 bg = 0; bg < layers; ++bg ) {
+            const auto& l = m_layers[bg];
+            if ( !l.enabled ) {
+                continue;
+            }
+
+            const auto y = int16( scale( m_cameraY, l.factor_y ) + l.origin_y );
+            if ( bg != m_bandLayer || !m_bandCount ) {
+                m_offsets[bg] = offset { int16( scale( m_cameraX, l.factor_x ) + l.origin_x ), y };
+                continue;
+            }
+
+            // One multiply per band, then fill its lines
+            const auto vertical = uint32( uint16( y ) ) << 16;
+            for ( uint32 bb = 0; bb < m_bandCount; ++bb ) {
+                const auto& band = m_bands[bb];
+                const auto first = bb ? uint32( band.first_line ) : 0;
+                const auto last = bb + 1 < m_bandCount ? uint32( m_bands[bb + 1].first_line ) : lines;
+                const auto word = vertical | uint16( scale( m_cameraX, band.factor_x ) + band.origin_x );
+                for ( auto line = first; line < last && line < lines; ++line ) {
+                    m_table[line] = word;
+                }
+            }
+            // Read in the HBlank after line 159, so line 0 of the next frame is right even before commit()
+            m_table[lines] = m_table[0];
+            m_offsets[bg] = offset { int16( m_table[0] ), y };
+        }
+    }
+
+    /**
+     * Write every enabled layer's offsets and, once set, the mosaic sizes; for the banded layer, its line 0 offsets
+     */
+    void commit() const noexcept {
+        const auto write = [this]( const uint32 bg, auto hofs, auto vofs ) noexcept {
+            hofs.write( m_offsets[bg].x );
+            vofs.write( m_offsets[bg].y );
+        };
+        apply( write );
+        if ( m_mosaicSet ) {
+            reg::mosaic::write( m_mosaic );
+        }
+    }
+
+    /**
+     * Write the same values into a display_shadow, to be committed with the rest of the display registers
+     */
+    template <class Shadow>
+    void commit( Shadow& shadow ) const noexcept {
+        const auto write = [this, &shadow]( const uint32 bg, auto hofs, auto vofs ) noexcept {
+            shadow.template write<decltype( hofs )>( m_offsets[bg].x );
+            shadow.template write<decltype( vofs )>( m_offsets[bg].y );
+        };
+        apply( write );
+        if ( m_mosaicSet ) {
+            shadow.template write<reg::mosaic>( m_mosaic );
+        }
+    }
+
+    /**
+     * Start HBlank DMA0 writing the banded layer's offsets from line 1 on; call in VBlank after commit()
+     */
+    void start_hdma() const noexcept {
+        reg::dma0cnt_h::write( {} );
+        if ( !m_bandCount ) {
+            return;
+        }
+
+        // The first transfer happens in the HBlank after line 0, which commit() already set
+        reg::dma0sad::write( address_cast( m_table + 1 ) );
+        reg::dma0dad::write( 0x4000010 + m_bandLayer * 4 );
+        constexpr auto control = dma_control {
+            .destination_control = dma_control::destination_address::increment_then_reload,
+            .repeat = true,
+            .type = dma_control::type::word,
+            .start_condition = dma_control::start::next_hblank,
+            .enable = true
+        };
+        reg::dma0cnt::write( { .transfers = 1, .control = control } );
+    }
+
+    [[nodiscard]]
+    constexpr const offset& offsets( const uint32 background ) const noexcept {
+        return m_offsets[background];
+    }
+
+    /**
+     * Banded layer's offsets per scanline, horizontal in the low halfword and vertical in the high; one entry past
+     * line 159 repeats line 0 for the last HBlank transfer
+     */
+    [[nodiscard]]
+    constexpr const uint32 * table() const noexcept {
+        return m_table;
+    }
+
+private:
+    struct layer {
+        parallax_factor factor_x;
+        parallax_factor factor_y;
+        int16 origin_x;
+        int16 origin_y;
+        bool enabled;
+    };
+
+    [[nodiscard]]
+    static int32 scale( const parallax_position camera, const parallax_factor factor ) noexcept {
+        return int32( parallax_position( camera * factor ) );
+    }
+
+    template <class Write>
+    void apply( Write&& write ) const noexcept {
+        const auto enabled = [this]( const uint32 bg ) noexcept {
+            return m_layers[bg].enabled;
+        };
+        if ( enabled( 0 ) ) {
+            write( 0, reg::bg0hofs {}, reg::bg0vofs {} );
+        }
+        if ( enabled( 1 ) ) {
+            write( 1, reg::bg1hofs {}, reg::bg1vofs {} );
+        }
+        if ( enabled( 2 ) ) {
+            write( 2, reg::bg2hofs {}, reg::bg2vofs {} );
+        }
+        if ( enabled( 3 ) ) {
+            write( 3, reg::bg3hofs {}, reg::bg3vofs {} );
+        }
+    }
+
+    layer m_layers[layers];
+    parallax_position m_cameraX;
+    parallax_position m_cameraY;
+    offset m_offsets[layers];
+    uint32 m_table[lines + 1];
+    const parallax_band * m_bands;
+    uint32 m_bandCount;
+    uint32 m_bandLayer;
+    mosaic_size m_mosaic;
+    bool m_mosaicSet;
+};
+
+} // gba
+
+#endif // define GBAXX_DISPLAY_PARALLAX_HPP
@@ -0,0 +1,272 @@
+#ifndef GBAXX_DISPLAY_RASTERIZER_HPP
+#define GBAXX_DISPLAY_RASTERIZER_HPP
+
+#include <gba/display/bitmap.hpp>
+#include <gba/system/iwram.hpp>
+#include <gba/types/fixed_point.hpp>
+#include <gba/types/fixed_point_make.hpp>
+#include <gba/types/fixed_point_operators.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/matrix.hpp>
+
+namespace gba {
+
+using raster_fixed = make_fixed<15, 16>;
+
+/**
+ * Screen space vertex; u and v are texel coordinates
+ */
+struct raster_vertex {
+    raster_fixed x;
+    raster_fixed y;
+    raster_fixed u;
+    raster_fixed v;
+};
+
+/**
+ * 8-bit texture with power of two dimensions, row major; coordinates wrap
+ */
+struct raster_texture {
+    const uint8 * texels;
+    uint32 width_shift;
+    uint32 height_shift;
+};
+
+/**
+ * Affine textured span of 8-bit pixels from x0 to x1 exclusive; u, v and their steps are 16.16
+ *
+ * Lone edge pixels are read-modify-written, pairs are written as halfwords and runs of four as words.
+ */
+[[GBAXX_IWRAM_ARM]]
+inline void raster_texture_span( uint16 * row, int32 x0, const int32 x1, uint32 u, uint32 v, const uint32 dudx, const uint32 dvdx, const raster_texture& texture ) noexcept {
+    const auto * texels = texture.texels;
+    const auto shift = texture.width_shift;
+    const auto uMask = ( 1u << texture.width_shift ) - 1;
+    const auto vMask = ( 1u << texture.height_shift ) - 1;
+
+    const auto sample = [&]() noexcept {
+        const uint32 texel = texels[( ( v >> 16 ) & vMask ) << shift | ( ( u >> 16 ) & uMask )];
+        u += dudx;
+        v += dvdx;
+        return texel;
+    };
+
+    if ( x0 & 1 ) {
+        auto& pair = row[x0 / 2];
+        pair = uint16( ( pair & 0x00ff ) | sample() << 8 );
+        ++x0;
+    }
+    if ( ( x0 & 2 ) && x0 + 2 <= x1 ) {
+        const auto lo = sample();
+        row[x0 / 2] = uint16( lo | sample() << 8 );
+        x0 += 2;
+    }
+
+    auto * words = reinterpret_cast<uint32 *>( row + x0 / 2 );
+    for ( ; x0 + 4 <= x1; x0 += 4 ) {
+        const auto t0 = sample();
+        const auto t1 = sample();
+        const auto t2 = sample();
+        *words++ = t0 | t1 << 8 | t2 << 16 | sample() << 24;
+    }
+
+    if ( x0 + 2 <= x1 ) {
+        const auto lo = sample();
+        row[x0 / 2] = uint16( lo | sample() << 8 );
+        x0 += 2;
+    }
+    if ( x0 < x1 ) {
+        auto& pair = row[x0 / 2];
+        pair = uint16( ( pair & 0xff00 ) | sample() );
+    }
+}
+
+/**
+ * Flat shaded and affine textured triangles
+ *
+ * Pixel centers are sampled at half coordinates and edges follow the top-left rule, so triangles sharing an edge
+ * never overdraw or leave gaps. Edges are walked in 16.16 fixed point, starting at the first row inside the bitmap
+ * and stopping at its last, so rows above and below the screen cost nothing; flat spans use the bitmap's word fills
+ * and textured spans raster_texture_span(). Vertices may lie far outside the bitmap, but each triangle must span
+ * less than 32768 pixels on either axis, as edge lengths are raster_fixed.
+ * @tparam Bitmap bitmap_mode4 for textured triangles, any bitmap for flat ones
+ */
+template <class Bitmap>
+class rasterizer {
+public:
+    using pixel = typename Bitmap::pixel;
+
+    explicit constexpr rasterizer( const Bitmap& target ) noexcept : m_target { target }, m_triangles {} {}
+
+    /**
+     * Transform a point by a model-view-projection matrix onto the screen
+     *
+     * Only points with w <= 0 are rejected. Points close to the camera divide by a small w and wrap raster_fixed, so
+     * the caller must clip triangles against a near plane first.
+     * @return false if the point is behind the camera
+     */
+    template <typename T>
+    [[nodiscard]]
+    static bool project( const mat4x4<T>& mvp, const raster_fixed x, const raster_fixed y, const raster_fixed z, raster_vertex& out ) noexcept {
+        const auto clipX = row( mvp.column0.x, mvp.column1.x, mvp.column2.x, mvp.column3.x, x, y, z );
+        const auto clipY = row( mvp.column0.y, mvp.column1.y, mvp.column2.y, mvp.column3.y, x, y, z );
+        const auto clipW = row( mvp.column0.w, mvp.column1.w, mvp.column2.w, mvp.column3.w, x, y, z );
+        if ( clipW.data() <= 0 ) {
+            return false;
+        }
+
+        constexpr auto halfWidth = raster_fixed( Bitmap::width / 2 );
+        constexpr auto halfHeight = raster_fixed( Bitmap::height / 2 );
+        out.x = raster_fixed( halfWidth + raster_fixed( clipX / clipW ) * halfWidth );
+        out.y = raster_fixed( halfHeight - raster_fixed( clipY / clipW ) * halfHeight );
+        return true;
+    }
+
+    void fill( const raster_vertex& v0, const raster_vertex& v1, const raster_vertex& v2, const pixel color ) noexcept {
+        walk( v0, v1, v2, [&]( const int32 y, const int32 x0, const int32 x1 ) noexcept {
+            m_target.hline( x0, x1 - 1, y, color );
+        } );
+    }
+
+    /**
+     * Affine textured triangle
+     *
+     * The gradients are computed in 64 bits, which holds while the triangle's extent in pixels and its extent in
+     * texels together need at most 22 bits, such as 1024 pixels across mapping up to 4096 texels. Larger triangles
+     * must be split by the caller.
+     */
+    void fill( const raster_vertex& v0, const raster_vertex& v1, const raster_vertex& v2, const raster_texture& texture ) noexcept {
+        static_assert( sizeof( pixel ) == 1, "textured triangles need an 8-bit bitmap" );
+
+        // Affine mapping: u and v are planes over the triangle, so their screen gradients are constant. Differences
+        // drop to 12 fractional bits; each numerator is then below 2^( pixel bits + texel bits + 41 )
+        const int64 e1x = ( v1.x.data() - v0.x.data() ) >> 4;
+        const int64 e1y = ( v1.y.data() - v0.y.data() ) >> 4;
+        const int64 e2x = ( v2.x.data() - v0.x.data() ) >> 4;
+        const int64 e2y = ( v2.y.data() - v0.y.data() ) >> 4;
+        const auto area = e1x * e2y - e2x * e1y;
+        if ( area == 0 ) {
+            return;
+        }
+        const int64 e1u = ( v1.u.data() - v0.u.data() ) >> 4;
+        const int64 e2u = ( v2.u.data() - v0.u.data() ) >> 4;
+        const int64 e1v = ( v1.v.data() - v0.v.data() ) >> 4;
+        const int64 e2v = ( v2.v.data() - v0.v.data() ) >> 4;
+        const auto dudx = int32( ( ( e1u * e2y - e2u * e1y ) << 16 ) / area );
+        const auto dudy = int32( ( ( e2u * e1x - e1u * e2x ) << 16 ) / area );
+        const auto dvdx = int32( ( ( e1v * e2y - e2v * e1y ) << 16 ) / area );
+        const auto dvdy = int32( ( ( e2v * e1x - e1v * e2x ) << 16 ) / area );
+
+        auto * pixels = static_cast<uint16 *>( m_target.data() );
+        walk( v0, v1, v2, [&]( const int32 y, const int32 x0, const int32 x1 ) noexcept {
+            const int64 px = ( int64( x0 ) << 16 ) + 0x8000 - v0.x.data();
+            const int64 py = ( int64( y ) << 16 ) + 0x8000 - v0.y.data();
+            const auto u = uint32( v0.u.data() + ( ( px * dudx + py * dudy ) >> 16 ) );
+            const auto v = uint32( v0.v.data() + ( ( px * dvdx + py * dvdy ) >> 16 ) );
+            raster_texture_span( pixels + y * ( Bitmap::pitch / 2 ), x0, x1, u, v, uint32( dudx ), uint32( dvdx ), texture );
+        } );
+    }
+
+    /**
+     * Triangles that covered at least one row
+     */
+    [[nodiscard]]
+    constexpr uint32 triangles() const noexcept {
+        return m_triangles;
+    }
+
+    [[nodiscard]]
+    constexpr Bitmap& target() noexcept {
+        return m_target;
+    }
+
+private:
+    using int64 = int_type<64>::type;
+
+    template <typename T>
+    [[nodiscard]]
+    static raster_fixed row( const T& m0, const T& m1, const T& m2, const T& m3, const raster_fixed x, const raster_fixed y, const raster_fixed z ) noexcept {
+        return raster_fixed( raster_fixed( raster_fixed( m0 ) * x ) + raster_fixed( raster_fixed( m1 ) * y ) + raster_fixed( raster_fixed( m2 ) * z ) + raster_fixed( m3 ) );
+    }
+
+    // First pixel whose center is at or right of/below edge (16.16)
+    [[nodiscard]]
+    static constexpr int32 first_pixel( const int32 edge ) noexcept {
+        return ( edge - 0x8000 + 0xffff ) >> 16;
+    }
+
+    struct edge {
+        edge( const raster_vertex& top, const raster_vertex& bottom, const int32 startRow ) noexcept : step {}, x {} {
+            const auto height = bottom.y - top.y;
+            if ( height.data() > 0 ) {
+                step = raster_fixed( ( bottom.x - top.x ) / height );
+            }
+            // The row may be far below top, such as row 0 of an edge starting off-screen
+            const auto offset = ( int64( startRow ) << 16 ) + 0x8000 - top.y.data();
+            x = raster_fixed::from_data( int32( top.x.data() + ( ( offset * step.data() ) >> 16 ) ) );
+        }
+
+        raster_fixed step;
+        raster_fixed x;
+    };
+
+    // Calls span( y, x0, x1 exclusive ) for every covered row inside the bitmap
+    template <class Span>
+    void walk( const raster_vertex& v0, const raster_vertex& v1, const raster_vertex& v2, Span&& span ) noexcept {
+        const auto * a = &v0;
+        const auto * b = &v1;
+        const auto * c = &v2;
+        if ( b->y.data() < a->y.data() ) {
+            const auto * t = a; a = b; b = t;
+        }
+        if ( c->y.data() < b->y.data() ) {
+            const auto * t = b; b = c; c = t;
+        }
+        if ( b->y.data() < a->y.data() ) {
+            const auto * t = a; a = b; b = t;
+        }
+
+        const auto top = first_pixel( a->y.data() );
+        const auto middle = first_pixel( b->y.data() );
+        const auto bottom = first_pixel( c->y.data() );
+        if ( top >= bottom ) {
+            return;
+        }
+        ++m_triangles;
+
+        // Start both edges at the first row inside the bitmap
+        const auto first = top > 0 ? top : 0;
+        const auto last = bottom < Bitmap::height ? bottom : Bitmap::height;
+        auto longEdge = edge( *a, *c, first );
+        auto shortEdge = first < middle ? edge( *a, *b, first ) : edge( *b, *c, first );
+
+        // Which side the long edge is on: the sign of the middle vertex against it
+        const auto ab = int64( b->x.data() - a->x.data() ) * ( c->y.data() - a->y.data() );
+        const auto ac = int64( c->x.data() - a->x.data() ) * ( b->y.data() - a->y.data() );
+        const auto longOnLeft = ab > ac;
+
+        for ( auto y = first; y < last; ++y ) {
+            if ( y == middle && y != first ) {
+                shortEdge = edge( *b, *c, y );
+            }
+            const auto& left = longOnLeft ? longEdge : shortEdge;
+            const auto& right = longOnLeft ? shortEdge : longEdge;
+            auto x0 = first_pixel( left.x.data() );
+            auto x1 = first_pixel( right.x.data() );
+            x0 = x0 < 0 ? 0 : x0;
+            x1 = x1 > Bitmap::width ? Bitmap::width : x1;
+            if ( x0 < x1 ) {
+                span( y, x0, x1 );
+            }
+            longEdge.x += longEdge.step;
+            shortEdge.x += shortEdge.step;
+        }
+    }
+
+    Bitmap m_target;
+    uint32 m_triangles;
+};
+
+} // gba
+
+#endif // define GBAXX_DISPLAY_RASTERIZER_HPP
@@ -0,0 +1,256 @@
+#ifndef GBAXX_DISPLAY_TEXT_RENDERER_HPP
+#define GBAXX_DISPLAY_TEXT_RENDERER_HPP
+
+#include <gba/allocator/screen_regular.hpp>
+#include <gba/allocator/tile_4bpp.hpp>
+#include <gba/system/iwram.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/screen_size.hpp>
+#include <gba/types/screen_tile.hpp>
+
+namespace gba {
+
+/**
+ * Variable width 1bpp font, glyphs up to 8 by 8 pixels
+ */
+struct font_1bpp {
+    const uint8 * glyphs; ///< height bytes per glyph, one per row; bit 0 is the leftmost pixel
+    const uint8 * widths; ///< advance of each glyph in pixels (0 to 8)
+    uint8 first; ///< character of the first glyph
+    uint8 count;
+    uint8 height; ///< rows per glyph (at most 8); rows past the eighth are not drawn
+};
+
+/**
+ * Draws text from a 1bpp font into 4bpp tiles and writes the screen entries showing it
+ *
+ * Glyphs are packed pixel by pixel, so one tile can hold the end of one glyph and the start of the next. Each finished
+ * tile is looked up by content in a hash table before anything is uploaded, so repeated words and letters at the same
+ * alignment share tiles. Blank tiles all use the first tile, which is kept empty. Text past the right or bottom edge of
+ * the screen is clipped. Printing runs as ARM code in IWRAM.
+ *
+ * A cache slot is one word: the top 22 bits of the content hash over the tile's index. A matching hash is confirmed
+ * against the uploaded tile, so colliding hashes cost a compare, never a wrong tile.
+ * @tparam CacheSlots hash table entries (power of two); at least twice the tiles available
+ */
+template <unsigned CacheSlots = 1024>
+class text_renderer {
+    static_assert( CacheSlots > 0 && ( CacheSlots & ( CacheSlots - 1 ) ) == 0, "text_renderer CacheSlots must be a power of two" );
+
+    using uint64 = uint_type<64>::type;
+
+    static constexpr uint32 index_mask = 0x3ff;
+    static constexpr uint64 lanes = 0x0101010101010101;
+public:
+    struct counters {
+        uint32 tiles; ///< non-blank tiles written to the screen
+        uint32 hits; ///< of those, tiles that were already uploaded
+        uint32 uploads;
+        uint32 failures; ///< tiles dropped because every tile or cache slot is in use
+    };
+
+    text_renderer( buffer_tile4bpp& tiles, buffer_screen_regular& screen, const font_1bpp& font ) noexcept : text_renderer( static_cast<uint32 *>( tiles.map() ), tiles.start_index(), tiles.size() / 0x20, screen.map(), screen.screen_size(), font ) {}
+
+    /**
+     * @param tiles first tile's data
+     * @param startIndex tile index of the first tile
+     * @param tileCount tiles available; at most 1024 are used
+     */
+    text_renderer( uint32 * tiles, const uint32 startIndex, const uint32 tileCount, screen_tile * screen, const screen_size_regular size, const font_1bpp& font ) noexcept : m_table {}, m_tiles { tiles }, m_screen { screen }, m_font { &font },
+        m_startIndex { startIndex }, m_tileCount { tileCount < index_mask + 1 ? tileCount : index_mask + 1 }, m_next {},
+        m_width { ( size == screen_size_regular::_64x32 || size == screen_size_regular::_64x64 ) ? 64u : 32u },
+        m_height { ( size == screen_size_regular::_32x64 || size == screen_size_regular::_64x64 ) ? 64u : 32u }, m_counters {} {
+        reset();
+    }
+
+    /**
+     * Forget every uploaded tile, such as before drawing a new page; clears the blank tile
+     */
+    void reset() noexcept {
+        for ( auto& slot : m_table ) {
+            slot = 0;
+        }
+        for ( uint32 ii = 0; ii < 8; ++ii ) {
+            m_tiles[ii] = 0;
+        }
+        m_next = 1;
+    }
+
+    /**
+     * Draw text starting at a tile position; '\n' continues on the next tile row at the same column
+     * @param color palette index of the ink (1 to 15); index 0 is transparent
+     * @return rows of tiles used, including rows clipped off the bottom of the screen
+     */
+    [[GBAXX_IWRAM_ARM]]
+    uint32 print( uint32 column, uint32 row, const char * text, const uint8 color, const uint16 paletteBank = 0 ) noexcept {
+        const auto startColumn = column;
+        uint32 rows = 1;
+
+        // The tile being packed and the glyph pixels past its right edge, a byte per row
+        uint64 pending = 0;
+        uint64 spill = 0;
+        uint32 bits = 0;
+        for ( ; ; ++text ) {
+            const auto character = uint8( *text );
+            if ( character == '\0' || character == '\n' ) {
+                if ( bits ) {
+                    emit( column++, row, pending, color, paletteBank );
+                }
+                if ( character == '\0' ) {
+                    break;
+                }
+                column = startColumn;
+                ++row;
+                ++rows;
+                bits = 0;
+                pending = 0;
+                spill = 0;
+                continue;
+            }
+
+            const auto glyph = uint32( character - m_font->first );
+            if ( glyph >= m_font->count ) {
+                continue;
+            }
+
+            // Every row shifts at once; pixels crossing a byte go to the spill instead of the next row
+            const auto pixels = glyph_rows( glyph );
+            const auto keep = lanes * ( ( 0xffu << bits ) & 0xff );
+            pending |= ( pixels << bits ) & keep;
+            spill |= ( pixels >> ( 8 - bits ) ) & ~keep;
+            bits += m_font->widths[glyph];
+            if ( bits >= 8 ) {
+                emit( column++, row, pending, color, paletteBank );
+                pending = spill;
+                spill = 0;
+                bits -= 8;
+            }
+        }
+        return rows;
+    }
+
+    /**
+     * Pixel width of a line of text
+     */
+    [[nodiscard]]
+    uint32 measure( const char * text ) const noexcept {
+        uint32 width = 0;
+        for ( ; *text && *text != '\n'; ++text ) {
+            const auto glyph = uint32( uint8( *text ) - m_font->first );
+            width += glyph < m_font->count ? m_font->widths[glyph] : 0;
+        }
+        return width;
+    }
+
+    /**
+     * Tiles in use, including the blank tile
+     */
+    [[nodiscard]]
+    uint32 tiles_used() const noexcept {
+        return m_next;
+    }
+
+    [[nodiscard]]
+    const counters& stats() const noexcept {
+        return m_counters;
+    }
+
+    /**
+     * Spread 8 pixels of 1bpp into a 4bpp row of color
+     */
+    [[nodiscard]]
+    static constexpr uint32 expand( const uint32 bits, const uint8 color ) noexcept {
+        auto x = bits & 0xff;
+        x = ( x | x << 12 ) & 0x000f000f;
+        x = ( x | x << 6 ) & 0x03030303;
+        x = ( x | x << 3 ) & 0x11111111;
+        return x * color;
+    }
+
+private:
+    [[nodiscard]]
+    uint64 glyph_rows( const uint32 glyph ) const noexcept {
+        const auto * src = m_font->glyphs + glyph * m_font->height;
+        const auto height = m_font->height < 8u ? m_font->height : 8u;
+        uint64 rows = 0;
+        for ( uint32 ii = 0; ii < height; ++ii ) {
+            rows |= uint64( src[ii] ) << ( ii * 8 );
+        }
+        return rows;
+    }
+
+    [[GBAXX_IWRAM_ARM]]
+    void emit( const uint32 column, const uint32 row, const uint64 rows, const uint8 color, const uint16 paletteBank ) noexcept {
+        if ( column >= m_width || row >= m_height ) {
+            return;
+        }
+
+        screen_tile tile {};
+        tile.palette_bank = paletteBank;
+        tile.tile_index = uint16( m_startIndex + ( rows ? lookup( rows, color ) : 0 ) );
+        m_screen[screen_index( column, row )] = tile;
+    }
+
+    [[GBAXX_IWRAM_ARM]]
+    uint32 lookup( const uint64 rows, const uint8 color ) noexcept {
+        ++m_counters.tiles;
+
+        const auto hash = ( uint32( rows ^ rows >> 29 ^ rows >> 47 ) + color ) * 0x9e3779b1u;
+        const auto key = hash & ~index_mask;
+        for ( uint32 probe = 0; probe < CacheSlots; ++probe ) {
+            auto& slot = m_table[( ( hash >> 16 ) + probe ) % CacheSlots];
+            if ( slot ) {
+                if ( ( slot & ~index_mask ) == key && holds( slot & index_mask, rows, color ) ) {
+                    ++m_counters.hits;
+                    return slot & index_mask;
+                }
+                continue;
+            }
+
+            if ( m_next >= m_tileCount ) {
+                break;
+            }
+            auto * dest = m_tiles + m_next * 8;
+            for ( uint32 ii = 0; ii < 8; ++ii ) {
+                dest[ii] = expand( uint32( rows >> ( ii * 8 ) ), color );
+            }
+            slot = key | m_next;
+            ++m_counters.uploads;
+            return m_next++;
+        }
+
+        ++m_counters.failures;
+        return 0;
+    }
+
+    [[nodiscard]]
+    bool holds( const uint32 index, const uint64 rows, const uint8 color ) const noexcept {
+        const auto * src = m_tiles + index * 8;
+        uint32 differ = 0;
+        for ( uint32 ii = 0; ii < 8; ++ii ) {
+            differ |= src[ii] ^ expand( uint32( rows >> ( ii * 8 ) ), color );
+        }
+        return differ == 0;
+    }
+
+    [[nodiscard]]
+    uint32 screen_index( const uint32 column, const uint32 row ) const noexcept {
+        const auto block = ( column / 32 ) + ( row / 32 ) * ( m_width / 32 );
+        return block * 1024 + ( row % 32 ) * 32 + ( column % 32 );
+    }
+
+    uint32 m_table[CacheSlots];
+    uint32 * m_tiles;
+    screen_tile * m_screen;
+    const font_1bpp * m_font;
+    uint32 m_startIndex;
+    uint32 m_tileCount;
+    uint32 m_next;
+    uint32 m_width;
+    uint32 m_height;
+    counters m_counters;
+};
+
+} // gba
+
+#endif // define GBAXX_DISPLAY_TEXT_RENDERER_HPP
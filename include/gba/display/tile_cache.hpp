@@ -0,0 +1,284 @@
+#ifndef GBAXX_DISPLAY_TILE_CACHE_HPP
+#define GBAXX_DISPLAY_TILE_CACHE_HPP
+
+#include <gba/allocator/tile_4bpp.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/screen_size.hpp>
+#include <gba/types/screen_tile.hpp>
+
+namespace gba {
+
+/**
+ * Virtual tile memory: keeps the 4bpp tiles in use resident in a fixed set of VRAM slots
+ *
+ * Each slot counts the screen entries referencing it. Slots nobody references stay resident, in least recently
+ * released order, until a miss needs one. Lookup, upload and eviction are all O(1).
+ * @tparam Slots VRAM tiles managed, such as the count passed to allocate_tile4bpp()
+ * @tparam WorldTiles number of distinct world tile ids
+ */
+template <unsigned Slots, unsigned WorldTiles = 1024>
+class tile_cache {
+    static_assert( Slots > 0 && Slots <= 1024, "tile_cache Slots must be between 1 and 1024" );
+    static_assert( WorldTiles <= 0xffff, "tile_cache WorldTiles must fit in 16 bits" );
+
+    static constexpr uint16 list_end = Slots;
+public:
+    static constexpr uint16 none = 0xffff;
+
+    using tile_data = uint32[8];
+
+    struct counters {
+        uint32 hits;
+        uint32 misses;
+        uint32 evictions;
+        uint32 failures;
+    };
+
+    tile_cache( buffer_tile4bpp& tiles, const tile_data * source ) noexcept : tile_cache( static_cast<uint32 *>( tiles.map() ), tiles.start_index(), source ) {}
+
+    /**
+     * @param vram first slot's tile data
+     * @param startIndex tile index of the first slot
+     * @param source tile graphics indexed by world tile id
+     */
+    constexpr tile_cache( uint32 * vram, const uint32 startIndex, const tile_data * source ) noexcept : m_slotOf {}, m_world {}, m_refs {}, m_prev {}, m_next {}, m_vram { vram }, m_source { source }, m_startIndex { startIndex }, m_counters {}, m_head { 0 }, m_tail { uint16( Slots - 1 ) } {
+        for ( auto& slot : m_slotOf ) {
+            slot = none;
+        }
+        for ( uint16 ii = 0; ii < Slots; ++ii ) {
+            m_world[ii] = none;
+            m_prev[ii] = ii ? uint16( ii - 1 ) : list_end;
+            m_next[ii] = ii + 1u < Slots ? uint16( ii + 1 ) : list_end;
+        }
+    }
+
+    /**
+     * Reference a world tile from one more screen entry, uploading it if it is not resident
+     * @return hardware tile index, or none if every slot is referenced
+     */
+    uint16 acquire( const uint32 world ) noexcept {
+        auto slot = m_slotOf[world];
+        if ( slot != none ) {
+            ++m_counters.hits;
+            if ( m_refs[slot]++ == 0 ) {
+                unlink( slot );
+            }
+            return uint16( m_startIndex + slot );
+        }
+
+        slot = m_head;
+        if ( slot == list_end ) {
+            ++m_counters.failures;
+            return none;
+        }
+
+        ++m_counters.misses;
+        unlink( slot );
+        if ( m_world[slot] != none ) {
+            ++m_counters.evictions;
+            m_slotOf[m_world[slot]] = none;
+        }
+
+        m_world[slot] = uint16( world );
+        m_slotOf[world] = slot;
+        m_refs[slot] = 1;
+        upload( slot, world );
+        return uint16( m_startIndex + slot );
+    }
+
+    /**
+     * Drop one screen entry's reference; the tile stays resident until evicted
+     */
+    void release( const uint32 world ) noexcept {
+        const auto slot = m_slotOf[world];
+        if ( slot == none || m_refs[slot] == 0 ) {
+            return;
+        }
+        if ( --m_refs[slot] == 0 ) {
+            append( slot );
+        }
+    }
+
+    /**
+     * @return hardware tile index of a resident world tile, or none
+     */
+    [[nodiscard]]
+    uint16 find( const uint32 world ) const noexcept {
+        const auto slot = m_slotOf[world];
+        return slot == none ? none : uint16( m_startIndex + slot );
+    }
+
+    [[nodiscard]]
+    uint32 references( const uint32 world ) const noexcept {
+        const auto slot = m_slotOf[world];
+        return slot == none ? 0 : m_refs[slot];
+    }
+
+    [[nodiscard]]
+    const counters& stats() const noexcept {
+        return m_counters;
+    }
+
+    void reset_counters() noexcept {
+        m_counters = counters {};
+    }
+
+private:
+    void upload( const uint16 slot, const uint32 world ) noexcept {
+        const auto& src = m_source[world];
+        auto * dest = m_vram + slot * 8;
+        for ( uint32 ii = 0; ii < 8; ++ii ) {
+            dest[ii] = src[ii];
+        }
+    }
+
+    void unlink( const uint16 slot ) noexcept {
+        const auto prev = m_prev[slot];
+        const auto next = m_next[slot];
+        ( prev == list_end ? m_head : m_next[prev] ) = next;
+        ( next == list_end ? m_tail : m_prev[next] ) = prev;
+    }
+
+    void append( const uint16 slot ) noexcept {
+        m_prev[slot] = m_tail;
+        m_next[slot] = list_end;
+        ( m_tail == list_end ? m_head : m_next[m_tail] ) = slot;
+        m_tail = slot;
+    }
+
+    uint16 m_slotOf[WorldTiles];
+    uint16 m_world[Slots];
+    uint16 m_refs[Slots];
+    uint16 m_prev[Slots];
+    uint16 m_next[Slots];
+    uint32 * m_vram;
+    const tile_data * m_source;
+    uint32 m_startIndex;
+    counters m_counters;
+    uint16 m_head;
+    uint16 m_tail;
+};
+
+/**
+ * World map of 16-bit world tile ids, for a cached_world
+ *
+ * A screen entry's tile_index has 10 bits, too few to name the tiles of a large world, so ids are kept apart from the
+ * flips and palette banks. Each attributes byte is the high byte of a screen entry: flip in bits 2 and 3, palette bank
+ * in bits 4 to 7. Without attributes every entry is unflipped, in palette bank 0.
+ */
+class tile_id_map {
+public:
+    /**
+     * @param ids world tile ids, row major
+     * @param attributes one byte per id, or nullptr
+     */
+    constexpr tile_id_map( const uint16 * ids, const uint8 * attributes, const uint32 width, const uint32 height ) noexcept : m_ids { ids }, m_attributes { attributes }, m_width { width }, m_height { height } {}
+
+    [[nodiscard]]
+    constexpr uint32 width() const noexcept {
+        return m_width;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 height() const noexcept {
+        return m_height;
+    }
+
+    [[nodiscard]]
+    constexpr uint16 id( const uint32 x, const uint32 y ) const noexcept {
+        return m_ids[y * m_width + x];
+    }
+
+    [[nodiscard]]
+    constexpr uint8 attributes( const uint32 x, const uint32 y ) const noexcept {
+        return m_attributes ? m_attributes[y * m_width + x] : 0;
+    }
+
+private:
+    const uint16 * m_ids;
+    const uint8 * m_attributes;
+    uint32 m_width;
+    uint32 m_height;
+};
+
+/**
+ * World source for tilemap_streamer that routes every screen entry through a tile_cache
+ *
+ * Keeps the world tile id of each screen block entry so that overwriting an entry releases its old tile. row() and
+ * column() acquire and release tiles, so they are not const.
+ * @tparam World tile_id_map, or any type with width(), height(), id() and attributes()
+ * @tparam Cache tile_cache
+ * @tparam Size the screen block layout given to the tilemap_streamer
+ */
+template <class World, class Cache, screen_size_regular Size = screen_size_regular::_32x32>
+class cached_world {
+    static constexpr uint32 ring_width = ( Size == screen_size_regular::_64x32 || Size == screen_size_regular::_64x64 ) ? 64 : 32;
+    static constexpr uint32 ring_height = ( Size == screen_size_regular::_32x64 || Size == screen_size_regular::_64x64 ) ? 64 : 32;
+public:
+    static constexpr uint16 empty = 0xffff;
+    static constexpr screen_size_regular screen_size = Size;
+
+    constexpr cached_world( const World& world, Cache& cache ) noexcept : m_world { &world }, m_cache { &cache }, m_shadow {} {
+        for ( auto& id : m_shadow ) {
+            id = empty;
+        }
+    }
+
+    [[nodiscard]]
+    constexpr uint32 width() const noexcept {
+        return m_world->width();
+    }
+
+    [[nodiscard]]
+    constexpr uint32 height() const noexcept {
+        return m_world->height();
+    }
+
+    void row( const uint32 x, const uint32 y, const uint32 count, screen_tile * output ) noexcept {
+        for ( uint32 ii = 0; ii < count; ++ii ) {
+            output[ii] = replace( x + ii, y );
+        }
+    }
+
+    void column( const uint32 x, const uint32 y, const uint32 count, screen_tile * output ) noexcept {
+        for ( uint32 ii = 0; ii < count; ++ii ) {
+            output[ii] = replace( x, y + ii );
+        }
+    }
+
+    /**
+     * World tile id held by the screen block entry for world tile (x, y), or empty
+     */
+    [[nodiscard]]
+    constexpr uint16 held( const uint32 x, const uint32 y ) const noexcept {
+        return m_shadow[( y % ring_height ) * ring_width + ( x % ring_width )];
+    }
+
+private:
+    screen_tile replace( const uint32 x, const uint32 y ) noexcept {
+        auto& held = m_shadow[( y % ring_height ) * ring_width + ( x % ring_width )];
+        const auto world = m_world->id( x, y );
+        if ( held != world ) {
+            if ( held != empty ) {
+                m_cache->release( held );
+            }
+            held = m_cache->acquire( world ) == Cache::none ? empty : world;
+        }
+
+        const auto index = m_cache->find( world );
+        const auto attributes = m_world->attributes( x, y );
+        return screen_tile {
+            uint16( index == Cache::none ? 0 : index ),
+            tile_flip( ( attributes >> 2 ) & 0x3 ),
+            uint16( attributes >> 4 )
+        };
+    }
+
+    const World * m_world;
+    Cache * m_cache;
+    uint16 m_shadow[ring_width * ring_height];
+};
+
+} // gba
+
+#endif // define GBAXX_DISPLAY_TILE_CACHE_HPP
@@ -0,0 +1,181 @@
+#ifndef GBAXX_DISPLAY_TILE_CONVERT_HPP
+#define GBAXX_DISPLAY_TILE_CONVERT_HPP
+
+#include <array>
+
+#include <gba/types/int_type.hpp>
+#include <gba/types/screen_tile.hpp>
+
+namespace gba {
+
+/**
+ * 24-bit 0xRRGGBB to the 15-bit BGR format of palette RAM, rounding to nearest
+ */
+constexpr uint16 rgb15( const uint32 rgb ) noexcept {
+    const auto channel = [rgb]( const uint32 shift ) noexcept {
+        const auto value = ( ( ( rgb >> shift ) & 0xff ) * 31 + 127 ) / 255;
+        return uint16( value );
+    };
+    return uint16( channel( 16 ) | channel( 8 ) << 5 | channel( 0 ) << 10 );
+}
+
+template <std::size_t N>
+constexpr std::array<uint16, N> make_palette( const std::array<uint32, N>& rgb ) noexcept {
+    std::array<uint16, N> palette {};
+    for ( std::size_t ii = 0; ii < N; ++ii ) {
+        palette[ii] = rgb15( rgb[ii] );
+    }
+    return palette;
+}
+
+enum class tile_dedup {
+    none, ///< one tile per map entry
+    exact, ///< identical tiles share one
+    flipped ///< also share tiles that match when mirrored, using screen_tile::flip
+};
+
+/**
+ * Tile data and screen map converted from an indexed image
+ * @tparam Bpp 4 or 8
+ * @tparam Tiles tiles in the image
+ */
+template <unsigned Bpp, unsigned Tiles>
+struct tileset {
+    static constexpr uint32 words_per_tile = Bpp * 2;
+
+    std::array<uint32, Tiles * words_per_tile> data; ///< the first count tiles are used
+    std::array<screen_tile, Tiles> map; ///< row major, tile_index relative to the first tile
+    uint32 count; ///< unique tiles; past 1024 the map cannot address them
+
+    [[nodiscard]]
+    constexpr uint32 size() const noexcept {
+        return count * words_per_tile * 4;
+    }
+
+    [[nodiscard]]
+    constexpr const uint32 * tile( const uint32 index ) const noexcept {
+        return data.data() + index * words_per_tile;
+    }
+};
+
+namespace detail {
+
+    using tile_pixels = std::array<uint8, 64>;
+
+    constexpr tile_pixels flip_tile( const tile_pixels& src, const uint32 flip ) noexcept {
+        tile_pixels out {};
+        for ( uint32 y = 0; y < 8; ++y ) {
+            for ( uint32 x = 0; x < 8; ++x ) {
+                const auto sx = flip & 1 ? 7 - x : x;
+                const auto sy = flip & 2 ? 7 - y : y;
+                out[y * 8 + x] = src[sy * 8 + sx];
+            }
+        }
+        return out;
+    }
+
+    constexpr bool same_tile( const tile_pixels& a, const tile_pixels& b ) noexcept {
+        for ( uint32 ii = 0; ii < 64; ++ii ) {
+            if ( a[ii] != b[ii] ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Unchanged by any flip, so it rejects most mismatches before comparing pixels
+    constexpr uint32 tile_signature( const tile_pixels& tile ) noexcept {
+        uint32 sum = 0;
+        uint32 mix = 0;
+        for ( uint32 ii = 0; ii < 64; ++ii ) {
+            sum += tile[ii];
+            mix += uint32( tile[ii] ) * tile[ii];
+        }
+        return sum | mix << 16;
+    }
+
+    // Deliberately not constexpr: reaching it while converting at compile time stops the build and names the problem
+    inline void tileset_exceeds_tile_index() noexcept {}
+
+} // detail
+
+/**
+ * Convert an indexed image to tiles and a screen map at compile time
+ *
+ * With 4bpp, each tile's palette bank is taken from its highest index and the low 4 bits of every pixel are stored,
+ * so the non-zero pixels of a tile must share one bank of 16. screen_tile::tile_index has 10 bits, so at most 1024
+ * unique tiles can be addressed: a compile time conversion that finds more fails to compile, and a run time one
+ * reports a count above 1024.
+ * @tparam Bpp 4 or 8
+ * @tparam Width image width in pixels, a multiple of 8
+ * @tparam Height image height in pixels, a multiple of 8
+ */
+template <unsigned Bpp, unsigned Width, unsigned Height>
+constexpr tileset<Bpp, ( Width / 8 ) * ( Height / 8 )> make_tileset( const std::array<uint8, Width * Height>& pixels, const tile_dedup dedup = tile_dedup::flipped ) noexcept {
+    static_assert( Bpp == 4 || Bpp == 8, "make_tileset Bpp must be 4 or 8" );
+    static_assert( Width % 8 == 0 && Height % 8 == 0, "make_tileset image must be a whole number of tiles" );
+
+    constexpr auto columns = Width / 8;
+    constexpr auto tiles = columns * ( Height / 8 );
+    using result_type = tileset<Bpp, tiles>;
+
+    result_type result {};
+    std::array<detail::tile_pixels, tiles> unique {};
+    std::array<uint32, tiles> signatures {};
+
+    for ( uint32 tt = 0; tt < tiles; ++tt ) {
+        detail::tile_pixels tile {};
+        uint8 highest = 0;
+        for ( uint32 y = 0; y < 8; ++y ) {
+            for ( uint32 x = 0; x < 8; ++x ) {
+                const auto value = pixels[( ( tt / columns ) * 8 + y ) * Width + ( tt % columns ) * 8 + x];
+                highest = value > highest ? value : highest;
+                tile[y * 8 + x] = Bpp == 4 ? uint8( value & 0xf ) : value;
+            }
+        }
+
+        auto& entry = result.map[tt];
+        entry.palette_bank = Bpp == 4 ? uint16( highest >> 4 ) : 0;
+
+        const auto signature = detail::tile_signature( tile );
+        const auto variants = dedup == tile_dedup::flipped ? 4u : dedup == tile_dedup::exact ? 1u : 0u;
+        bool found = false;
+        for ( uint32 ff = 0; ff < variants && !found; ++ff ) {
+            const auto flipped = detail::flip_tile( tile, ff );
+            for ( uint32 uu = 0; uu < result.count; ++uu ) {
+                if ( signatures[uu] == signature && detail::same_tile( unique[uu], flipped ) ) {
+                    entry.tile_index = uint16( uu );
+                    entry.flip = tile_flip( ff );
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if ( found ) {
+            continue;
+        }
+
+        const auto index = result.count++;
+        if ( index > 0x3ff ) {
+            detail::tileset_exceeds_tile_index();
+        }
+        unique[index] = tile;
+        signatures[index] = signature;
+        entry.tile_index = uint16( index );
+        entry.flip = tile_flip::none;
+
+        auto * words = result.data.data() + index * result_type::words_per_tile;
+        for ( uint32 ii = 0; ii < 64; ++ii ) {
+            if constexpr ( Bpp == 4 ) {
+                words[ii / 8] |= uint32( tile[ii] ) << ( ( ii % 8 ) * 4 );
+            } else {
+                words[ii / 4] |= uint32( tile[ii] ) << ( ( ii % 4 ) * 8 );
+            }
+        }
+    }
+    return result;
+}
+
+} // gba
+
+#endif // define GBAXX_DISPLAY_TILE_CONVERT_HPP
@@ -0,0 +1,309 @@
+#ifndef GBAXX_DISPLAY_TILEMAP_STREAMER_HPP
+#define GBAXX_DISPLAY_TILEMAP_STREAMER_HPP
+
+#include <gba/allocator/screen_regular.hpp>
+#include <gba/dma/dma3_copy.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/screen_size.hpp>
+#include <gba/types/screen_tile.hpp>
+
+namespace gba {
+
+/**
+ * Uncompressed world map, row major
+ */
+class world_map {
+public:
+    constexpr world_map( const screen_tile * tiles, const uint32 width, const uint32 height ) noexcept : m_tiles { tiles }, m_width { width }, m_height { height } {}
+
+    [[nodiscard]]
+    constexpr uint32 width() const noexcept {
+        return m_width;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 height() const noexcept {
+        return m_height;
+    }
+
+    constexpr void row( const uint32 x, const uint32 y, const uint32 count, screen_tile * output ) const noexcept {
+        const auto * src = m_tiles + y * m_width + x;
+        for ( uint32 ii = 0; ii < count; ++ii ) {
+            output[ii] = src[ii];
+        }
+    }
+
+    constexpr void column( const uint32 x, const uint32 y, const uint32 count, screen_tile * output ) const noexcept {
+        const auto * src = m_tiles + y * m_width + x;
+        for ( uint32 ii = 0; ii < count; ++ii ) {
+            output[ii] = src[ii * m_width];
+        }
+    }
+
+private:
+    const screen_tile * m_tiles;
+    uint32 m_width;
+    uint32 m_height;
+};
+
+/**
+ * World map compressed as 2x2 metatiles, each map entry indexing a table of four screen entries
+ *
+ * Random access is kept, so rows and columns decode without touching the rest of the map.
+ */
+class metatile_world_map {
+public:
+    using metatile = screen_tile[4];
+
+    /**
+     * @param map metatile indices, row major
+     * @param width map width in metatiles
+     * @param height map height in metatiles
+     * @param metatiles top left, top right, bottom left, bottom right entries of each metatile
+     */
+    constexpr metatile_world_map( const uint16 * map, const uint32 width, const uint32 height, const metatile * metatiles ) noexcept : m_map { map }, m_metatiles { metatiles }, m_width { width }, m_height { height } {}
+
+    [[nodiscard]]
+    constexpr uint32 width() const noexcept {
+        return m_width * 2;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 height() const noexcept {
+        return m_height * 2;
+    }
+
+    constexpr void row( const uint32 x, const uint32 y, const uint32 count, screen_tile * output ) const noexcept {
+        for ( uint32 ii = 0; ii < count; ++ii ) {
+            output[ii] = at( x + ii, y );
+        }
+    }
+
+    constexpr void column( const uint32 x, const uint32 y, const uint32 count, screen_tile * output ) const noexcept {
+        for ( uint32 ii = 0; ii < count; ++ii ) {
+            output[ii] = at( x, y + ii );
+        }
+    }
+
+private:
+    [[nodiscard]]
+    constexpr screen_tile at( const uint32 x, const uint32 y ) const noexcept {
+        return m_metatiles[m_map[( y / 2 ) * m_width + x / 2]][( y & 1 ) * 2 + ( x & 1 )];
+    }
+
+    const uint16 * m_map;
+    const metatile * m_metatiles;
+    uint32 m_width;
+    uint32 m_height;
+};
+
+/**
+ * Streams a world map larger than the screen block into a ring-wrapped regular background
+ *
+ * The screen block holds world tile (x, y) at (x mod width, y mod height), so scrolling only exposes one row or
+ * column per 8 pixels moved. update() writes just those, rows as contiguous runs through Copy and columns with strided
+ * CPU stores, since DMA cannot skip between entries. Set the background offsets to scroll_x() and scroll_y().
+ * @tparam World world_map, metatile_world_map, cached_world or any type with width(), height(), row() and column();
+ *         may be const qualified
+ * @tparam Copy copies contiguous runs of entries; dma3_copy, or cpu_copy off-hardware
+ */
+template <class World, class Copy = dma3_copy>
+class tilemap_streamer {
+public:
+    static constexpr uint32 view_columns = 31;
+    static constexpr uint32 view_rows = 21;
+
+    tilemap_streamer( World& world, buffer_screen_regular& screen ) noexcept : tilemap_streamer( world, screen.map(), screen.screen_size() ) {}
+
+    constexpr tilemap_streamer( World& world, screen_tile * screen, const screen_size_regular size ) noexcept : m_world { &world }, m_screen { screen }, m_ringWidth { ( size == screen_size_regular::_64x32 || size == screen_size_regular::_64x64 ) ? 64u : 32u },
+        m_ringHeight { ( size == screen_size_regular::_32x64 || size == screen_size_regular::_64x64 ) ? 64u : 32u }, m_x {}, m_y {}, m_tileX {}, m_tileY {}, m_written {}, m_peak {}, m_valid {} {}
+
+    /**
+     * Move the camera, clamped to the world; nothing is written until update()
+     * @param x left edge in pixels
+     * @param y top edge in pixels
+     */
+    constexpr void scroll_to( const int32 x, const int32 y ) noexcept {
+        m_x = clamp( x, m_world->width() * 8, screen_width );
+        m_y = clamp( y, m_world->height() * 8, screen_height );
+    }
+
+    /**
+     * Redraw the whole view on the next update()
+     */
+    constexpr void invalidate() noexcept {
+        m_valid = false;
+    }
+
+    /**
+     * Write the entries exposed since the last update; call during VBlank
+     * @return entries written
+     */
+    constexpr uint32 update() noexcept {
+        const auto tileX = m_x / 8;
+        const auto tileY = m_y / 8;
+        const auto columns = visible_columns();
+        const auto rows = visible_rows();
+
+        m_written = 0;
+        const auto dx = int32( tileX - m_tileX );
+        const auto dy = int32( tileY - m_tileY );
+        if ( !m_valid || abs( dx ) >= int32( columns ) || abs( dy ) >= int32( rows ) ) {
+            for ( uint32 ii = 0; ii < rows; ++ii ) {
+                write_row( tileX, tileY + ii, columns );
+            }
+        } else {
+            // Columns span the new rows and rows span the new columns, so corners are covered either way
+            if ( dx > 0 ) {
+                for ( auto x = m_tileX + columns; x < tileX + columns; ++x ) {
+                    write_column( x, tileY, rows );
+                }
+            } else {
+                for ( auto x = tileX; x < m_tileX; ++x ) {
+                    write_column( x, tileY, rows );
+                }
+            }
+
+            if ( dy > 0 ) {
+                for ( auto y = m_tileY + rows; y < tileY + rows; ++y ) {
+                    write_row( tileX, y, columns );
+                }
+            } else {
+                for ( auto y = tileY; y < m_tileY; ++y ) {
+                    write_row( tileX, y, columns );
+                }
+            }
+        }
+
+        m_tileX = tileX;
+        m_tileY = tileY;
+        m_valid = true;
+        m_peak = m_written > m_peak ? m_written : m_peak;
+        return m_written;
+    }
+
+    /**
+     * Background horizontal offset for the current camera
+     */
+    [[nodiscard]]
+    constexpr uint16 scroll_x() const noexcept {
+        return uint16( m_x & ( m_ringWidth * 8 - 1 ) );
+    }
+
+    [[nodiscard]]
+    constexpr uint16 scroll_y() const noexcept {
+        return uint16( m_y & ( m_ringHeight * 8 - 1 ) );
+    }
+
+    [[nodiscard]]
+    constexpr uint32 camera_x() const noexcept {
+        return m_x;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 camera_y() const noexcept {
+        return m_y;
+    }
+
+    /**
+     * Entries written by the last update()
+     */
+    [[nodiscard]]
+    constexpr uint32 last_written() const noexcept {
+        return m_written;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 peak_written() const noexcept {
+        return m_peak;
+    }
+
+    /**
+     * Screen block entry holding world tile (x, y)
+     */
+    [[nodiscard]]
+    constexpr uint32 ring_index( const uint32 x, const uint32 y ) const noexcept {
+        const auto cx = x % m_ringWidth;
+        const auto cy = y % m_ringHeight;
+        const auto block = ( cx / 32 ) + ( cy / 32 ) * ( m_ringWidth / 32 );
+        return block * 1024 + ( cy % 32 ) * 32 + ( cx % 32 );
+    }
+
+private:
+    static constexpr uint32 screen_width = 240;
+    static constexpr uint32 screen_height = 160;
+
+    [[nodiscard]]
+    static constexpr int32 abs( const int32 value ) noexcept {
+        return value < 0 ? -value : value;
+    }
+
+    [[nodiscard]]
+    static constexpr uint32 clamp( const int32 value, const uint32 worldPixels, const uint32 viewPixels ) noexcept {
+        if ( value < 0 || worldPixels <= viewPixels ) {
+            return 0;
+        }
+        return uint32( value ) > worldPixels - viewPixels ? worldPixels - viewPixels : uint32( value );
+    }
+
+    [[nodiscard]]
+    constexpr uint32 visible_columns() const noexcept {
+        return m_world->width() < view_columns ? m_world->width() : view_columns;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 visible_rows() const noexcept {
+        return m_world->height() < view_rows ? m_world->height() : view_rows;
+    }
+
+    // Runs split where the ring wraps and where 64 wide layouts cross into the next screen block
+    constexpr void write_row( const uint32 x, const uint32 y, uint32 count ) noexcept {
+        if ( y >= m_world->height() || x >= m_world->width() ) {
+            return;
+        }
+        count = x + count > m_world->width() ? m_world->width() - x : count;
+
+        screen_tile line[view_columns] {};
+        m_world->row( x, y, count, line );
+
+        uint32 done = 0;
+        while ( done < count ) {
+            const auto cx = ( x + done ) % m_ringWidth;
+            const auto run = 32 - ( cx % 32 ) < count - done ? 32 - ( cx % 32 ) : count - done;
+            Copy::copy( line + done, m_screen + ring_index( x + done, y ), run );
+            done += run;
+        }
+        m_written += count;
+    }
+
+    constexpr void write_column( const uint32 x, const uint32 y, uint32 count ) noexcept {
+        if ( x >= m_world->width() || y >= m_world->height() ) {
+            return;
+        }
+        count = y + count > m_world->height() ? m_world->height() - y : count;
+
+        screen_tile line[view_rows] {};
+        m_world->column( x, y, count, line );
+
+        for ( uint32 ii = 0; ii < count; ++ii ) {
+            m_screen[ring_index( x, y + ii )] = line[ii];
+        }
+        m_written += count;
+    }
+
+    World * m_world;
+    screen_tile * m_screen;
+    uint32 m_ringWidth;
+    uint32 m_ringHeight;
+    uint32 m_x;
+    uint32 m_y;
+    uint32 m_tileX;
+    uint32 m_tileY;
+    uint32 m_written;
+    uint32 m_peak;
+    bool m_valid;
+};
+
+} // gba
+
+#endif // define GBAXX_DISPLAY_TILEMAP_STREAMER_HPP
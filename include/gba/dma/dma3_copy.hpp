@@ -0,0 +1,42 @@
+#ifndef GBAXX_DMA_DMA3_COPY_HPP
+#define GBAXX_DMA_DMA3_COPY_HPP
+
+#include <gba/dma/dma_control.hpp>
+#include <gba/registers/dma.hpp>
+#include <gba/types/int_cast.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+
+/**
+ * Copy policy: a run of words or halfwords with one DMA3 transfer, sized by the element type
+ */
+struct dma3_copy {
+    template <typename Type, typename Dest>
+    static void copy( const Type * src, Dest * dest, const uint32 count ) noexcept {
+        static_assert( sizeof( Type ) == 4 || sizeof( Type ) == 2, "dma3_copy copies words or halfwords" );
+        reg::dma3cnt_h::write( {} );
+        reg::dma3sad::write( address_cast( src ) );
+        reg::dma3dad::write( address_cast( dest ) );
+        reg::dma3cnt::write( {
+            .transfers = uint16( count ),
+            .control = { .type = sizeof( Type ) == 4 ? dma_control::type::word : dma_control::type::half, .enable = true }
+        } );
+    }
+};
+
+/**
+ * Copy policy: the same runs as dma3_copy with the CPU, for off-hardware simulation
+ */
+struct cpu_copy {
+    template <typename Type, typename Dest>
+    static constexpr void copy( const Type * src, Dest * dest, const uint32 count ) noexcept {
+        for ( uint32 ii = 0; ii < count; ++ii ) {
+            dest[ii] = src[ii];
+        }
+    }
+};
+
+} // gba
+
+#endif // define GBAXX_DMA_DMA3_COPY_HPP
@@ -10,6 +10,7 @@
 #include <gba/ext/agbabi/memcpy.hpp>
 #include <gba/ext/agbabi/pull_coroutine.hpp>
 #include <gba/ext/agbabi/push_coroutine.hpp>
+#include <gba/ext/agbabi/scheduler.hpp>
 
 #else
 #error __agb_abi not defined
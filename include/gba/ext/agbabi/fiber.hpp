@@ -2,6 +2,12 @@
 #define GBAXX_EXT_AGBABI_FIBER_HPP
 #if defined( __agb_abi )
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
 #include <sys/ucontext.h>
 
 extern "C" {
@@ -17,20 +23,25 @@ namespace gba {
 namespace agbabi {
 namespace detail {
 
+// Bytes kept free below the stack objects for the link pointer and the entry call frame
+constexpr std::size_t stack_reserve = 128;
+
 template <typename Type, typename... Args>
 Type * stack_emplace( stack_t& stack, Args... args ) noexcept {
-    auto * stackEnd = reinterpret_cast<char *>( stack.ss_sp ) + stack.ss_size;
-    stackEnd -= sizeof( Type );
-    stack.ss_size -= sizeof( Type );
-    return new ( stackEnd ) Type( std::forward<Args>( args )... );
+    const auto stackBegin = reinterpret_cast<std::uintptr_t>( stack.ss_sp );
+    const auto stackEnd = ( stackBegin + stack.ss_size - sizeof( Type ) ) & ~std::uintptr_t( alignof( Type ) - 1 );
+    stack.ss_size = stackEnd - stackBegin;
+    return new ( reinterpret_cast<void *>( stackEnd ) ) Type( std::forward<Args>( args )... );
 }
 
 template <typename Type>
-Type * stack_put( stack_t& stack, const Type& type ) noexcept {
-    auto * stackEnd = reinterpret_cast<char *>( stack.ss_sp ) + stack.ss_size;
-    stackEnd -= sizeof( type );
-    stack.ss_size -= sizeof( type );
-    return new ( stackEnd ) Type( type );
+void stack_destroy( void * object ) noexcept {
+    static_cast<Type *>( object )->~Type();
+}
+
+template <typename... Types>
+constexpr std::size_t stack_requirement() noexcept {
+    return ( ( sizeof( Types ) + alignof( Types ) - 1 ) + ... ) + stack_reserve;
 }
 
 inline void stack_set_link( stack_t& stack, const ucontext_t& link ) noexcept {
@@ -42,6 +53,26 @@ inline void stack_set_link( stack_t& stack, const ucontext_t& link ) noexcept {
 
 } // detail
 
+/**
+ * Statically sized stack storage
+ *
+ * Constructing a fiber or coroutine from a fiber_stack checks at compile-time that it fits the control object and callable.
+ * @tparam Size bytes of stack
+ */
+template <std::size_t Size>
+class alignas( 8 ) fiber_stack {
+public:
+    static constexpr std::size_t size = Size;
+
+    [[nodiscard]]
+    operator stack_t() noexcept {
+        return stack_t { m_data, 0, Size };
+    }
+
+private:
+    char m_data[Size];
+};
+
 class fiber {
 private:
     class yield_type {
@@ -68,27 +99,33 @@ public:
     fiber( const fiber& ) = delete;
     fiber& operator =( const fiber& ) = delete;
 
-    fiber( const stack_t& stack, function_type&& function ) noexcept : m_context { &m_link, stack, {} } {
-        // Allocate space in our stack for control object and call function
-        m_yield = detail::stack_emplace<yield_type>( m_context.uc_stack, this );
-        auto * const functionOnStack = detail::stack_put( m_context.uc_stack, function );
-        const auto callFunc = reinterpret_cast<void( * )( void )>( call );
+    fiber( const stack_t& stack, function_type&& function ) noexcept : fiber( std::in_place, stack, std::move( function ) ) {}
 
-        __agbabi_makecontext( &m_context, callFunc, 2, std::ref( *m_yield ), std::ref( *functionOnStack ) );
-        m_start = m_context.uc_mcontext;
+    /**
+     * Construct with any callable, moved onto the fiber stack without type erasure
+     */
+    template <class Function, typename = std::enable_if_t<std::is_invocable_v<Function&, yield_type&>>>
+    fiber( const stack_t& stack, Function function ) noexcept : fiber( std::in_place, stack, std::move( function ) ) {}
+
+    template <std::size_t Size, class Function, typename = std::enable_if_t<std::is_invocable_v<Function&, yield_type&>>>
+    fiber( fiber_stack<Size>& stack, Function function ) noexcept : fiber( std::in_place, stack, std::move( function ) ) {
+        static_assert( Size >= detail::stack_requirement<yield_type, Function>(), "fiber_stack too small for fiber" );
     }
 
-    fiber( fiber&& other ) noexcept : m_context { other.m_context }, m_link { other.m_link }, m_start { other.m_start }, m_yield { other.m_yield } {
+    fiber( fiber&& other ) noexcept : m_context { other.m_context }, m_link { other.m_link }, m_start { other.m_start }, m_yield { other.m_yield },
+                                      m_function { other.m_function }, m_destroy { other.m_destroy } {
         other.m_context = {};
         other.m_link = {};
         other.m_start = {};
         other.m_yield = nullptr;
+        other.m_function = nullptr;
         m_yield->m_owner = this;
         detail::stack_set_link( m_context.uc_stack, m_link );
     }
 
     ~fiber() noexcept {
         if ( m_yield ) {
+            m_destroy( m_function );
             m_yield->~yield_type();
         }
     }
@@ -104,11 +141,26 @@ public:
         return m_yield->m_hasYielded;
     }
 private:
+    template <class Function>
+    fiber( std::in_place_t, const stack_t& stack, Function&& function ) noexcept : m_context { &m_link, stack, {} } {
+        // Allocate space in our stack for control object and call function
+        m_yield = detail::stack_emplace<yield_type>( m_context.uc_stack, this );
+        auto * const functionOnStack = detail::stack_emplace<Function>( m_context.uc_stack, std::move( function ) );
+        const auto callFunc = reinterpret_cast<void( * )( void )>( call<Function> );
+
+        m_function = functionOnStack;
+        m_destroy = detail::stack_destroy<Function>;
+
+        __agbabi_makecontext( &m_context, callFunc, 2, std::ref( *m_yield ), std::ref( *functionOnStack ) );
+        m_start = m_context.uc_mcontext;
+    }
+
     void reset() noexcept {
         m_context.uc_mcontext = m_start;
     }
 
-    static void call( yield_type& yield, function_type& function ) noexcept {
+    template <class Function>
+    static void call( yield_type& yield, Function& function ) noexcept {
         function( yield );
         yield.m_owner->reset();
     }
@@ -117,6 +169,8 @@ private:
     ucontext_t m_link;
     mcontext_t m_start;
     yield_type * m_yield;
+    void * m_function;
+    void ( * m_destroy )( void * );
 };
 
 } // agbabi
@@ -2,6 +2,10 @@
 #define GBAXX_EXT_AGBABI_PULL_COROUTINE_HPP
 #if defined( __agb_abi )
 
+#include <optional>
+#include <type_traits>
+#include <utility>
+
 #include <gba/ext/agbabi/fiber.hpp>
 
 namespace gba {
@@ -95,27 +99,30 @@ public:
     pull_coroutine( const pull_coroutine& ) = delete;
     pull_coroutine& operator =( const pull_coroutine& ) = delete;
 
-    pull_coroutine( const stack_t& stack, function_type&& function ) noexcept : m_context { &m_link, stack, {} } {
-        // Allocate space in our stack for control object and call function
-        m_push = detail::stack_emplace<push_type>( m_context.uc_stack, this );
-        auto * const functionOnStack = detail::stack_put( m_context.uc_stack, function );
-        const auto callFunc = reinterpret_cast<void( * )( void )>( call );
+    pull_coroutine( const stack_t& stack, function_type&& function ) noexcept : pull_coroutine( std::in_place, stack, std::move( function ) ) {}
 
-        __agbabi_makecontext( &m_context, callFunc, 2, std::ref( *m_push ), std::ref( *functionOnStack ) );
-        m_start = m_context.uc_mcontext;
+    template <class Function, typename = std::enable_if_t<std::is_invocable_v<Function&, push_type&>>>
+    pull_coroutine( const stack_t& stack, Function function ) noexcept : pull_coroutine( std::in_place, stack, std::move( function ) ) {}
+
+    template <std::size_t Size, class Function, typename = std::enable_if_t<std::is_invocable_v<Function&, push_type&>>>
+    pull_coroutine( fiber_stack<Size>& stack, Function function ) noexcept : pull_coroutine( std::in_place, stack, std::move( function ) ) {
+        static_assert( Size >= detail::stack_requirement<push_type, Function>(), "fiber_stack too small for pull_coroutine" );
     }
 
-    pull_coroutine( pull_coroutine&& other ) noexcept : m_context { other.m_context }, m_link { other.m_link }, m_start { other.m_start }, m_push { other.m_push } {
+    pull_coroutine( pull_coroutine&& other ) noexcept : m_context { other.m_context }, m_link { other.m_link }, m_start { other.m_start }, m_push { other.m_push },
+                                                        m_function { other.m_function }, m_destroy { other.m_destroy } {
         other.m_context = {};
         other.m_link = {};
         other.m_start = {};
         other.m_push = nullptr;
+        other.m_function = nullptr;
         m_push->m_pull = this;
         detail::stack_set_link( m_context.uc_stack, m_link );
     }
 
     ~pull_coroutine() noexcept {
         if ( m_push ) {
+            m_destroy( m_function );
             m_push->~push_type();
         }
     }
@@ -145,11 +152,26 @@ public:
         return {};
     }
 private:
+    template <class Function>
+    pull_coroutine( std::in_place_t, const stack_t& stack, Function&& function ) noexcept : m_context { &m_link, stack, {} } {
+        // Allocate space in our stack for control object and call function
+        m_push = detail::stack_emplace<push_type>( m_context.uc_stack, this );
+        auto * const functionOnStack = detail::stack_emplace<Function>( m_context.uc_stack, std::move( function ) );
+        const auto callFunc = reinterpret_cast<void( * )( void )>( call<Function> );
+
+        m_function = functionOnStack;
+        m_destroy = detail::stack_destroy<Function>;
+
+        __agbabi_makecontext( &m_context, callFunc, 2, std::ref( *m_push ), std::ref( *functionOnStack ) );
+        m_start = m_context.uc_mcontext;
+    }
+
     void reset() noexcept {
         m_context.uc_mcontext = m_start;
     }
 
-    static void call( push_type& push, function_type& function ) noexcept {
+    template <class Function>
+    static void call( push_type& push, Function& function ) noexcept {
         function( push );
         push.m_value.reset();
         push.m_pull->reset();
@@ -159,6 +181,8 @@ private:
     ucontext_t m_link;
     mcontext_t m_start;
     push_type * m_push;
+    void * m_function;
+    void ( * m_destroy )( void * );
 };
 
 } // agbabi
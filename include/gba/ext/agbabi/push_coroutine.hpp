@@ -2,6 +2,10 @@
 #define GBAXX_EXT_AGBABI_PUSH_COROUTINE_HPP
 #if defined( __agb_abi )
 
+#include <optional>
+#include <type_traits>
+#include <utility>
+
 #include <gba/ext/agbabi/fiber.hpp>
 
 namespace gba {
@@ -109,27 +113,30 @@ public:
     push_coroutine( const push_coroutine& ) = delete;
     push_coroutine& operator =( const push_coroutine& ) = delete;
 
-    push_coroutine( const stack_t& stack, function_type&& function ) noexcept : m_context { &m_link, stack, {} } {
-        // Allocate space in our stack for control object and call function
-        m_pull = detail::stack_emplace<pull_type>( m_context.uc_stack, this );
-        auto * const functionOnStack = detail::stack_put( m_context.uc_stack, function );
-        const auto callFunc = reinterpret_cast<void( * )( void )>( call );
+    push_coroutine( const stack_t& stack, function_type&& function ) noexcept : push_coroutine( std::in_place, stack, std::move( function ) ) {}
 
-        __agbabi_makecontext( &m_context, callFunc, 2, std::ref( *m_pull ), std::ref( *functionOnStack ) );
-        m_start = m_context.uc_mcontext;
+    template <class Function, typename = std::enable_if_t<std::is_invocable_v<Function&, pull_type&>>>
+    push_coroutine( const stack_t& stack, Function function ) noexcept : push_coroutine( std::in_place, stack, std::move( function ) ) {}
+
+    template <std::size_t Size, class Function, typename = std::enable_if_t<std::is_invocable_v<Function&, pull_type&>>>
+    push_coroutine( fiber_stack<Size>& stack, Function function ) noexcept : push_coroutine( std::in_place, stack, std::move( function ) ) {
+        static_assert( Size >= detail::stack_requirement<pull_type, Function>(), "fiber_stack too small for push_coroutine" );
     }
 
-    push_coroutine( push_coroutine&& other ) noexcept : m_context { other.m_context }, m_link { other.m_link }, m_start { other.m_start }, m_pull { other.m_pull } {
+    push_coroutine( push_coroutine&& other ) noexcept : m_context { other.m_context }, m_link { other.m_link }, m_start { other.m_start }, m_pull { other.m_pull },
+                                                        m_function { other.m_function }, m_destroy { other.m_destroy } {
         other.m_context = {};
         other.m_link = {};
         other.m_start = {};
         other.m_pull = nullptr;
+        other.m_function = nullptr;
         m_pull->m_push = this;
         detail::stack_set_link( m_context.uc_stack, m_link );
     }
 
     ~push_coroutine() noexcept {
         if ( m_pull ) {
+            m_destroy( m_function );
             m_pull->~pull_type();
         }
     }
@@ -159,6 +166,20 @@ public:
         return !m_pull->m_value.has_value();
     }
 private:
+    template <class Function>
+    push_coroutine( std::in_place_t, const stack_t& stack, Function&& function ) noexcept : m_context { &m_link, stack, {} } {
+        // Allocate space in our stack for control object and call function
+        m_pull = detail::stack_emplace<pull_type>( m_context.uc_stack, this );
+        auto * const functionOnStack = detail::stack_emplace<Function>( m_context.uc_stack, std::move( function ) );
+        const auto callFunc = reinterpret_cast<void( * )( void )>( call<Function> );
+
+        m_function = functionOnStack;
+        m_destroy = detail::stack_destroy<Function>;
+
+        __agbabi_makecontext( &m_context, callFunc, 2, std::ref( *m_pull ), std::ref( *functionOnStack ) );
+        m_start = m_context.uc_mcontext;
+    }
+
     bool is_initialized() const noexcept {
         // Points to call method
         return m_context.uc_mcontext.arm_pc == m_start.arm_pc;
@@ -168,7 +189,8 @@ private:
         m_context.uc_mcontext = m_start;
     }
 
-    static void call( pull_type& pull, function_type& function ) noexcept {
+    template <class Function>
+    static void call( pull_type& pull, Function& function ) noexcept {
         function( pull );
         pull.m_push->reset();
     }
@@ -177,6 +199,8 @@ private:
     ucontext_t m_link;
     mcontext_t m_start;
     pull_type * m_pull;
+    void * m_function;
+    void ( * m_destroy )( void * );
 };
 
 } // agbabi
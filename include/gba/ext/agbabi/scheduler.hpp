@@ -0,0 +1,194 @@
+#ifndef GBAXX_EXT_AGBABI_SCHEDULER_HPP
+#define GBAXX_EXT_AGBABI_SCHEDULER_HPP
+#if defined( __agb_abi )
+
+#include <optional>
+#include <type_traits>
+
+#include <gba/ext/agbabi/fiber.hpp>
+#include <gba/registers/display.hpp>
+#include <gba/task/interrupt_wait.hpp>
+#include <gba/task/scheduler_core.hpp>
+#include <gba/types/cycles.hpp>
+#include <gba/types/int_cast.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/interrupt_mask.hpp>
+
+namespace gba {
+namespace agbabi {
+
+/**
+ * Frame-relative cycle clock with scanline (1232 cycle) resolution; does not occupy a timer
+ */
+struct vcount_clock {
+    static constexpr uint32 period = cycles_per_frame.count();
+
+    [[nodiscard]]
+    static uint32 now() noexcept {
+        return reg::vcount::read() * cycles_per_scanline.count();
+    }
+};
+
+/**
+ * Cooperative scheduler owning a pool of fibers with statically allocated stacks
+ *
+ * Tasks are resumed once per frame in priority order until the cycle budget is used, then the scheduler idles in
+ * task::intr_wait() until VBlank or an interrupt a task is waiting on. The interrupt handler must acknowledge REG_IFBIOS.
+ * @tparam Capacity maximum number of tasks
+ * @tparam StackSize bytes of stack per task
+ * @tparam Clock cycle clock used to charge tasks against the budget
+ */
+template <unsigned Capacity, unsigned StackSize, class Clock = vcount_clock>
+class scheduler {
+    static_assert( StackSize % 8 == 0, "scheduler StackSize must be a multiple of 8" );
+
+    using core_type = task::scheduler_core<Capacity>;
+public:
+    static constexpr int none = core_type::none;
+
+    class context {
+        friend scheduler;
+    public:
+        /**
+         * Suspend until the next frame
+         */
+        void yield() noexcept {
+            m_owner->m_core.sleep( m_id, 1 );
+            m_resume( m_yield );
+        }
+
+        void sleep( const uint32 frames ) noexcept {
+            m_owner->m_core.sleep( m_id, frames );
+            m_resume( m_yield );
+        }
+
+        /**
+         * Suspend until any of the interrupts in mask are raised
+         * @return the interrupts that woke this task
+         */
+        interrupt_mask wait( const interrupt_mask mask ) noexcept {
+            m_owner->m_core.wait( m_id, uint_cast( mask ) );
+            m_resume( m_yield );
+            return make_interrupt_mask( m_owner->m_core.raised_mask( m_id ) );
+        }
+
+        [[nodiscard]]
+        int id() const noexcept {
+            return m_id;
+        }
+
+        [[nodiscard]]
+        uint32 frame() const noexcept {
+            return m_owner->m_core.frame();
+        }
+
+    private:
+        context( scheduler * owner, const int id, void * yield, void ( * resume )( void * ) ) noexcept : m_owner { owner }, m_id { id }, m_yield { yield }, m_resume { resume } {}
+
+        scheduler * m_owner;
+        int m_id;
+        void * m_yield;
+        void ( * m_resume )( void * );
+    };
+
+    scheduler( const scheduler& ) = delete;
+    scheduler& operator =( const scheduler& ) = delete;
+
+    scheduler() noexcept : m_core {}, m_budget { core_type::unlimited } {}
+
+    /**
+     * Start a task
+     * @param function callable invoked as function( context& )
+     * @param priority lower values are resumed first
+     * @return task id, or none if the pool is full
+     */
+    template <class Function>
+    int spawn( Function function, const uint8 priority = 0 ) noexcept {
+        const auto id = m_core.spawn( priority );
+        if ( id == none ) {
+            return none;
+        }
+
+        m_fibers[id].emplace( m_stacks[id], [this, id, function]( auto& yield ) mutable {
+            using yield_type = std::remove_reference_t<decltype( yield )>;
+
+            context ctx( this, id, &yield, resume_thunk<yield_type> );
+            function( ctx );
+        } );
+        return id;
+    }
+
+    void kill( const int id ) noexcept {
+        m_fibers[id].reset();
+        m_core.kill( id );
+    }
+
+    /**
+     * Cycles that may be spent resuming tasks each frame
+     */
+    void set_budget( const cycles_type budget ) noexcept {
+        m_budget = budget.count();
+    }
+
+    /**
+     * Run one frame's time slice, returning once VBlank has been raised
+     */
+    void run_frame() noexcept {
+        constexpr auto vblankMask = uint16( 1 );
+
+        m_core.begin_frame( m_budget );
+        while ( true ) {
+            for ( auto id = m_core.next(); id != none; id = m_core.next() ) {
+                resume( id );
+            }
+
+            const auto raised = task::intr_wait( m_core.wait_mask() | vblankMask );
+            m_core.signal( raised );
+            if ( raised & vblankMask ) {
+                m_core.tick();
+                return;
+            }
+        }
+    }
+
+    [[noreturn]]
+    void run() noexcept {
+        while ( true ) {
+            run_frame();
+        }
+    }
+
+    [[nodiscard]]
+    const core_type& core() const noexcept {
+        return m_core;
+    }
+
+private:
+    template <class Yield>
+    static void resume_thunk( void * yield ) noexcept {
+        ( *static_cast<Yield *>( yield ) )();
+    }
+
+    void resume( const int id ) noexcept {
+        auto& f = *m_fibers[id];
+
+        const auto start = Clock::now();
+        f();
+        m_core.charge( id, ( Clock::now() + Clock::period - start ) % Clock::period );
+
+        if ( !f ) {
+            kill( id );
+        }
+    }
+
+    fiber_stack<StackSize> m_stacks[Capacity];
+    std::optional<fiber> m_fibers[Capacity];
+    core_type m_core;
+    uint32 m_budget;
+};
+
+} // agbabi
+} // gba
+
+#endif // __agb_abi
+#endif // define GBAXX_EXT_AGBABI_SCHEDULER_HPP
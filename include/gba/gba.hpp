@@ -55,13 +55,29 @@
 #include <gba/bios/swi.hpp>
 #include <gba/bios/system.hpp>
 
+#include <gba/coroutine/awaitable.hpp>
+#include <gba/coroutine/executor.hpp>
+#include <gba/coroutine/frame_arena.hpp>
+#include <gba/coroutine/gba_platform.hpp>
+#include <gba/coroutine/task.hpp>
+
 #include <gba/display/background_control.hpp>
+#include <gba/display/bitmap.hpp>
 #include <gba/display/color_blend.hpp>
+#include <gba/display/compositor.hpp>
 #include <gba/display/display_control.hpp>
 #include <gba/display/interrupt_status.hpp>
 #include <gba/display/mosaic.hpp>
+#include <gba/display/page_flip.hpp>
+#include <gba/display/parallax.hpp>
+#include <gba/display/rasterizer.hpp>
+#include <gba/display/text_renderer.hpp>
+#include <gba/display/tile_cache.hpp>
+#include <gba/display/tile_convert.hpp>
+#include <gba/display/tilemap_streamer.hpp>
 #include <gba/display/window.hpp>
 
+#include <gba/dma/dma3_copy.hpp>
 #include <gba/dma/dma_control.hpp>
 
 #include <gba/io/background_matrix.hpp>
@@ -74,12 +90,16 @@
 #include <gba/io/mode4.hpp>
 #include <gba/io/mode5.hpp>
 
+#include <gba/keypad/input_history.hpp>
 #include <gba/keypad/keypad.hpp>
 #include <gba/keypad/keypad_manager.hpp>
+#include <gba/keypad/keypad_recording.hpp>
 
+#include <gba/object/animation_streamer.hpp>
 #include <gba/object/attributes.hpp>
 
 #include <gba/registers/display.hpp>
+#include <gba/registers/display_shadow.hpp>
 #include <gba/registers/dma.hpp>
 #include <gba/registers/interrupt_control.hpp>
 #include <gba/registers/keypad_input.hpp>
@@ -88,20 +108,33 @@
 #include <gba/registers/system.hpp>
 #include <gba/registers/timers.hpp>
 
+#include <gba/sio/bulk_transfer.hpp>
 #include <gba/sio/general_purpose.hpp>
 #include <gba/sio/joy_bus.hpp>
+#include <gba/sio/joy_bus_responder.hpp>
+#include <gba/sio/lockstep.hpp>
 #include <gba/sio/multiplayer.hpp>
+#include <gba/sio/multiplayer_link.hpp>
 #include <gba/sio/normal.hpp>
+#include <gba/sio/packet.hpp>
 #include <gba/sio/serial_control.hpp>
 #include <gba/sio/uart.hpp>
+#include <gba/sio/uart_stream.hpp>
 
 #include <gba/sound/direct.hpp>
 #include <gba/sound/dmg.hpp>
+#include <gba/sound/mixer.hpp>
+#include <gba/sound/music_player.hpp>
 #include <gba/sound/sound.hpp>
 
+#include <gba/system/iwram.hpp>
+#include <gba/system/power_manager.hpp>
 #include <gba/system/undocumented.hpp>
 #include <gba/system/waitstate.hpp>
 
+#include <gba/task/interrupt_wait.hpp>
+#include <gba/task/scheduler_core.hpp>
+
 #include <gba/time/timer_control.hpp>
 #include <gba/time/generate_timers.hpp>
 
@@ -114,6 +147,7 @@
 #include <gba/types/vector/vec3.hpp>
 #include <gba/types/vector/vec4.hpp>
 
+#include <gba/types/cycles.hpp>
 #include <gba/types/dimension.hpp>
 #include <gba/types/fixed_point.hpp>
 #include <gba/types/fixed_point_funcs.hpp>
@@ -124,6 +158,7 @@
 #include <gba/types/interrupt_mask.hpp>
 #include <gba/types/matrix.hpp>
 #include <gba/types/memmap.hpp>
+#include <gba/types/ring_buffer.hpp>
 #include <gba/types/screen_tile.hpp>
 #include <gba/types/uint_size.hpp>
 #include <gba/types/vector.hpp>
@@ -0,0 +1,186 @@
+#ifndef GBAXX_KEYPAD_INPUT_HISTORY_HPP
+#define GBAXX_KEYPAD_INPUT_HISTORY_HPP
+
+#include <gba/keypad/keypad_manager.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+
+/**
+ * Pressed keys and their edges for the most recent frames
+ * @tparam Frames frames kept (power of two)
+ */
+template <unsigned Frames = 64>
+class input_history {
+    static_assert( Frames > 1 && ( Frames & ( Frames - 1 ) ) == 0, "input_history Frames must be a power of two" );
+
+    struct entry {
+        uint16 keys;
+        uint16 pressed;
+    };
+
+    static_assert( sizeof( entry ) == 4, "input_history::entry must be tightly packed" );
+public:
+    static constexpr uint32 frames = Frames;
+    static constexpr uint16 key_bits = 0x3ff;
+
+    constexpr input_history() noexcept : m_entries {}, m_frame {} {}
+
+    /**
+     * Record one frame
+     * @param keys keys held this frame
+     */
+    constexpr void push( const key_mask keys ) noexcept {
+        const auto held = uint16( keys & key_bits );
+        const auto previous = m_entries[( m_frame - 1 ) % Frames].keys;
+        m_entries[m_frame % Frames] = entry { held, uint16( held & ~previous ) };
+        ++m_frame;
+    }
+
+    template <class KeypadSource>
+    constexpr void push( const keypad_manager<KeypadSource>& keypad ) noexcept {
+        push( keypad.key_mask() );
+    }
+
+    /**
+     * Keys held age frames ago; 0 is the latest frame
+     */
+    [[nodiscard]]
+    constexpr key_mask keys( const uint32 age = 0 ) const noexcept {
+        return at( age ).keys;
+    }
+
+    /**
+     * Keys that went down age frames ago
+     */
+    [[nodiscard]]
+    constexpr key_mask pressed( const uint32 age = 0 ) const noexcept {
+        return at( age ).pressed;
+    }
+
+    /**
+     * Keys that went up age frames ago
+     */
+    [[nodiscard]]
+    constexpr key_mask released( const uint32 age = 0 ) const noexcept {
+        return at( age + 1 ).keys & ~at( age ).keys & key_bits;
+    }
+
+    /**
+     * Frames pushed so far
+     */
+    [[nodiscard]]
+    constexpr uint32 frame() const noexcept {
+        return m_frame;
+    }
+
+private:
+    [[nodiscard]]
+    constexpr const entry& at( const uint32 age ) const noexcept {
+        return m_entries[( m_frame - 1 - age ) % Frames];
+    }
+
+    entry m_entries[Frames];
+    uint32 m_frame;
+};
+
+/**
+ * One step of an input sequence: the keys under mask must equal held, and the keys in pressed must go down
+ */
+struct input_step {
+    static constexpr uint16 directions = 0xf0;
+
+    [[nodiscard]]
+    static constexpr input_step direction( const key_mask held ) noexcept {
+        return input_step { directions, uint16( held & directions ), 0 };
+    }
+
+    /**
+     * Press buttons, optionally while holding a direction
+     */
+    [[nodiscard]]
+    static constexpr input_step press( const key_mask buttons, const key_mask held = 0 ) noexcept {
+        return input_step { uint16( held ? directions : 0 ), uint16( held & directions ), uint16( buttons ) };
+    }
+
+    [[nodiscard]]
+    constexpr bool matches( const uint16 keys, const uint16 pressedKeys ) const noexcept {
+        return ( keys & mask ) == held && ( pressedKeys & pressed ) == pressed;
+    }
+
+    uint16 mask;
+    uint16 held;
+    uint16 pressed;
+};
+
+/**
+ * Incremental matcher for a sequence of input steps completed within a window of frames
+ *
+ * For each prefix of the sequence it keeps the latest frame that prefix could have started on, so each frame costs
+ * one comparison per step however long the window is. Consecutive steps match on different frames.
+ * @tparam Steps steps in the sequence (1 to 32)
+ */
+template <unsigned Steps>
+class input_sequence {
+    static_assert( Steps > 0 && Steps <= 32, "input_sequence Steps must be between 1 and 32" );
+public:
+    /**
+     * @param window most frames from the first step to the last
+     */
+    constexpr input_sequence( const input_step ( & steps )[Steps], const uint32 window ) noexcept : m_steps {}, m_start {}, m_window { window }, m_valid {} {
+        for ( unsigned ii = 0; ii < Steps; ++ii ) {
+            m_steps[ii] = steps[ii];
+        }
+    }
+
+    /**
+     * Feed the latest frame
+     * @return true if the sequence completed on this frame; matching then starts over
+     */
+    constexpr bool update( const uint16 keys, const uint16 pressed, const uint32 frame ) noexcept {
+        for ( auto ii = Steps - 1; ii > 0; --ii ) {
+            const auto prefix = 1u << ( ii - 1 );
+            if ( !( m_valid & prefix ) || frame - m_start[ii - 1] > m_window ) {
+                m_valid &= ~prefix;
+                continue;
+            }
+            if ( m_steps[ii].matches( keys, pressed ) ) {
+                m_start[ii] = m_start[ii - 1];
+                m_valid |= 1u << ii;
+            }
+        }
+        if ( m_steps[0].matches( keys, pressed ) ) {
+            m_start[0] = frame;
+            m_valid |= 1u;
+        }
+
+        constexpr auto complete = 1u << ( Steps - 1 );
+        if ( ( m_valid & complete ) && frame - m_start[Steps - 1] <= m_window ) {
+            m_valid = 0;
+            return true;
+        }
+        return false;
+    }
+
+    template <unsigned Frames>
+    constexpr bool update( const input_history<Frames>& history ) noexcept {
+        return update( uint16( history.keys() ), uint16( history.pressed() ), history.frame() );
+    }
+
+    constexpr void reset() noexcept {
+        m_valid = 0;
+    }
+
+private:
+    input_step m_steps[Steps];
+    uint32 m_start[Steps];
+    uint32 m_window;
+    uint32 m_valid;
+};
+
+template <unsigned Steps>
+input_sequence( const input_step ( & )[Steps], uint32 ) -> input_sequence<Steps>;
+
+} // gba
+
+#endif // define GBAXX_KEYPAD_INPUT_HISTORY_HPP
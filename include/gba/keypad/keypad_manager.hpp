@@ -2,6 +2,7 @@
 #define GBAXX_KEYPAD_KEYPAD_MANAGER_HPP
 
 #include <gba/keypad/keypad.hpp>
+#include <gba/types/int_cast.hpp>
 #include <gba/types/memmap.hpp>
 #include <gba/types/int_type.hpp>
 
@@ -50,7 +51,7 @@ public:
     constexpr keypad_manager() noexcept : m_keys { 0x3ff }, m_xor { 0 } {}
 
     auto& poll() noexcept {
-        const auto keys = imemmap<uint16, KeypadSource::address>::read();
+        const auto keys = uint16( uint_cast( KeypadSource::read() ) & 0x3ff );
         m_xor = m_keys ^ keys;
         m_keys ^= m_xor;
         return *this;
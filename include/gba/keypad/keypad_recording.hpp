@@ -0,0 +1,236 @@
+#ifndef GBAXX_KEYPAD_KEYPAD_RECORDING_HPP
+#define GBAXX_KEYPAD_KEYPAD_RECORDING_HPP
+
+#include <gba/keypad/keypad.hpp>
+#include <gba/registers/keypad_input.hpp>
+#include <gba/types/int_cast.hpp>
+#include <gba/types/int_type.hpp>
+
+#if !defined( __has_builtin )
+#define __has_builtin( x )  0
+#endif
+
+#if __cpp_lib_bit_cast
+#include <bit>
+#endif
+
+namespace gba {
+
+/**
+ * Run-length encoding of one raw KEYINPUT value per frame
+ *
+ * Each run is two bytes, little endian: 10 bits of keys then a 6-bit frame count (1 to 63). A count of 0 marks a
+ * long run whose count follows in two more bytes. Only byte accesses are made, so the buffer may live in SRAM.
+ */
+struct keypad_rle {
+    static constexpr uint16 key_bits = 0x3ff;
+    static constexpr uint16 released = key_bits;
+    static constexpr uint32 short_run = 63;
+    static constexpr uint32 long_run = 0xffff;
+};
+
+class keypad_rle_writer {
+public:
+    constexpr keypad_rle_writer( uint8 * buffer, const uint32 capacity ) noexcept : m_buffer { buffer }, m_capacity { capacity }, m_size {}, m_frames {}, m_run {}, m_keys {}, m_overflow {} {}
+
+    /**
+     * Record one frame of keys
+     * @return false once the buffer is full; later frames are not recorded
+     */
+    bool push( const uint16 keys ) noexcept {
+        const auto masked = uint16( keys & keypad_rle::key_bits );
+        if ( m_run && ( masked != m_keys || m_run == keypad_rle::long_run ) ) {
+            flush();
+        }
+        if ( m_overflow ) {
+            return false;
+        }
+
+        m_keys = masked;
+        ++m_run;
+        ++m_frames;
+        return true;
+    }
+
+    /**
+     * Write out the run in progress; call before saving the buffer
+     * @return bytes used
+     */
+    uint32 finish() noexcept {
+        if ( m_run ) {
+            flush();
+        }
+        return m_size;
+    }
+
+    [[nodiscard]]
+    uint32 size() const noexcept {
+        return m_size;
+    }
+
+    /**
+     * Frames recorded, including the run in progress
+     */
+    [[nodiscard]]
+    uint32 frames() const noexcept {
+        return m_frames;
+    }
+
+    [[nodiscard]]
+    bool overflowed() const noexcept {
+        return m_overflow;
+    }
+
+private:
+    void flush() noexcept {
+        const auto longRun = m_run > keypad_rle::short_run;
+        if ( m_size + ( longRun ? 4u : 2u ) > m_capacity ) {
+            m_frames -= m_run;
+            m_run = 0;
+            m_overflow = true;
+            return;
+        }
+
+        const auto head = uint16( m_keys | ( longRun ? 0 : m_run ) << 10 );
+        m_buffer[m_size++] = uint8( head );
+        m_buffer[m_size++] = uint8( head >> 8 );
+        if ( longRun ) {
+            m_buffer[m_size++] = uint8( m_run );
+            m_buffer[m_size++] = uint8( m_run >> 8 );
+        }
+        m_run = 0;
+    }
+
+    uint8 * m_buffer;
+    uint32 m_capacity;
+    uint32 m_size;
+    uint32 m_frames;
+    uint32 m_run;
+    uint16 m_keys;
+    bool m_overflow;
+};
+
+class keypad_rle_reader {
+public:
+    constexpr keypad_rle_reader( const uint8 * data, const uint32 size ) noexcept : m_data { data }, m_size { size }, m_offset {}, m_frame {}, m_run {}, m_keys { keypad_rle::released } {}
+
+    /**
+     * Keys for the next frame; all released once the recording has ended
+     */
+    uint16 next() noexcept {
+        if ( m_run == 0 && !load() ) {
+            return keypad_rle::released;
+        }
+
+        --m_run;
+        ++m_frame;
+        return m_keys;
+    }
+
+    void rewind() noexcept {
+        m_offset = 0;
+        m_frame = 0;
+        m_run = 0;
+    }
+
+    [[nodiscard]]
+    bool done() const noexcept {
+        return m_run == 0 && m_offset + 2 > m_size;
+    }
+
+    /**
+     * Frames played back so far
+     */
+    [[nodiscard]]
+    uint32 frame() const noexcept {
+        return m_frame;
+    }
+
+private:
+    bool load() noexcept {
+        if ( m_offset + 2 > m_size ) {
+            m_keys = keypad_rle::released;
+            return false;
+        }
+
+        const auto head = uint16( m_data[m_offset] | m_data[m_offset + 1] << 8 );
+        m_offset += 2;
+        m_keys = head & keypad_rle::key_bits;
+        m_run = head >> 10;
+        if ( m_run == 0 ) {
+            if ( m_offset + 2 > m_size ) {
+                return false;
+            }
+            m_run = uint32( m_data[m_offset] | m_data[m_offset + 1] << 8 );
+            m_offset += 2;
+        }
+        return m_run != 0;
+    }
+
+    const uint8 * m_data;
+    uint32 m_size;
+    uint32 m_offset;
+    uint32 m_frame;
+    uint32 m_run;
+    uint16 m_keys;
+};
+
+/**
+ * KeypadSource that passes Source through while recording every read
+ *
+ * Attach a writer, then use as keypad_manager<keypad_recorder<>>. keypad_manager::poll() reads once per frame.
+ */
+template <class Source = reg::keyinput>
+class keypad_recorder {
+public:
+    using type = keypad;
+
+    static void attach( keypad_rle_writer * writer ) noexcept {
+        m_writer = writer;
+    }
+
+    [[nodiscard]]
+    static type read() noexcept {
+        const auto keys = Source::read();
+        if ( m_writer ) {
+            m_writer->push( uint16( uint_cast( keys ) ) );
+        }
+        return keys;
+    }
+
+private:
+    static inline keypad_rle_writer * m_writer = nullptr;
+};
+
+/**
+ * KeypadSource that plays back a recording in place of the hardware
+ * @tparam Id distinguishes independent replayers
+ */
+template <unsigned Id = 0>
+class keypad_replayer {
+public:
+    using type = keypad;
+
+    static void attach( keypad_rle_reader * reader ) noexcept {
+        m_reader = reader;
+    }
+
+    [[nodiscard]]
+    static type read() noexcept {
+        const auto keys = m_reader ? m_reader->next() : keypad_rle::released;
+#if __cpp_lib_bit_cast
+        return std::bit_cast<type>( keys );
+#elif __has_builtin( __builtin_bit_cast )
+        return __builtin_bit_cast( type, keys );
+#else
+        return *reinterpret_cast<const type *>( &keys );
+#endif
+    }
+
+private:
+    static inline keypad_rle_reader * m_reader = nullptr;
+};
+
+} // gba
+
+#endif // define GBAXX_KEYPAD_KEYPAD_RECORDING_HPP
@@ -0,0 +1,210 @@
+#ifndef GBAXX_OBJECT_ANIMATION_STREAMER_HPP
+#define GBAXX_OBJECT_ANIMATION_STREAMER_HPP
+
+#include <gba/allocator/tile_4bpp.hpp>
+#include <gba/allocator/tile_4bpp_2d.hpp>
+#include <gba/dma/dma3_copy.hpp>
+#include <gba/object/attributes.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+
+/**
+ * Streams the current animation frame of each sprite into one VRAM slot per sprite
+ *
+ * Frames are identified by the address of their tile data (4bpp, rows of tiles as laid out for the slot). prepare()
+ * decides what to upload and which tile index each sprite uses; flush() then performs every copy back to back in
+ * VBlank. A sprite whose slot already holds its frame uploads nothing, and sprites showing the same frame at the same
+ * size share whichever slot holds it, so only one copy is made. A hidden sprite's slot keeps its last frame for sharing.
+ * @tparam Sprites sprites tracked
+ * @tparam Copy dma3_copy, or cpu_copy off-hardware
+ */
+template <unsigned Sprites, class Copy = dma3_copy>
+class animation_streamer {
+    static_assert( Sprites > 0 && Sprites < 0xff, "animation_streamer Sprites must be between 1 and 254" );
+
+    static constexpr uint32 max_rows = 8;
+
+    struct slot {
+        uint32 * vram;
+        const uint32 * loaded;
+        const uint32 * frame;
+        uint16 tile_index;
+        uint16 row_words;
+        uint16 stride_words;
+        uint8 rows;
+        uint8 owner;
+    };
+
+    struct transfer {
+        const uint32 * src;
+        uint32 * dest;
+        uint32 words;
+    };
+public:
+    static constexpr int none = -1;
+
+    constexpr animation_streamer() noexcept : m_slots {}, m_queue {}, m_lockedSlots {}, m_locked {}, m_queued {}, m_uploaded {}, m_total {} {}
+
+    /**
+     * Give a sprite a 1D slot large enough for one frame
+     * @return sprite handle, or none if every handle is in use
+     */
+    int attach( buffer_tile4bpp& tiles ) noexcept {
+        return attach( static_cast<uint32 *>( tiles.map() ), tiles.start_index(), tiles.size(), 1, 0 );
+    }
+
+    /**
+     * Give a sprite a 2D mapped slot allocated with object_tile::allocate_tile4bpp( shape, size )
+     */
+    int attach( buffer_tile4bpp2d& tiles, const object::shape shape, const uint32 size ) noexcept {
+        return attach( static_cast<uint32 *>( tiles.map( 0 ) ), tiles.start_index(), object::tile_width( shape, size ) * 0x20u, object::tile_height( shape, size ), tiles.stride() );
+    }
+
+    /**
+     * @param vram first word of the slot
+     * @param tileIndex tile index of the slot for attribute 2
+     * @param rowBytes bytes per row of tiles
+     * @param rows rows of tiles (1 for 1D mapping)
+     * @param strideBytes bytes between rows of tiles
+     */
+    constexpr int attach( uint32 * vram, const uint32 tileIndex, const uint32 rowBytes, const uint32 rows, const uint32 strideBytes ) noexcept {
+        if ( rows > max_rows ) {
+            return none;
+        }
+        for ( unsigned ii = 0; ii < Sprites; ++ii ) {
+            if ( !m_slots[ii].vram ) {
+                m_slots[ii] = slot { vram, nullptr, nullptr, uint16( tileIndex ), uint16( rowBytes / 4 ), uint16( strideBytes / 4 ), uint8( rows ), uint8( ii ) };
+                return int( ii );
+            }
+        }
+        return none;
+    }
+
+    constexpr void detach( const int sprite ) noexcept {
+        m_slots[sprite] = slot {};
+    }
+
+    /**
+     * Show a frame on a sprite from the next flush(); nullptr for a hidden sprite, which uploads nothing
+     */
+    constexpr void set_frame( const int sprite, const void * frame ) noexcept {
+        m_slots[sprite].frame = static_cast<const uint32 *>( frame );
+    }
+
+    /**
+     * Decide this frame's uploads; call once after every set_frame() and before flush()
+     * @return bytes that flush() will copy
+     */
+    constexpr uint32 prepare() noexcept {
+        m_locked = 0;
+        m_queued = 0;
+        m_uploaded = 0;
+
+        // Slots that already hold their own frame are final before anything else is decided; so are the slots of
+        // hidden sprites, which keep their last frame and may be shared
+        for ( unsigned ii = 0; ii < Sprites; ++ii ) {
+            auto& s = m_slots[ii];
+            if ( s.vram && s.loaded && ( !s.frame || s.loaded == s.frame ) ) {
+                s.owner = uint8( ii );
+                m_lockedSlots[m_locked++] = uint8( ii );
+            }
+        }
+
+        // Everything else shares a final slot with the same frame, or loads into its own slot
+        for ( unsigned ii = 0; ii < Sprites; ++ii ) {
+            auto& s = m_slots[ii];
+            if ( !s.vram || !s.frame || s.loaded == s.frame ) {
+                continue;
+            }
+
+            const auto shared = find_locked( s );
+            if ( shared != none ) {
+                s.owner = uint8( shared );
+                continue;
+            }
+
+            s.owner = uint8( ii );
+            s.loaded = s.frame;
+            m_lockedSlots[m_locked++] = uint8( ii );
+            enqueue( s );
+        }
+
+        m_total += m_uploaded;
+        return m_uploaded;
+    }
+
+    /**
+     * Perform the copies decided by prepare(); call in VBlank, together with the OAM update using tile_index()
+     */
+    void flush() noexcept {
+        for ( uint32 ii = 0; ii < m_queued; ++ii ) {
+            Copy::copy( m_queue[ii].src, m_queue[ii].dest, m_queue[ii].words );
+        }
+        m_queued = 0;
+    }
+
+    /**
+     * Tile index to put in the sprite's attribute 2 after the coming flush()
+     */
+    [[nodiscard]]
+    constexpr uint16 tile_index( const int sprite ) const noexcept {
+        return m_slots[m_slots[sprite].owner].tile_index;
+    }
+
+    /**
+     * Bytes queued by the last prepare()
+     */
+    [[nodiscard]]
+    constexpr uint32 uploaded_bytes() const noexcept {
+        return m_uploaded;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 total_bytes() const noexcept {
+        return m_total;
+    }
+
+    /**
+     * Copies queued by the last prepare(); consecutive rows of a 2D slot count separately
+     */
+    [[nodiscard]]
+    constexpr uint32 transfers() const noexcept {
+        return m_queued;
+    }
+
+private:
+    [[nodiscard]]
+    constexpr int find_locked( const slot& s ) const noexcept {
+        for ( uint32 ii = 0; ii < m_locked; ++ii ) {
+            const auto& other = m_slots[m_lockedSlots[ii]];
+            if ( other.loaded == s.frame && other.row_words == s.row_words && other.rows == s.rows ) {
+                return m_lockedSlots[ii];
+            }
+        }
+        return none;
+    }
+
+    constexpr void enqueue( const slot& s ) noexcept {
+        if ( s.rows == 1 || s.stride_words == s.row_words ) {
+            m_queue[m_queued++] = transfer { s.frame, s.vram, uint32( s.row_words * s.rows ) };
+        } else {
+            for ( uint32 row = 0; row < s.rows; ++row ) {
+                m_queue[m_queued++] = transfer { s.frame + row * s.row_words, s.vram + row * s.stride_words, s.row_words };
+            }
+        }
+        m_uploaded += s.row_words * s.rows * 4u;
+    }
+
+    slot m_slots[Sprites];
+    transfer m_queue[Sprites * max_rows];
+    uint8 m_lockedSlots[Sprites];
+    uint32 m_locked;
+    uint32 m_queued;
+    uint32 m_uploaded;
+    uint32 m_total;
+};
+
+} // gba
+
+#endif // define GBAXX_OBJECT_ANIMATION_STREAMER_HPP
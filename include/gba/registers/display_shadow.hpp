@@ -0,0 +1,152 @@
+#ifndef GBAXX_REGISTERS_DISPLAY_SHADOW_HPP
+#define GBAXX_REGISTERS_DISPLAY_SHADOW_HPP
+
+#include <cstring>
+
+#include <gba/dma/dma3_copy.hpp>
+#include <gba/registers/display.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+
+/**
+ * Shadow of the display registers, 4000000h to 4000057h, written to hardware in VBlank
+ *
+ * Registers are read and written through the reg:: aliases, such as write<reg::bg0hofs>( 8 ). Writes only touch the
+ * shadow and mark the halfwords that changed. commit() writes changed halfwords one by one, or when at least
+ * BurstThreshold changed, copies the span from the first changed halfword to the last in one transfer.
+ *
+ * The shadow owns the block apart from DISPSTAT and VCOUNT (4000004h to 4000007h), which hold the hardware's IRQ
+ * enables and current line: it starts zeroed with every other register marked, so the first commit() sets them all,
+ * and a burst rewrites unchanged registers inside its span with their shadow values. A burst across DISPSTAT is split
+ * in two around it.
+ * @tparam BurstThreshold changed halfwords from which one burst is cheaper than separate writes
+ * @tparam Copy dma3_copy, or cpu_copy off-hardware
+ */
+template <unsigned BurstThreshold = 8, class Copy = dma3_copy>
+class display_shadow {
+    using uint64 = uint_type<64>::type;
+public:
+    static constexpr uint32 base = 0x4000000;
+    static constexpr uint32 halfwords = 0x58 / 2; ///< reg::bldy is declared 32-bit, so the unused 4000056h is included
+
+    display_shadow() noexcept : display_shadow( reinterpret_cast<volatile uint16 *>( base ) ) {}
+
+    /**
+     * @param io destination of commit(); the registers, or a buffer off-hardware
+     */
+    explicit display_shadow( volatile uint16 * io ) noexcept : m_io { io }, m_data {}, m_dirty { managed } {}
+
+    template <class Register>
+    void write( const typename Register::type& value ) noexcept {
+        constexpr auto first = offset<Register>();
+        constexpr auto count = uint32( sizeof( value ) + 1 ) / 2;
+
+        uint16 data[count] {};
+        std::memcpy( data, &value, sizeof( value ) );
+        for ( uint32 ii = 0; ii < count; ++ii ) {
+            if ( m_data[first + ii] != data[ii] ) {
+                m_data[first + ii] = data[ii];
+                m_dirty |= uint64( 1 ) << ( first + ii );
+            }
+        }
+    }
+
+    /**
+     * Value in the shadow; write-only registers read back what was last written
+     */
+    template <class Register>
+    [[nodiscard]]
+    typename Register::type read() const noexcept {
+        typename Register::type value;
+        std::memcpy( &value, m_data + offset<Register>(), sizeof( value ) );
+        return value;
+    }
+
+    template <class Register, class TransformOp>
+    void transform( TransformOp t ) noexcept {
+        auto value = read<Register>();
+        t( value );
+        write<Register>( value );
+    }
+
+    /**
+     * Write changed registers; call in VBlank
+     * @return halfwords written
+     */
+    uint32 commit() noexcept {
+        if ( !m_dirty ) {
+            return 0;
+        }
+
+        uint32 first = 0;
+        uint32 last = 0;
+        uint32 changed = 0;
+        for ( uint32 ii = 0; ii < halfwords; ++ii ) {
+            if ( m_dirty >> ii & 1 ) {
+                first = changed ? first : ii;
+                last = ii + 1;
+                ++changed;
+            }
+        }
+
+        if ( changed >= BurstThreshold ) {
+            uint32 written = 0;
+            if ( first < status ) {
+                const auto end = last < status ? last : status;
+                Copy::copy( m_data + first, m_io + first, end - first );
+                written += end - first;
+            }
+            if ( last > status + 2 ) {
+                const auto begin = first > status + 2 ? first : status + 2;
+                Copy::copy( m_data + begin, m_io + begin, last - begin );
+                written += last - begin;
+            }
+            m_dirty = 0;
+            return written;
+        }
+
+        for ( auto ii = first; ii < last; ++ii ) {
+            if ( m_dirty >> ii & 1 ) {
+                m_io[ii] = m_data[ii];
+            }
+        }
+        m_dirty = 0;
+        return changed;
+    }
+
+    /**
+     * Mark every register but DISPSTAT and VCOUNT, such as after other code wrote the hardware directly
+     */
+    void invalidate() noexcept {
+        m_dirty = managed;
+    }
+
+    /**
+     * Bit n set when halfword n (address 4000000h + 2n) is waiting for commit()
+     */
+    [[nodiscard]]
+    uint64 dirty() const noexcept {
+        return m_dirty;
+    }
+
+private:
+    static constexpr uint32 status = ( 0x4000004 - base ) / 2; ///< DISPSTAT, followed by VCOUNT
+    static constexpr uint64 managed = ( ( uint64( 1 ) << halfwords ) - 1 ) & ~( uint64( 0x3 ) << status );
+
+    template <class Register>
+    static constexpr uint32 offset() noexcept {
+        static_assert( Register::address >= base && Register::address + sizeof( typename Register::type ) <= base + halfwords * 2, "display_shadow register must be within 4000000h to 4000057h" );
+        static_assert( Register::address % 2 == 0, "display_shadow register must be halfword aligned" );
+        static_assert( Register::address + sizeof( typename Register::type ) <= base + status * 2 || Register::address >= base + status * 2 + 4, "display_shadow does not manage DISPSTAT and VCOUNT" );
+        return ( Register::address - base ) / 2;
+    }
+
+    volatile uint16 * m_io;
+    uint16 m_data[halfwords];
+    uint64 m_dirty;
+};
+
+} // gba
+
+#endif // define GBAXX_REGISTERS_DISPLAY_SHADOW_HPP
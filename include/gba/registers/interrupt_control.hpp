@@ -12,6 +12,8 @@ using ime = iomemmap<uint32, 0x4000208>;
 using ie = iomemmap<interrupt_mask, 0x4000200>;
 using if_ = iomemmap<interrupt_mask, 0x4000202>;
 
+using ifbios = iomemmap<interrupt_mask, 0x3007ff8>;
+
 } // reg
 } // gba
 
@@ -8,6 +8,7 @@ namespace gba {
 namespace reg {
 
 using keyinput = imemmap<keypad, 0x4000130>;
+using keycnt = iomemmap<keypad_control, 0x4000132>;
 
 } // reg
 } // gba
@@ -0,0 +1,454 @@
+#ifndef GBAXX_SIO_BULK_TRANSFER_HPP
+#define GBAXX_SIO_BULK_TRANSFER_HPP
+
+#include <gba/registers/sio.hpp>
+#include <gba/sio/normal.hpp>
+#include <gba/types/cycles.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+namespace sio {
+
+/**
+ * Block protocol for moving a buffer of words over Normal mode 32-bit transfers
+ *
+ * Every transfer swaps one word each way, and a reply can only react to the previous word, so each turnaround
+ * costs one transfer. The sender offers the length and the receiver answers with the offset to resume from. Data
+ * then flows in blocks, each followed by a checksum; the receiver answers each check with the offset to continue
+ * from, which either commits the block or rewinds to its start. Control words carry a command in the top byte and
+ * a 24-bit value, and only appear where the other side expects them, so data needs no escaping.
+ */
+struct bulk {
+    enum class command : uint8 {
+        idle = 0x00,
+        offer = 0xb1,
+        resume = 0xb2,
+        check = 0xb3,
+        poll = 0xb4,
+        busy = 0xb5,
+        done = 0xb6
+    };
+
+    static constexpr uint32 max_words = 0xffffff;
+
+    [[nodiscard]]
+    static constexpr uint32 make( const command cmd, const uint32 value ) noexcept {
+        return uint32( cmd ) << 24 | ( value & 0xffffff );
+    }
+
+    [[nodiscard]]
+    static constexpr command command_of( const uint32 word ) noexcept {
+        return command( word >> 24 );
+    }
+
+    [[nodiscard]]
+    static constexpr uint32 value_of( const uint32 word ) noexcept {
+        return word & 0xffffff;
+    }
+
+    [[nodiscard]]
+    static constexpr uint32 checksum( const uint32 sum, const uint32 word ) noexcept {
+        return ( sum << 5 | sum >> 27 ) ^ word;
+    }
+
+    [[nodiscard]]
+    static constexpr uint32 fold( const uint32 sum ) noexcept {
+        return ( sum ^ ( sum >> 24 ) ) & 0xffffff;
+    }
+};
+
+class bulk_sender {
+    enum class state : uint8 {
+        offer,
+        data,
+        check,
+        poll,
+        done
+    };
+public:
+    /**
+     * @param blockWords words between checksums; smaller blocks resend less after an error
+     */
+    constexpr bulk_sender( const uint32 * data, const uint32 words, const uint32 blockWords = 64 ) noexcept : m_data { data }, m_words { words }, m_blockWords { blockWords }, m_position {}, m_sessionStart {}, m_blockEnd {}, m_cursor {}, m_sum {}, m_errors {}, m_state { state::offer }, m_resumed {} {}
+
+    /**
+     * Word to load before the first transfer
+     */
+    [[nodiscard]]
+    constexpr uint32 initial() const noexcept {
+        return bulk::make( bulk::command::offer, m_words );
+    }
+
+    /**
+     * Handle the word received by the last transfer
+     * @return word to send in the next transfer
+     */
+    constexpr uint32 exchange( const uint32 received ) noexcept {
+        switch ( m_state ) {
+            case state::offer:
+                if ( bulk::command_of( received ) == bulk::command::resume ) {
+                    const auto offset = bulk::value_of( received );
+                    if ( !m_resumed ) {
+                        m_sessionStart = offset < m_words ? offset : m_words;
+                        m_resumed = true;
+                    }
+                    return begin_block( offset );
+                }
+                return initial();
+            case state::data:
+                return next_data();
+            case state::check:
+                m_state = state::poll;
+                return bulk::make( bulk::command::poll, 0 );
+            case state::poll:
+                if ( bulk::command_of( received ) == bulk::command::resume ) {
+                    const auto offset = bulk::value_of( received );
+                    if ( offset != m_blockEnd ) {
+                        ++m_errors;
+                    }
+                    return begin_block( offset );
+                }
+                // Lost the turnaround; renegotiate
+                ++m_errors;
+                m_state = state::offer;
+                return initial();
+            case state::done:
+                if ( received != bulk::make( bulk::command::done, m_words ) ) {
+                    // The receiver has not seen the end; renegotiate
+                    ++m_errors;
+                    m_state = state::offer;
+                    return initial();
+                }
+                break;
+        }
+        return bulk::make( bulk::command::done, m_words );
+    }
+
+    [[nodiscard]]
+    constexpr bool done() const noexcept {
+        return m_state == state::done;
+    }
+
+    /**
+     * Words the receiver has confirmed
+     */
+    [[nodiscard]]
+    constexpr uint32 position() const noexcept {
+        return m_position;
+    }
+
+    /**
+     * Payload words confirmed since the session started; words committed in an earlier session, control words and
+     * resent blocks are not counted
+     */
+    [[nodiscard]]
+    constexpr uint32 delivered() const noexcept {
+        return m_resumed ? m_position - m_sessionStart : 0;
+    }
+
+    /**
+     * Start a new session, such as after the cable was reconnected: offer again, and count delivered() from the
+     * offset the receiver resumes at
+     */
+    constexpr void begin_session() noexcept {
+        m_resumed = false;
+        m_state = state::offer;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 errors() const noexcept {
+        return m_errors;
+    }
+
+private:
+    constexpr uint32 begin_block( const uint32 offset ) noexcept {
+        m_position = offset < m_words ? offset : m_words;
+        if ( m_position == m_words ) {
+            m_state = state::done;
+            return bulk::make( bulk::command::done, m_words );
+        }
+
+        m_blockEnd = m_position + m_blockWords < m_words ? m_position + m_blockWords : m_words;
+        m_cursor = m_position;
+        m_sum = 0;
+        m_state = state::data;
+        return next_data();
+    }
+
+    constexpr uint32 next_data() noexcept {
+        if ( m_cursor == m_blockEnd ) {
+            m_state = state::check;
+            return bulk::make( bulk::command::check, bulk::fold( m_sum ) );
+        }
+
+        const auto word = m_data[m_cursor++];
+        m_sum = bulk::checksum( m_sum, word );
+        return word;
+    }
+
+    const uint32 * m_data;
+    uint32 m_words;
+    uint32 m_blockWords;
+    uint32 m_position;
+    uint32 m_sessionStart;
+    uint32 m_blockEnd;
+    uint32 m_cursor;
+    uint32 m_sum;
+    uint32 m_errors;
+    state m_state;
+    bool m_resumed;
+};
+
+class bulk_receiver {
+    enum class state : uint8 {
+        idle,
+        skip,
+        data,
+        check,
+        complete
+    };
+public:
+    constexpr bulk_receiver( uint32 * buffer, const uint32 capacity, const uint32 blockWords = 64 ) noexcept : m_buffer { buffer }, m_capacity { capacity }, m_blockWords { blockWords }, m_words {}, m_committed {}, m_sessionStart {}, m_cursor {}, m_remaining {}, m_sum {}, m_errors {}, m_state { state::idle } {}
+
+    [[nodiscard]]
+    constexpr uint32 initial() const noexcept {
+        return bulk::make( bulk::command::idle, 0 );
+    }
+
+    constexpr uint32 exchange( const uint32 received ) noexcept {
+        switch ( m_state ) {
+            case state::idle:
+            case state::complete:
+                if ( bulk::command_of( received ) == bulk::command::offer ) {
+                    return accept( bulk::value_of( received ) );
+                }
+                return bulk::make( m_state == state::complete ? bulk::command::done : bulk::command::idle, m_committed );
+            case state::skip:
+                // The sender's word crossed our reply
+                if ( m_committed == m_words ) {
+                    m_state = state::complete;
+                    return bulk::make( bulk::command::done, m_committed );
+                }
+                m_cursor = m_committed;
+                m_remaining = m_committed + m_blockWords < m_words ? m_blockWords : m_words - m_committed;
+                m_sum = 0;
+                m_state = state::data;
+                return bulk::make( bulk::command::busy, m_committed );
+            case state::data:
+                m_buffer[m_cursor++] = received;
+                m_sum = bulk::checksum( m_sum, received );
+                if ( --m_remaining == 0 ) {
+                    m_state = state::check;
+                }
+                return bulk::make( bulk::command::busy, m_committed );
+            case state::check:
+                if ( bulk::command_of( received ) == bulk::command::check && bulk::value_of( received ) == bulk::fold( m_sum ) ) {
+                    m_committed = m_cursor;
+                } else if ( bulk::command_of( received ) == bulk::command::offer ) {
+                    return accept( bulk::value_of( received ) );
+                } else {
+                    ++m_errors;
+                }
+                m_state = state::skip;
+                return bulk::make( bulk::command::resume, m_committed );
+        }
+        return initial();
+    }
+
+    [[nodiscard]]
+    constexpr bool complete() const noexcept {
+        return m_state == state::complete;
+    }
+
+    /**
+     * Words verified so far; a restarted offer of the same length resumes from here
+     */
+    [[nodiscard]]
+    constexpr uint32 committed() const noexcept {
+        return m_committed;
+    }
+
+    /**
+     * Payload words committed since the session started; words committed in an earlier session, control words and
+     * rejected blocks are not counted
+     */
+    [[nodiscard]]
+    constexpr uint32 delivered() const noexcept {
+        return m_committed - m_sessionStart;
+    }
+
+    /**
+     * Start a new session, such as after the cable was reconnected; delivered() counts from the committed offset
+     */
+    constexpr void begin_session() noexcept {
+        m_sessionStart = m_committed;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 size() const noexcept {
+        return m_words;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 errors() const noexcept {
+        return m_errors;
+    }
+
+private:
+    constexpr uint32 accept( const uint32 words ) noexcept {
+        if ( words != m_words || words > m_capacity ) {
+            m_words = words > m_capacity ? m_capacity : words;
+            m_committed = 0;
+            m_sessionStart = 0;
+        }
+        m_state = state::skip;
+        return bulk::make( bulk::command::resume, m_committed );
+    }
+
+    uint32 * m_buffer;
+    uint32 m_capacity;
+    uint32 m_blockWords;
+    uint32 m_words;
+    uint32 m_committed;
+    uint32 m_sessionStart;
+    uint32 m_cursor;
+    uint32 m_remaining;
+    uint32 m_sum;
+    uint32 m_errors;
+    state m_state;
+};
+
+/**
+ * Run two endpoints against each other off-hardware, as a wire that can corrupt words
+ * @param fault called as fault( exchange, wordToB, wordToA ) with references, so it may alter either word
+ * @return transfers performed until both sides finished, or maxTransfers
+ */
+template <class EndpointA, class EndpointB, class Fault>
+constexpr uint32 bulk_loopback( EndpointA& a, EndpointB& b, const uint32 maxTransfers, Fault&& fault ) noexcept {
+    auto fromA = a.initial();
+    auto fromB = b.initial();
+    for ( uint32 ii = 0; ii < maxTransfers; ++ii ) {
+        auto toB = fromA;
+        auto toA = fromB;
+        fault( ii, toB, toA );
+        fromA = a.exchange( toA );
+        fromB = b.exchange( toB );
+
+        if ( a.done() && b.complete() ) {
+            return ii + 1;
+        }
+    }
+    return maxTransfers;
+}
+
+/**
+ * Normal mode 32-bit driver for a bulk_sender or bulk_receiver
+ *
+ * The clock master only starts a transfer while SI is low; the slave holds SO high while it reloads SIODATA32.
+ * Either side can send; the roles of clock and data are independent.
+ */
+template <class Endpoint>
+class normal32_port {
+public:
+    explicit constexpr normal32_port( Endpoint& endpoint ) noexcept : m_endpoint { &endpoint }, m_transfers {}, m_master {} {}
+
+    void start_master( const normal::shift_clock clock = normal::shift_clock::internal_2MHz ) noexcept {
+        m_master = true;
+        m_endpoint->begin_session();
+        configure( clock );
+        pump();
+    }
+
+    void start_slave() noexcept {
+        m_master = false;
+        m_endpoint->begin_session();
+        configure( normal::shift_clock::external );
+        arm();
+    }
+
+    /**
+     * Master only: start a transfer if the slave is ready; call from the serial interrupt and whenever idle
+     * @return true if a transfer was started
+     */
+    bool pump() noexcept {
+        auto control = reg::siocnt<normal>::read();
+        if ( !m_master || control.transferring || control.input_state != normal::io_state::ready ) {
+            return false;
+        }
+
+        control.transferring = true;
+        reg::siocnt<normal>::write( control );
+        return true;
+    }
+
+    /**
+     * Call from the serial interrupt handler
+     */
+    void on_serial() noexcept {
+        if ( !m_master ) {
+            set_output( normal::io_state::not_ready );
+        }
+
+        ++m_transfers;
+        reg::siodata32::write( m_endpoint->exchange( reg::siodata32::read() ) );
+
+        if ( m_master ) {
+            pump();
+        } else {
+            arm();
+        }
+    }
+
+    [[nodiscard]]
+    uint32 transfers() const noexcept {
+        return m_transfers;
+    }
+
+    /**
+     * Payload throughput over the session's elapsed time; offers, checksums, resumes and resent blocks are overhead,
+     * so this is below the raw rate of transfers() * 4 bytes. Words resumed from an earlier session are not counted
+     */
+    [[nodiscard]]
+    uint32 bytes_per_second( const cycles_type elapsed ) const noexcept {
+        using uint64 = uint_type<64>::type;
+        if ( !elapsed.count() ) {
+            return 0;
+        }
+        return uint32( uint64( m_endpoint->delivered() ) * 4u * cycles_per_second.count() / elapsed.count() );
+    }
+
+private:
+    void configure( const normal::shift_clock clock ) noexcept {
+        reg::rcnt<normal>::write( {} );
+        auto control = sio::control<normal> {};
+        control.shift_clock = clock;
+        control.output_state = normal::io_state::not_ready;
+        control.type = normal::transfer_type::word;
+        control.irq_enable = true;
+        reg::siocnt<normal>::write( control );
+        reg::siodata32::write( m_endpoint->initial() );
+    }
+
+    void set_output( const normal::io_state state ) noexcept {
+        auto control = reg::siocnt<normal>::read();
+        control.output_state = state;
+        reg::siocnt<normal>::write( control );
+    }
+
+    // Slave: wait for the master's clock, then signal ready on SO
+    void arm() noexcept {
+        auto control = reg::siocnt<normal>::read();
+        control.transferring = true;
+        control.output_state = normal::io_state::ready;
+        reg::siocnt<normal>::write( control );
+    }
+
+    Endpoint * m_endpoint;
+    uint32 m_transfers;
+    bool m_master;
+};
+
+} // sio
+} // gba
+
+#endif // define GBAXX_SIO_BULK_TRANSFER_HPP
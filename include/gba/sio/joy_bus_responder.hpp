@@ -0,0 +1,339 @@
+#ifndef GBAXX_SIO_JOY_BUS_RESPONDER_HPP
+#define GBAXX_SIO_JOY_BUS_RESPONDER_HPP
+
+#include <atomic>
+
+#include <gba/registers/interrupt_control.hpp>
+#include <gba/registers/sio.hpp>
+#include <gba/sio/joy_bus.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+namespace sio {
+
+/**
+ * JOY Bus registers
+ *
+ * The hardware answers the controller's reset (0xff), status (0x00), read (0x14) and write (0x15) commands by itself;
+ * software only sees the JOYCNT flags they leave behind and keeps JOY_TRANS loaded.
+ */
+class joy_bus_port {
+public:
+    void configure() noexcept {
+        reg::rcnt<joy_bus>::write( {} );
+        reg::joycnt::write( { .device_reset = true, .receive_complete = true, .send_complete = true, .irq_enable = true } );
+    }
+
+    /**
+     * Commands completed since the last acknowledge()
+     */
+    [[nodiscard]]
+    joy_bus::control flags() const noexcept {
+        return reg::joycnt::read();
+    }
+
+    void acknowledge( const joy_bus::control flags ) noexcept {
+        reg::joycnt::write( { .device_reset = flags.device_reset, .receive_complete = flags.receive_complete, .send_complete = flags.send_complete, .irq_enable = true } );
+    }
+
+    /**
+     * Word written by the controller; clears the JOYSTAT receive flag
+     */
+    [[nodiscard]]
+    uint32 receive() noexcept {
+        return reg::joy_recv::read();
+    }
+
+    /**
+     * Load the word for the controller's next read; sets the JOYSTAT send flag
+     */
+    void transmit( const uint32 word ) noexcept {
+        reg::joy_trans::write( word );
+    }
+
+    /**
+     * General purpose bits reported by the status command
+     *
+     * Called from both the main loop and the interrupt handler, so the read-modify-write runs with IME cleared.
+     */
+    void set_status( const uint32 bits ) noexcept {
+        const auto ime = reg::ime::read();
+        reg::ime::write( 0 );
+        auto status = reg::joystat::read();
+        status.general_purpose_data = bits;
+        reg::joystat::write( status );
+        reg::ime::write( ime );
+    }
+};
+
+/**
+ * Simulated JOY Bus for driving a joy_bus_responder off-hardware
+ *
+ * The test plays the controller with reset(), status(), read() and write(), which behave like the commands of the
+ * same names. None of them raises an interrupt; call joy_bus_responder::on_joy_bus() afterwards when pending().
+ */
+class host_joy_bus_port {
+public:
+    static constexpr uint8 send_flag = 0x02;
+    static constexpr uint8 receive_flag = 0x08;
+
+    constexpr host_joy_bus_port() noexcept : m_recv {}, m_trans {}, m_flags {}, m_status {} {}
+
+    constexpr void configure() noexcept {
+        m_flags = flag_none;
+        m_status = 0;
+    }
+
+    [[nodiscard]]
+    constexpr joy_bus::control flags() const noexcept {
+        return { .device_reset = ( m_flags & flag_reset ) != 0, .receive_complete = ( m_flags & flag_receive ) != 0, .send_complete = ( m_flags & flag_send ) != 0, .irq_enable = true };
+    }
+
+    constexpr void acknowledge( const joy_bus::control flags ) noexcept {
+        m_flags &= ~( ( flags.device_reset ? flag_reset : 0 ) | ( flags.receive_complete ? flag_receive : 0 ) | ( flags.send_complete ? flag_send : 0 ) );
+    }
+
+    [[nodiscard]]
+    constexpr uint32 receive() noexcept {
+        m_status &= ~receive_flag;
+        return m_recv;
+    }
+
+    constexpr void transmit( const uint32 word ) noexcept {
+        m_trans = word;
+        m_status |= send_flag;
+    }
+
+    constexpr void set_status( const uint32 bits ) noexcept {
+        m_status = uint8( ( m_status & ~0x30 ) | ( bits & 0x3 ) << 4 );
+    }
+
+    /**
+     * Controller side: reset command
+     */
+    constexpr void reset() noexcept {
+        m_flags |= flag_reset;
+    }
+
+    /**
+     * Controller side: status command
+     * @return JOYSTAT byte, as sent after the device id
+     */
+    [[nodiscard]]
+    constexpr uint8 status() const noexcept {
+        return m_status;
+    }
+
+    /**
+     * Controller side: read command
+     * @return false if no word was loaded since the last read; word is then stale
+     */
+    constexpr bool read( uint32& word ) noexcept {
+        const auto loaded = ( m_status & send_flag ) != 0;
+        word = m_trans;
+        m_status &= ~send_flag;
+        m_flags |= flag_send;
+        return loaded;
+    }
+
+    /**
+     * Controller side: write command
+     * @return false if the previous word had not been taken yet; it is overwritten
+     */
+    constexpr bool write( const uint32 word ) noexcept {
+        const auto free = ( m_status & receive_flag ) == 0;
+        m_recv = word;
+        m_status |= receive_flag;
+        m_flags |= flag_receive;
+        return free;
+    }
+
+    [[nodiscard]]
+    constexpr bool pending() const noexcept {
+        return m_flags != flag_none;
+    }
+
+private:
+    static constexpr uint8 flag_none = 0;
+    static constexpr uint8 flag_reset = 1;
+    static constexpr uint8 flag_receive = 2;
+    static constexpr uint8 flag_send = 4;
+
+    uint32 m_recv;
+    uint32 m_trans;
+    uint8 m_flags;
+    uint8 m_status;
+};
+
+/**
+ * Interrupt-driven JOY Bus device
+ *
+ * Bulk transfers run straight out of and into caller-owned buffers, one word per controller command, with no
+ * intermediate copy; the buffers must stay valid until the transfer is done. The two general purpose status bits
+ * advertise the state to the controller: bit 0 while words remain to be read, bit 1 while a receive buffer has room.
+ * A reset command aborts both transfers.
+ * @tparam Port joy_bus_port, or host_joy_bus_port off-hardware
+ */
+template <class Port = joy_bus_port>
+class joy_bus_responder {
+public:
+    static constexpr uint32 status_sending = 0x1;
+    static constexpr uint32 status_receiving = 0x2;
+
+    struct counters {
+        uint32 resets;
+        uint32 words_sent;
+        uint32 words_received;
+        uint32 dropped;
+    };
+
+    joy_bus_responder( const joy_bus_responder& ) = delete;
+    joy_bus_responder& operator =( const joy_bus_responder& ) = delete;
+
+    constexpr joy_bus_responder() noexcept : m_port {}, m_sendData {}, m_receiveData {}, m_sendWords {}, m_receiveWords {}, m_sent {}, m_received {}, m_counters {} {}
+
+    /**
+     * Switch to JOY Bus mode with its interrupt enabled
+     */
+    void start() noexcept {
+        m_port.configure();
+        abort();
+    }
+
+    /**
+     * Offer words for the controller to read
+     * @return false if a send is still in progress
+     */
+    bool send( const uint32 * data, const uint32 words ) noexcept {
+        if ( sending() ) {
+            return false;
+        }
+
+        // Publish before loading JOY_TRANS; a controller only reads once JOYSTAT says a word is loaded
+        m_sendWords = 0;
+        m_sent = 0;
+        m_sendData = data;
+        std::atomic_signal_fence( std::memory_order_release );
+        m_sendWords = words;
+        if ( words ) {
+            m_port.transmit( data[0] );
+        }
+        update_status();
+        return true;
+    }
+
+    /**
+     * Accept words written by the controller into buffer
+     * @return false if a receive is still in progress
+     */
+    bool receive( uint32 * buffer, const uint32 words ) noexcept {
+        if ( receiving() ) {
+            return false;
+        }
+
+        m_receiveWords = 0;
+        m_received = 0;
+        m_receiveData = buffer;
+        std::atomic_signal_fence( std::memory_order_release );
+        m_receiveWords = words;
+        update_status();
+        return true;
+    }
+
+    /**
+     * Call from the serial interrupt handler
+     */
+    void on_joy_bus() noexcept {
+        const auto flags = m_port.flags();
+        m_port.acknowledge( flags );
+
+        if ( flags.device_reset ) {
+            ++m_counters.resets;
+            abort();
+        }
+
+        if ( flags.receive_complete ) {
+            const auto word = m_port.receive();
+            if ( m_received < m_receiveWords ) {
+                m_receiveData[m_received] = word;
+                m_received = m_received + 1;
+                ++m_counters.words_received;
+            } else {
+                ++m_counters.dropped;
+            }
+        }
+
+        if ( flags.send_complete && m_sent < m_sendWords ) {
+            m_sent = m_sent + 1;
+            ++m_counters.words_sent;
+            if ( m_sent < m_sendWords ) {
+                m_port.transmit( m_sendData[m_sent] );
+            }
+        }
+
+        update_status();
+    }
+
+    [[nodiscard]]
+    bool sending() const noexcept {
+        return m_sent < m_sendWords;
+    }
+
+    [[nodiscard]]
+    bool receiving() const noexcept {
+        return m_received < m_receiveWords;
+    }
+
+    /**
+     * Words the controller has read from the current send buffer
+     */
+    [[nodiscard]]
+    uint32 sent() const noexcept {
+        return m_sent;
+    }
+
+    /**
+     * Words written into the current receive buffer
+     */
+    [[nodiscard]]
+    uint32 received() const noexcept {
+        return m_received;
+    }
+
+    [[nodiscard]]
+    const counters& stats() const noexcept {
+        return m_counters;
+    }
+
+    [[nodiscard]]
+    Port& port() noexcept {
+        return m_port;
+    }
+
+private:
+    void abort() noexcept {
+        m_sendWords = 0;
+        m_receiveWords = 0;
+        m_sent = 0;
+        m_received = 0;
+        update_status();
+    }
+
+    void update_status() noexcept {
+        m_port.set_status( ( sending() ? status_sending : 0 ) | ( receiving() ? status_receiving : 0 ) );
+    }
+
+    Port m_port;
+    const uint32 * m_sendData;
+    uint32 * m_receiveData;
+    volatile uint32 m_sendWords;
+    volatile uint32 m_receiveWords;
+    volatile uint32 m_sent;
+    volatile uint32 m_received;
+    counters m_counters;
+};
+
+} // sio
+} // gba
+
+#endif // define GBAXX_SIO_JOY_BUS_RESPONDER_HPP
@@ -0,0 +1,317 @@
+#ifndef GBAXX_SIO_LOCKSTEP_HPP
+#define GBAXX_SIO_LOCKSTEP_HPP
+
+#include <atomic>
+
+#include <gba/keypad/keypad_manager.hpp>
+#include <gba/registers/sio.hpp>
+#include <gba/sio/multiplayer.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/ring_buffer.hpp>
+
+namespace gba {
+namespace sio {
+
+/**
+ * Lockstep input exchange over raw multiplayer transfers
+ *
+ * Input captured on frame f is applied on frame f + Delay on every console. Each transfer carries one 16-bit word:
+ * bit 15 clear is an input word (5-bit frame tag, 10-bit key mask), bit 15 set is a checksum word (5-bit frame tag,
+ * 10 bits of the rolling state checksum). Input words are resent from the oldest frame a peer may still lack, so lost
+ * transfers only cost time; the main loop never waits, it just skips simulating a frame until ready().
+ * @tparam Players consoles in the session (2 to 4)
+ * @tparam Delay frames of input delay (1 to 8)
+ */
+template <unsigned Players = 2, unsigned Delay = 3>
+class lockstep {
+    static_assert( Players >= 2 && Players <= 4, "lockstep Players must be between 2 and 4" );
+    static_assert( Delay >= 1 && Delay <= 8, "lockstep Delay must be between 1 and 8" );
+
+    static constexpr uint32 window = 32;
+    static constexpr uint16 tag_mask = window - 1;
+    static constexpr uint16 checksum_bit = 0x8000;
+    static constexpr uint16 idle = 0xffff;
+public:
+    static constexpr uint32 delay = Delay;
+    static constexpr uint16 key_bits = 0x3ff;
+
+    struct statistics {
+        uint32 frames;
+        uint32 stalls;
+        uint32 lead_total;
+        uint32 min_lead;
+        uint32 max_lead;
+        uint32 desyncs;
+        uint32 first_desync;
+    };
+
+    constexpr lockstep() noexcept : m_remote {}, m_local {}, m_sums {}, m_sumsIn {}, m_pendingSum {}, m_pendingFrame {}, m_known {}, m_stats {}, m_frame {}, m_newest { Delay - 1 }, m_rolling {}, m_cursor {}, m_sumOut {}, m_self {} {
+        for ( auto& known : m_known ) {
+            known = Delay - 1;
+        }
+        m_stats.min_lead = uint32( -1 );
+    }
+
+    /**
+     * Configure multiplayer mode with the serial interrupt enabled
+     */
+    void start( const multiplayer::baud_rate baudRate ) noexcept {
+        reg::rcnt<multiplayer>::write( {} );
+
+        auto control = sio::control<multiplayer> {};
+        control.baud_rate = baudRate;
+        control.irq_enable = true;
+        reg::siocnt<multiplayer>::write( control );
+        reg::siomlt_send::write( idle );
+    }
+
+    /**
+     * Parent only: begin the next transfer, typically several times a frame from a timer interrupt
+     * @return false if this console is a child, a transfer is running or a child is not ready
+     */
+    bool start_transfer() noexcept {
+        auto control = reg::siocnt<multiplayer>::read();
+        if ( control.input_terminal != multiplayer::input_terminal::parent || control.data_terminal != multiplayer::data_terminal::all_ready || control.transferring ) {
+            return false;
+        }
+
+        control.transferring = true;
+        reg::siocnt<multiplayer>::write( control );
+        return true;
+    }
+
+    /**
+     * Record this frame's local input, to be applied Delay frames from now
+     *
+     * Repeated calls while stalled on the same frame are ignored.
+     * @param keys pressed keys, as returned by keypad_manager::key_mask()
+     * @return false if input for this frame was already recorded
+     */
+    bool submit( const key_mask keys ) noexcept {
+        const uint32 next = m_newest + 1;
+        if ( next != m_frame + Delay ) {
+            return false;
+        }
+
+        m_local[next % window] = uint16( keys & key_bits );
+        std::atomic_signal_fence( std::memory_order_release );
+        m_newest = next;
+        return true;
+    }
+
+    /**
+     * Every player's input for the current frame has arrived
+     *
+     * A false result counts as a stall; the caller should skip simulating and try again next frame.
+     */
+    [[nodiscard]]
+    bool ready() noexcept {
+        if ( lead() < 0 ) {
+            ++m_stats.stalls;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Input of a player for the current frame; only valid once ready()
+     */
+    [[nodiscard]]
+    key_mask input( const unsigned player ) const noexcept {
+        const auto slot = m_frame % window;
+        if ( player == m_self ) {
+            return key_mask { m_local[slot] };
+        }
+        std::atomic_signal_fence( std::memory_order_acquire );
+        return key_mask { m_remote[player][slot] };
+    }
+
+    /**
+     * Finish the current frame
+     * @param checksum hash of the game state after simulating it; must be identical on every console
+     */
+    void advance( const uint32 checksum ) noexcept {
+        const auto frameLead = uint32( lead() );
+        m_stats.frames += 1;
+        m_stats.lead_total += frameLead;
+        m_stats.min_lead = frameLead < m_stats.min_lead ? frameLead : m_stats.min_lead;
+        m_stats.max_lead = frameLead > m_stats.max_lead ? frameLead : m_stats.max_lead;
+
+        m_rolling = ( m_rolling << 1 | m_rolling >> 31 ) ^ checksum;
+        const auto sum = fold( m_rolling );
+        m_sums[m_frame % window] = sum;
+        m_sumOut = uint16( checksum_bit | ( m_frame & tag_mask ) << 10 | sum );
+        ++m_frame;
+
+        compare();
+    }
+
+    /**
+     * Interrupt side: take one transfer's words and return the word to send next
+     * @param received the four SIOMULTI words
+     * @param self this console's player id
+     */
+    uint16 transfer( const uint16 * received, const unsigned self ) noexcept {
+        m_self = self;
+        for ( unsigned ii = 0; ii < Players; ++ii ) {
+            const auto word = received[ii];
+            if ( ii == self || word == idle ) {
+                continue;
+            }
+
+            if ( word & checksum_bit ) {
+                m_sumsIn[ii].push( word );
+                continue;
+            }
+
+            const uint32 expected = m_known[ii] + 1;
+            if ( ( expected & tag_mask ) == ( word >> 10 ) ) {
+                m_remote[ii][expected % window] = word & key_bits;
+                std::atomic_signal_fence( std::memory_order_release );
+                m_known[ii] = expected;
+            }
+        }
+
+        if ( m_sumOut ) {
+            const uint16 word = m_sumOut;
+            m_sumOut = 0;
+            return word;
+        }
+
+        // Cycle through every frame a peer may still be missing
+        const uint32 newest = m_newest;
+        const auto oldest = oldest_unconfirmed();
+        if ( int32( m_cursor - oldest ) < 0 || int32( m_cursor - newest ) > 0 ) {
+            m_cursor = oldest;
+        }
+        std::atomic_signal_fence( std::memory_order_acquire );
+        const auto word = uint16( ( m_cursor & tag_mask ) << 10 | m_local[m_cursor % window] );
+        ++m_cursor;
+        return word;
+    }
+
+    /**
+     * Call from the serial interrupt handler
+     */
+    void on_serial() noexcept {
+        const auto control = reg::siocnt<multiplayer>::read();
+        const uint16 received[4] = { reg::siomulti0::read(), reg::siomulti1::read(), reg::siomulti2::read(), reg::siomulti3::read() };
+        reg::siomlt_send::write( transfer( received, control.player_id ) );
+    }
+
+    /**
+     * Frame currently being simulated
+     */
+    [[nodiscard]]
+    uint32 frame() const noexcept {
+        return m_frame;
+    }
+
+    /**
+     * Frames of remote input buffered beyond the current frame; negative while stalled
+     */
+    [[nodiscard]]
+    int32 lead() const noexcept {
+        auto lowest = int32( Delay );
+        for ( unsigned ii = 0; ii < Players; ++ii ) {
+            if ( ii == m_self ) {
+                continue;
+            }
+            const auto ahead = int32( m_known[ii] - m_frame );
+            lowest = ahead < lowest ? ahead : lowest;
+        }
+        return lowest;
+    }
+
+    /**
+     * Mean lead in frames over the frames simulated, in 24.8 fixed point
+     */
+    [[nodiscard]]
+    uint32 average_lead() const noexcept {
+        return m_stats.frames ? ( m_stats.lead_total << 8 ) / m_stats.frames : 0;
+    }
+
+    [[nodiscard]]
+    bool desynced() const noexcept {
+        return m_stats.desyncs != 0;
+    }
+
+    [[nodiscard]]
+    const statistics& stats() const noexcept {
+        return m_stats;
+    }
+
+    [[nodiscard]]
+    unsigned player_id() const noexcept {
+        return m_self;
+    }
+
+private:
+    [[nodiscard]]
+    static constexpr uint16 fold( const uint32 sum ) noexcept {
+        const auto folded = uint16( ( sum ^ sum >> 10 ^ sum >> 20 ) & key_bits );
+        // A checksum word must never look like an idle transfer
+        return folded == key_bits ? 0 : folded;
+    }
+
+    // A peer that has sent input for frame n is simulating frame n - Delay or later, so it holds our input before that
+    [[nodiscard]]
+    uint32 oldest_unconfirmed() const noexcept {
+        auto oldest = uint32( m_newest );
+        for ( unsigned ii = 0; ii < Players; ++ii ) {
+            if ( ii == m_self ) {
+                continue;
+            }
+            const uint32 confirmed = m_known[ii] - Delay;
+            oldest = int32( confirmed - oldest ) < 0 ? confirmed : oldest;
+        }
+        return oldest;
+    }
+
+    // Match peers' checksums against our own; the sum is rolling, so any one comparison catches an earlier divergence
+    void compare() noexcept {
+        for ( unsigned ii = 0; ii < Players; ++ii ) {
+            uint16 word;
+            while ( m_sumsIn[ii].pop( word ) ) {
+                // Nearest frame to ours with this tag; peers may be a few frames ahead
+                auto offset = int32( ( ( word >> 10 ) - m_frame ) & tag_mask );
+                if ( offset >= int32( window / 2 ) ) {
+                    offset -= int32( window );
+                }
+                m_pendingFrame[ii] = m_frame + uint32( offset );
+                m_pendingSum[ii] = word;
+            }
+
+            if ( !m_pendingSum[ii] || int32( m_pendingFrame[ii] - m_frame ) >= 0 ) {
+                continue;
+            }
+            if ( m_frame - m_pendingFrame[ii] < window && m_sums[m_pendingFrame[ii] % window] != ( m_pendingSum[ii] & key_bits ) ) {
+                if ( !m_stats.desyncs ) {
+                    m_stats.first_desync = m_pendingFrame[ii];
+                }
+                ++m_stats.desyncs;
+            }
+            m_pendingSum[ii] = 0;
+        }
+    }
+
+    uint16 m_remote[4][window];
+    uint16 m_local[window];
+    uint16 m_sums[window];
+    ring_buffer<uint16, 4> m_sumsIn[4];
+    uint16 m_pendingSum[4];
+    uint32 m_pendingFrame[4];
+    volatile uint32 m_known[4];
+    statistics m_stats;
+    uint32 m_frame;
+    volatile uint32 m_newest;
+    uint32 m_rolling;
+    uint32 m_cursor;
+    volatile uint16 m_sumOut;
+    volatile unsigned m_self;
+};
+
+} // sio
+} // gba
+
+#endif // define GBAXX_SIO_LOCKSTEP_HPP
@@ -0,0 +1,221 @@
+#ifndef GBAXX_SIO_MULTIPLAYER_LINK_HPP
+#define GBAXX_SIO_MULTIPLAYER_LINK_HPP
+
+#include <gba/registers/sio.hpp>
+#include <gba/sio/multiplayer.hpp>
+#include <gba/sio/packet.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/ring_buffer.hpp>
+
+namespace gba {
+namespace sio {
+
+/**
+ * Packet link over multiplayer mode
+ *
+ * The serial interrupt only moves words between the SIO registers and ring buffers; framing, checksums and
+ * sequence checks run in poll() on the main loop. transfer() is the whole interrupt-side state machine and takes
+ * the received words as arguments, so several links can be wired into a simulated bus off-hardware.
+ * @tparam MaxPayload largest packet, in bytes
+ * @tparam TxWords send buffer, in 16-bit words (power of two)
+ * @tparam RxWords receive buffer per player, in 16-bit words (power of two)
+ */
+template <unsigned MaxPayload = 64, unsigned TxWords = 128, unsigned RxWords = 128>
+class multiplayer_link {
+    static_assert( packet::frame_words( MaxPayload ) <= TxWords, "multiplayer_link TxWords must hold the largest packet" );
+public:
+    static constexpr unsigned players = 4;
+
+    struct counters {
+        uint32 words;
+        uint32 overruns;
+        uint32 packets;
+        uint32 bytes;
+        uint32 checksum_errors;
+        uint32 sequence_errors;
+    };
+
+    constexpr multiplayer_link() noexcept : m_tx {}, m_rx {}, m_decoders {}, m_counters {}, m_sent {}, m_expected {}, m_remaining {}, m_txSequence {}, m_linkErrors {}, m_self {}, m_synced {} {}
+
+    /**
+     * Queue a packet; its words are published to the interrupt all at once
+     * @return false if the packet is too large or the send buffer lacks space
+     */
+    bool send( const void * data, const uint32 length ) noexcept {
+        if ( length > MaxPayload || m_tx.space() < packet::frame_words( length ) ) {
+            return false;
+        }
+
+        uint16 frame[packet::frame_words( MaxPayload )];
+        uint32 size = 0;
+        packet_encode( m_txSequence++, static_cast<const uint8 *>( data ), length, [&]( const uint16 word ) {
+            frame[size++] = word;
+        } );
+        m_tx.write( frame, size );
+
+        m_sent.packets += 1;
+        m_sent.bytes += length;
+        return true;
+    }
+
+    /**
+     * Decode received words
+     * @param handler called as handler( player, const uint8 * data, uint32 length ) for each valid packet
+     */
+    template <class Handler>
+    void poll( Handler&& handler ) noexcept {
+        for ( unsigned ii = 0; ii < players; ++ii ) {
+            auto& decoder = m_decoders[ii];
+            auto& count = m_counters[ii];
+
+            uint16 word;
+            while ( m_rx[ii].pop( word ) ) {
+                const auto result = decoder.feed( word );
+                if ( result == decltype( result )::error ) {
+                    ++count.checksum_errors;
+                    continue;
+                }
+                if ( result != decltype( result )::complete ) {
+                    continue;
+                }
+
+                if ( m_synced & ( 1u << ii ) ) {
+                    count.sequence_errors += uint16( decoder.sequence() - m_expected[ii] );
+                }
+                m_synced |= ( 1u << ii );
+                m_expected[ii] = uint16( decoder.sequence() + 1 );
+
+                ++count.packets;
+                count.bytes += decoder.size();
+                handler( ii, decoder.data(), decoder.size() );
+            }
+        }
+    }
+
+    /**
+     * Interrupt side: take one transfer's words and return the word to send next
+     *
+     * Words outside a frame are dropped here, so idle transfers do not fill the receive buffers.
+     * @param received the four SIOMULTI words
+     * @param self this console's player id, whose own word is skipped
+     */
+    uint16 transfer( const uint16 * received, const unsigned self ) noexcept {
+        m_self = self;
+        for ( unsigned ii = 0; ii < players; ++ii ) {
+            if ( ii == self ) {
+                continue;
+            }
+
+            const auto word = received[ii];
+            if ( m_remaining[ii] == 0 ) {
+                if ( ( word >> 8 ) != packet::sync ) {
+                    continue;
+                }
+                m_remaining[ii] = uint16( packet::frame_words( word & 0xff ) );
+            }
+            --m_remaining[ii];
+
+            ++m_counters[ii].words;
+            if ( !m_rx[ii].push( word ) ) {
+                ++m_counters[ii].overruns;
+            }
+        }
+
+        uint16 next;
+        if ( !m_tx.pop( next ) ) {
+            next = packet::idle;
+        }
+        return next;
+    }
+
+    /**
+     * Configure multiplayer mode with the serial interrupt enabled
+     */
+    void start( const multiplayer::baud_rate baudRate ) noexcept {
+        reg::rcnt<multiplayer>::write( {} );
+
+        auto control = control_type {};
+        control.baud_rate = baudRate;
+        control.irq_enable = true;
+        reg::siocnt<multiplayer>::write( control );
+        reg::siomlt_send::write( packet::idle );
+    }
+
+    /**
+     * Parent only: begin the next transfer, typically from a timer interrupt
+     *
+     * Pacing transfers gives children's interrupts time to load their next word.
+     * @return false if this console is a child, a transfer is running or a child is not ready
+     */
+    bool start_transfer() noexcept {
+        auto control = reg::siocnt<multiplayer>::read();
+        if ( control.input_terminal != multiplayer::input_terminal::parent || control.data_terminal != multiplayer::data_terminal::all_ready || control.transferring ) {
+            return false;
+        }
+
+        control.transferring = true;
+        reg::siocnt<multiplayer>::write( control );
+        return true;
+    }
+
+    /**
+     * Call from the serial interrupt handler
+     */
+    void on_serial() noexcept {
+        const auto control = reg::siocnt<multiplayer>::read();
+        if ( control.error ) {
+            ++m_linkErrors;
+        }
+
+        const uint16 received[players] = { reg::siomulti0::read(), reg::siomulti1::read(), reg::siomulti2::read(), reg::siomulti3::read() };
+        reg::siomlt_send::write( transfer( received, control.player_id ) );
+    }
+
+    [[nodiscard]]
+    const counters& received( const unsigned player ) const noexcept {
+        return m_counters[player];
+    }
+
+    [[nodiscard]]
+    const counters& sent() const noexcept {
+        return m_sent;
+    }
+
+    [[nodiscard]]
+    uint32 link_errors() const noexcept {
+        return m_linkErrors;
+    }
+
+    [[nodiscard]]
+    unsigned player_id() const noexcept {
+        return m_self;
+    }
+
+    void reset_counters() noexcept {
+        for ( auto& count : m_counters ) {
+            count = counters {};
+        }
+        m_sent = counters {};
+        m_linkErrors = 0;
+    }
+
+private:
+    using control_type = control<multiplayer>;
+
+    ring_buffer<uint16, TxWords> m_tx;
+    ring_buffer<uint16, RxWords> m_rx[players];
+    packet_decoder<MaxPayload> m_decoders[players];
+    counters m_counters[players];
+    counters m_sent;
+    uint16 m_expected[players];
+    uint16 m_remaining[players];
+    uint16 m_txSequence;
+    uint32 m_linkErrors;
+    unsigned m_self;
+    uint32 m_synced;
+};
+
+} // sio
+} // gba
+
+#endif // define GBAXX_SIO_MULTIPLAYER_LINK_HPP
@@ -0,0 +1,156 @@
+#ifndef GBAXX_SIO_PACKET_HPP
+#define GBAXX_SIO_PACKET_HPP
+
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+namespace sio {
+
+/**
+ * Framing of variable-length packets into a stream of 16-bit words
+ *
+ * A frame is: header (0xA5 << 8 | length), sequence number, ceil( length / 2 ) payload words (little-endian bytes),
+ * then a Fletcher-16 checksum over the sequence number and payload. Words outside a frame are ignored, so idle
+ * transfers and disconnected players (0xFFFF) never start one.
+ */
+struct packet {
+    static constexpr uint16 sync = 0xa5;
+    static constexpr uint16 idle = 0xffff;
+    static constexpr uint32 max_payload = 255;
+
+    [[nodiscard]]
+    static constexpr uint32 frame_words( const uint32 length ) noexcept {
+        return 3 + ( length + 1 ) / 2;
+    }
+};
+
+class fletcher16 {
+public:
+    constexpr fletcher16() noexcept : m_sum1 {}, m_sum2 {} {}
+
+    constexpr void update( const uint8 byte ) noexcept {
+        m_sum1 = uint16( ( m_sum1 + byte ) % 255 );
+        m_sum2 = uint16( ( m_sum2 + m_sum1 ) % 255 );
+    }
+
+    constexpr void update( const uint16 word ) noexcept {
+        update( uint8( word ) );
+        update( uint8( word >> 8 ) );
+    }
+
+    [[nodiscard]]
+    constexpr uint16 value() const noexcept {
+        return uint16( m_sum2 << 8 | m_sum1 );
+    }
+
+private:
+    uint16 m_sum1;
+    uint16 m_sum2;
+};
+
+/**
+ * Frame a packet
+ * @param output called with each word of the frame in order
+ */
+template <class Output>
+constexpr void packet_encode( const uint16 sequence, const uint8 * data, const uint32 length, Output&& output ) noexcept {
+    fletcher16 checksum;
+
+    output( uint16( packet::sync << 8 | length ) );
+    output( sequence );
+    checksum.update( sequence );
+    for ( uint32 ii = 0; ii < length; ii += 2 ) {
+        const auto word = uint16( data[ii] | ( ii + 1 < length ? data[ii + 1] << 8 : 0 ) );
+        checksum.update( word );
+        output( word );
+    }
+    output( checksum.value() );
+}
+
+/**
+ * Incremental frame parser for one sender
+ * @tparam MaxPayload largest payload accepted, in bytes
+ */
+template <unsigned MaxPayload>
+class packet_decoder {
+    static_assert( MaxPayload <= packet::max_payload, "packet_decoder MaxPayload must fit the 8-bit length" );
+
+    enum class state : uint8 {
+        hunt,
+        sequence,
+        payload,
+        checksum
+    };
+public:
+    enum class result : uint8 {
+        pending,
+        complete,
+        error
+    };
+
+    constexpr packet_decoder() noexcept : m_payload {}, m_checksum {}, m_length {}, m_received {}, m_sequence {}, m_state { state::hunt } {}
+
+    constexpr result feed( const uint16 word ) noexcept {
+        switch ( m_state ) {
+            case state::hunt:
+                if ( ( word >> 8 ) == packet::sync && ( word & 0xff ) <= MaxPayload ) {
+                    m_length = word & 0xff;
+                    m_received = 0;
+                    m_checksum = fletcher16 {};
+                    m_state = state::sequence;
+                }
+                return result::pending;
+            case state::sequence:
+                m_sequence = word;
+                m_checksum.update( word );
+                m_state = m_length ? state::payload : state::checksum;
+                return result::pending;
+            case state::payload:
+                m_checksum.update( word );
+                m_payload[m_received++] = uint8( word );
+                if ( m_received < m_length ) {
+                    m_payload[m_received++] = uint8( word >> 8 );
+                }
+                if ( m_received == m_length ) {
+                    m_state = state::checksum;
+                }
+                return result::pending;
+            case state::checksum:
+                m_state = state::hunt;
+                return word == m_checksum.value() ? result::complete : result::error;
+        }
+        return result::pending;
+    }
+
+    void reset() noexcept {
+        m_state = state::hunt;
+    }
+
+    [[nodiscard]]
+    const uint8 * data() const noexcept {
+        return m_payload;
+    }
+
+    [[nodiscard]]
+    uint32 size() const noexcept {
+        return m_length;
+    }
+
+    [[nodiscard]]
+    uint16 sequence() const noexcept {
+        return m_sequence;
+    }
+
+private:
+    uint8 m_payload[MaxPayload + 1];
+    fletcher16 m_checksum;
+    uint16 m_length;
+    uint16 m_received;
+    uint16 m_sequence;
+    state m_state;
+};
+
+} // sio
+} // gba
+
+#endif // define GBAXX_SIO_PACKET_HPP
@@ -0,0 +1,350 @@
+#ifndef GBAXX_SIO_UART_STREAM_HPP
+#define GBAXX_SIO_UART_STREAM_HPP
+
+#if __has_include( <version> )
+#include <version>
+#endif
+
+#if __cpp_lib_span
+#include <span>
+#endif
+
+#include <gba/registers/interrupt_control.hpp>
+#include <gba/registers/sio.hpp>
+#include <gba/sio/uart.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/ring_buffer.hpp>
+
+namespace gba {
+namespace sio {
+
+/**
+ * UART hardware with the 4 byte FIFOs enabled, 8N1
+ */
+class uart_port {
+public:
+    static constexpr uint32 fifo_size = 4;
+
+    void configure( const uart::baud_rate baudRate, const uart::clear_to_send cts ) noexcept {
+        reg::rcnt<uart>::write( {} );
+
+        auto control = sio::control<uart> {};
+        control.baud_rate = baudRate;
+        control.clear_to_send = cts;
+        control.data_length = uart::data_length::bits_8;
+        control.send_enable = true;
+        control.receive_enable = true;
+        control.irq_enable = true;
+        reg::siocnt<uart>::write( control );
+
+        // Enabling the FIFO after the other settings resets it
+        control.fifo_enable = true;
+        reg::siocnt<uart>::write( control );
+    }
+
+    [[nodiscard]]
+    bool can_send() const noexcept {
+        return !reg::siocnt<uart>::read().send_data;
+    }
+
+    [[nodiscard]]
+    bool can_receive() const noexcept {
+        return !reg::siocnt<uart>::read().receive_data;
+    }
+
+    void send( const uint8 value ) noexcept {
+        reg::siodata8::write( value );
+    }
+
+    [[nodiscard]]
+    uint8 receive() noexcept {
+        return reg::siodata8::read();
+    }
+
+    /**
+     * Framing or overrun error since the last call
+     */
+    [[nodiscard]]
+    bool error() noexcept {
+        return reg::siocnt<uart>::read().error;
+    }
+
+    /**
+     * Disabling the receiver raises RTS, which holds off a sender that honours CTS
+     */
+    void set_receive( const bool enable ) noexcept {
+        auto control = reg::siocnt<uart>::read();
+        control.receive_enable = enable;
+        reg::siocnt<uart>::write( control );
+    }
+
+    [[nodiscard]]
+    uint32 lock() noexcept {
+        const auto ime = reg::ime::read();
+        reg::ime::write( 0 );
+        return ime;
+    }
+
+    void unlock( const uint32 ime ) noexcept {
+        reg::ime::write( ime );
+    }
+};
+
+/**
+ * Pseudo-serial stand-in for uart_port, for driving a uart_stream off-hardware
+ *
+ * The test plays the remote end: transmit() shifts a byte out of the send FIFO and deliver() shifts one in.
+ * Neither raises an interrupt; call uart_stream::on_serial() afterwards as the hardware would.
+ */
+class host_uart_port {
+public:
+    static constexpr uint32 fifo_size = 4;
+
+    constexpr host_uart_port() noexcept : m_send {}, m_receive {}, m_clear {}, m_enabled {}, m_error {} {}
+
+    void configure( [[maybe_unused]] const uart::baud_rate baudRate, [[maybe_unused]] const uart::clear_to_send cts ) noexcept {
+        m_send.clear();
+        m_receive.clear();
+        m_clear = true;
+        m_enabled = true;
+        m_error = false;
+    }
+
+    [[nodiscard]]
+    bool can_send() const noexcept {
+        return !m_send.full();
+    }
+
+    [[nodiscard]]
+    bool can_receive() const noexcept {
+        return !m_receive.empty();
+    }
+
+    void send( const uint8 value ) noexcept {
+        if ( !m_send.push( value ) ) {
+            m_error = true;
+        }
+    }
+
+    [[nodiscard]]
+    uint8 receive() noexcept {
+        uint8 value = 0;
+        if ( !m_receive.pop( value ) ) {
+            m_error = true;
+        }
+        return value;
+    }
+
+    [[nodiscard]]
+    constexpr bool error() noexcept {
+        const auto error = m_error;
+        m_error = false;
+        return error;
+    }
+
+    constexpr void set_receive( const bool enable ) noexcept {
+        m_enabled = enable;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 lock() noexcept {
+        return 0;
+    }
+
+    constexpr void unlock( [[maybe_unused]] const uint32 ime ) noexcept {}
+
+    /**
+     * Remote side: CTS from the remote's RTS; while false nothing is transmitted
+     */
+    constexpr void set_clear_to_send( const bool clear ) noexcept {
+        m_clear = clear;
+    }
+
+    /**
+     * Remote side: shift one byte out of the send FIFO
+     * @return false if nothing is queued or CTS is held off
+     */
+    bool transmit( uint8& value ) noexcept {
+        return m_clear && m_send.pop( value );
+    }
+
+    /**
+     * Remote side: RTS; a well-behaved remote only delivers while this is true
+     */
+    [[nodiscard]]
+    bool ready_to_receive() const noexcept {
+        return m_enabled && !m_receive.full();
+    }
+
+    /**
+     * Remote side: shift one byte into the receive FIFO, flagging an overrun if it is full
+     * @return false if the byte was lost
+     */
+    bool deliver( const uint8 value ) noexcept {
+        if ( !m_receive.push( value ) ) {
+            m_error = true;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    ring_buffer<uint8, fifo_size> m_send;
+    ring_buffer<uint8, fifo_size> m_receive;
+    bool m_clear;
+    bool m_enabled;
+    bool m_error;
+};
+
+/**
+ * Buffered UART byte stream, drained by the serial interrupt
+ *
+ * write() and read() only touch the ring buffers and never wait. The interrupt handler tops the hardware FIFO up
+ * to 4 bytes at a time and empties the receive FIFO. When the receive buffer can no longer absorb a full FIFO the
+ * receiver is disabled, raising RTS so a CTS-honouring remote pauses, until read() makes room again.
+ * @tparam TxCapacity bytes of send buffer (power of two)
+ * @tparam RxCapacity bytes of receive buffer (power of two)
+ * @tparam Port uart_port, or host_uart_port off-hardware
+ */
+template <unsigned TxCapacity = 256, unsigned RxCapacity = 256, class Port = uart_port>
+class uart_stream {
+    static_assert( RxCapacity >= Port::fifo_size * 2, "uart_stream RxCapacity must hold at least two FIFOs" );
+public:
+    struct counters {
+        uint32 sent;
+        uint32 received;
+        uint32 errors;
+        uint32 throttles;
+    };
+
+    uart_stream( const uart_stream& ) = delete;
+    uart_stream& operator =( const uart_stream& ) = delete;
+
+    constexpr uart_stream() noexcept : m_tx {}, m_rx {}, m_port {}, m_counters {}, m_throttled {} {}
+
+    /**
+     * Configure the UART with the serial interrupt enabled
+     * @param cts when_sc_low holds transmission while the remote's RTS (our SC) is high
+     */
+    void start( const uart::baud_rate baudRate, const uart::clear_to_send cts = uart::clear_to_send::when_sc_low ) noexcept {
+        m_tx.clear();
+        m_rx.clear();
+        m_throttled = false;
+        m_port.configure( baudRate, cts );
+    }
+
+    /**
+     * Queue bytes for sending
+     * @return number of bytes queued, fewer than count if the send buffer fills
+     */
+    uint32 write( const uint8 * data, const uint32 count ) noexcept {
+        const auto n = m_tx.write( data, count );
+
+        // The send FIFO may already be empty, in which case no interrupt is coming to drain the buffer
+        const auto ime = m_port.lock();
+        fill();
+        m_port.unlock( ime );
+        return n;
+    }
+
+    /**
+     * Take received bytes
+     * @return number of bytes copied, 0 if nothing has arrived
+     */
+    uint32 read( uint8 * data, const uint32 count ) noexcept {
+        const auto n = m_rx.read( data, count );
+
+        if ( m_throttled && m_rx.space() >= RxCapacity / 2 ) {
+            const auto ime = m_port.lock();
+            m_throttled = false;
+            drain();
+            if ( !m_throttled ) {
+                m_port.set_receive( true );
+            }
+            m_port.unlock( ime );
+        }
+        return n;
+    }
+
+#if __cpp_lib_span
+    uint32 write( const std::span<const uint8> data ) noexcept {
+        return write( data.data(), data.size() );
+    }
+
+    uint32 read( const std::span<uint8> data ) noexcept {
+        return read( data.data(), data.size() );
+    }
+#endif
+
+    /**
+     * Call from the serial interrupt handler
+     */
+    void on_serial() noexcept {
+        if ( m_port.error() ) {
+            ++m_counters.errors;
+        }
+        drain();
+        fill();
+    }
+
+    /**
+     * Bytes still waiting to be handed to the hardware
+     */
+    [[nodiscard]]
+    uint32 pending() const noexcept {
+        return m_tx.size();
+    }
+
+    [[nodiscard]]
+    uint32 available() const noexcept {
+        return m_rx.size();
+    }
+
+    [[nodiscard]]
+    bool throttled() const noexcept {
+        return m_throttled;
+    }
+
+    [[nodiscard]]
+    const counters& stats() const noexcept {
+        return m_counters;
+    }
+
+    [[nodiscard]]
+    Port& port() noexcept {
+        return m_port;
+    }
+
+private:
+    void fill() noexcept {
+        uint8 value;
+        while ( m_port.can_send() && m_tx.pop( value ) ) {
+            m_port.send( value );
+            ++m_counters.sent;
+        }
+    }
+
+    void drain() noexcept {
+        while ( m_port.can_receive() && !m_rx.full() ) {
+            m_rx.push( m_port.receive() );
+            ++m_counters.received;
+        }
+
+        if ( !m_throttled && m_rx.space() < Port::fifo_size ) {
+            m_throttled = true;
+            ++m_counters.throttles;
+            m_port.set_receive( false );
+        }
+    }
+
+    ring_buffer<uint8, TxCapacity> m_tx;
+    ring_buffer<uint8, RxCapacity> m_rx;
+    Port m_port;
+    counters m_counters;
+    volatile bool m_throttled;
+};
+
+} // sio
+} // gba
+
+#endif // define GBAXX_SIO_UART_STREAM_HPP
@@ -0,0 +1,266 @@
+#ifndef GBAXX_SOUND_MIXER_HPP
+#define GBAXX_SOUND_MIXER_HPP
+
+#include <gba/dma/dma_control.hpp>
+#include <gba/registers/dma.hpp>
+#include <gba/registers/sound.hpp>
+#include <gba/system/iwram.hpp>
+#include <gba/time/timer_control.hpp>
+#include <gba/types/cycles.hpp>
+#include <gba/types/fixed_point_make.hpp>
+#include <gba/types/int_cast.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/memmap.hpp>
+
+namespace gba {
+namespace sound {
+
+/**
+ * Source samples advanced per output sample
+ */
+using mixer_step = make_ufixed<20, 12>;
+
+struct mixer_channel {
+    const int8 * data;
+    uint32 position;
+    uint32 step;
+    uint32 end;
+    uint32 loop_length;
+    uint8 volume_left;
+    uint8 volume_right;
+    bool playing;
+};
+
+/**
+ * Accumulate channels into 32-bit sums; positions, steps and lengths are 20.12 fixed point
+ *
+ * Channel volumes are 0 to 64, so each channel contributes up to 127 * 64 per sample. One-shot channels that
+ * reach their end stop playing; looping channels wrap back by loop_length.
+ */
+[[GBAXX_IWRAM_ARM]]
+inline void mix_channels( mixer_channel * channels, const unsigned count, int32 * left, int32 * right, const unsigned samples ) noexcept {
+    for ( unsigned ii = 0; ii < samples; ++ii ) {
+        left[ii] = 0;
+        right[ii] = 0;
+    }
+
+    for ( unsigned cc = 0; cc < count; ++cc ) {
+        auto& channel = channels[cc];
+        if ( !channel.playing ) {
+            continue;
+        }
+
+        const auto * data = channel.data;
+        const int volumeLeft = channel.volume_left;
+        const int volumeRight = channel.volume_right;
+        auto position = channel.position;
+        for ( unsigned ii = 0; ii < samples; ++ii ) {
+            if ( position >= channel.end ) {
+                if ( !channel.loop_length ) {
+                    channel.playing = false;
+                    break;
+                }
+                do {
+                    position -= channel.loop_length;
+                } while ( position >= channel.end );
+            }
+
+            const int sample = data[position >> 12];
+            left[ii] += sample * volumeLeft;
+            right[ii] += sample * volumeRight;
+            position += channel.step;
+        }
+        channel.position = position;
+    }
+}
+
+/**
+ * Scale accumulated sums back to 8-bit samples, saturating
+ */
+[[GBAXX_IWRAM_ARM]]
+inline void mix_resolve( const int32 * accumulator, int8 * output, const unsigned samples ) noexcept {
+    for ( unsigned ii = 0; ii < samples; ++ii ) {
+        auto value = accumulator[ii] >> 6;
+        if ( value > 127 ) {
+            value = 127;
+        } else if ( value < -128 ) {
+            value = -128;
+        }
+        output[ii] = int8( value );
+    }
+}
+
+/**
+ * Software mixer streaming stereo 8-bit PCM through Direct Sound
+ *
+ * FIFO A plays the left side through DMA1, FIFO B the right side through DMA2, both clocked by one timer.
+ * Each side is two frames of samples back to back: DMA plays one page while mix() fills the other.
+ * Call vblank() at the start of every VBlank, then mix() once during the frame.
+ * @tparam Channels number of voices
+ * @tparam Samples samples per frame; must divide a frame's cycles evenly and be a multiple of 16 (304 is 18157Hz)
+ * @tparam Timer timer 0 or 1
+ */
+template <unsigned Channels, unsigned Samples = 304, unsigned Timer = 0>
+class mixer {
+    static_assert( Channels > 0, "mixer needs at least one channel" );
+    static_assert( Samples % 16 == 0, "mixer Samples must be a multiple of 16" );
+    static_assert( cycles_per_frame.count() % Samples == 0, "mixer Samples must divide the frame evenly" );
+    static_assert( Timer < 2, "Direct Sound can only be clocked by timer 0 or 1" );
+
+    using timer_register = iomemmap<timer_counter_control, 0x4000100 + Timer * 4>;
+public:
+    static constexpr int none = -1;
+    static constexpr uint32 sample_period = cycles_per_frame.count() / Samples;
+    static constexpr uint32 sample_rate = cycles_per_second.count() / sample_period;
+
+    /**
+     * Step that plays a sample recorded at sampleRate at its original pitch
+     */
+    static constexpr mixer_step step_for( const uint32 sampleRate ) noexcept {
+        return mixer_step::from_data( ( sampleRate * sample_period + 0x800 ) >> 12 );
+    }
+
+    mixer() noexcept : m_channels {}, m_accumulator {}, m_left {}, m_right {}, m_playing {} {}
+
+    /**
+     * Play a sample on the first free channel at full volume, centered
+     * @param loopLength samples repeated from the end, at most length; 0 plays once
+     * @return channel, or none if all channels are playing
+     */
+    int play( const int8 * data, const uint32 length, const mixer_step step, const uint32 loopLength = 0 ) noexcept {
+        for ( unsigned ii = 0; ii < Channels; ++ii ) {
+            if ( !m_channels[ii].playing ) {
+                play( ii, data, length, step, loopLength );
+                set_volume( ii, 64, 0 );
+                return int( ii );
+            }
+        }
+        return none;
+    }
+
+    void play( const unsigned channel, const int8 * data, const uint32 length, const mixer_step step, const uint32 loopLength = 0 ) noexcept {
+        auto& c = m_channels[channel];
+        c.data = data;
+        c.position = 0;
+        c.step = step.data();
+        c.end = length << 12;
+        c.loop_length = ( loopLength < length ? loopLength : length ) << 12;
+        c.playing = true;
+    }
+
+    void stop( const unsigned channel ) noexcept {
+        m_channels[channel].playing = false;
+    }
+
+    /**
+     * @param volume 0 to 64
+     * @param pan -64 (left) to 64 (right)
+     */
+    void set_volume( const unsigned channel, const uint32 volume, const int32 pan ) noexcept {
+        m_channels[channel].volume_left = uint8( volume * uint32( pan > 0 ? 64 - pan : 64 ) / 64 );
+        m_channels[channel].volume_right = uint8( volume * uint32( pan < 0 ? 64 + pan : 64 ) / 64 );
+    }
+
+    void set_step( const unsigned channel, const mixer_step step ) noexcept {
+        m_channels[channel].step = step.data();
+    }
+
+    [[nodiscard]]
+    bool playing( const unsigned channel ) const noexcept {
+        return m_channels[channel].playing;
+    }
+
+    /**
+     * Mix every channel into the page that is not playing
+     */
+    void mix() noexcept {
+        const auto page = ( m_playing ^ 1u ) * Samples;
+
+        mix_channels( m_channels, Channels, m_accumulator[0], m_accumulator[1], Samples );
+        mix_resolve( m_accumulator[0], m_left + page, Samples );
+        mix_resolve( m_accumulator[1], m_right + page, Samples );
+    }
+
+    [[nodiscard]]
+    const int8 * mixed_left() const noexcept {
+        return m_left + ( m_playing ^ 1u ) * Samples;
+    }
+
+    [[nodiscard]]
+    const int8 * mixed_right() const noexcept {
+        return m_right + ( m_playing ^ 1u ) * Samples;
+    }
+
+    /**
+     * Enable Direct Sound and start streaming; call right after VBlank
+     */
+    void start() noexcept {
+        reg::sndstat::write( { .enable_sounds = true } );
+
+        auto control = reg::snddscnt::read();
+        control.volume_soundA = directsound_volume::full;
+        control.volume_soundB = directsound_volume::full;
+        control.enable_soundA_right = false;
+        control.enable_soundA_left = true;
+        control.timer_soundA = Timer;
+        control.reset_soundA = true;
+        control.enable_soundB_right = true;
+        control.enable_soundB_left = false;
+        control.timer_soundB = Timer;
+        control.reset_soundB = true;
+        reg::snddscnt::write( control );
+
+        m_playing = 0;
+        restart();
+
+        timer_register::write( {} );
+        timer_register::write( { uint16( 0x10000 - sample_period ), { .enable = true } } );
+    }
+
+    void stop() noexcept {
+        timer_register::write( {} );
+        reg::dma1cnt_h::write( {} );
+        reg::dma2cnt_h::write( {} );
+    }
+
+    /**
+     * Flip pages; DMA runs on from page 0 into page 1, and is pointed back at page 0 after page 1 has played
+     */
+    void vblank() noexcept {
+        if ( m_playing ) {
+            restart();
+        }
+        m_playing ^= 1u;
+    }
+
+private:
+    void restart() noexcept {
+        constexpr auto control = dma_control {
+            .destination_control = dma_control::destination_address::fixed,
+            .repeat = true,
+            .type = dma_control::type::word,
+            .start_condition = dma_control::start::sound_fifo,
+            .enable = true
+        };
+
+        reg::dma1cnt_h::write( {} );
+        reg::dma2cnt_h::write( {} );
+        reg::dma1sad::write( address_cast( m_left ) );
+        reg::dma1dad::write( reg::fifo_a::address );
+        reg::dma2sad::write( address_cast( m_right ) );
+        reg::dma2dad::write( reg::fifo_b::address );
+        reg::dma1cnt_h::write( control );
+        reg::dma2cnt_h::write( control );
+    }
+
+    mixer_channel m_channels[Channels];
+    int32 m_accumulator[2][Samples];
+    alignas( 4 ) int8 m_left[Samples * 2];
+    alignas( 4 ) int8 m_right[Samples * 2];
+    uint32 m_playing;
+};
+
+} // sound
+} // gba
+
+#endif // define GBAXX_SOUND_MIXER_HPP
@@ -0,0 +1,626 @@
+#ifndef GBAXX_SOUND_MUSIC_PLAYER_HPP
+#define GBAXX_SOUND_MUSIC_PLAYER_HPP
+
+#include <array>
+#include <cstring>
+
+#include <gba/registers/sound.hpp>
+#include <gba/sound/direct.hpp>
+#include <gba/sound/dmg.hpp>
+#include <gba/sound/sound.hpp>
+#include <gba/types/int_cast.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+namespace sound {
+
+enum class music_effect : uint8 {
+    none = 0,
+    set_volume = 1,
+    volume_slide = 2,
+    slide_up = 3,
+    slide_down = 4,
+    set_speed = 5,
+    jump = 6,
+    pattern_break = 7,
+    note_cut = 8
+};
+
+/**
+ * One channel of one pattern row
+ *
+ * note 1 is C2, 72 is B7; 0 continues the previous note and note_off silences the channel.
+ * instrument is 1-based; 0 keeps the channel's instrument.
+ */
+struct music_cell {
+    static constexpr uint8 note_off = 0xff;
+
+    uint8 note;
+    uint8 instrument;
+    music_effect effect;
+    uint8 parameter;
+};
+
+static_assert( sizeof( music_cell ) == 4, "music_cell must be tightly packed" );
+
+/**
+ * Instrument settings; a channel only reads the fields for its kind
+ */
+struct music_instrument {
+    uint8 volume;
+    sound::duty duty;
+    sound::step envelope_step;
+    sound::direction envelope_direction;
+    sound::counter_stages noise_stages;
+    const sound::wave_ram * wave;
+    const int8 * sample;
+    uint32 sample_length;
+    uint32 loop_length;
+    uint32 sample_rate;
+};
+
+struct music_pattern {
+    const music_cell * cells;
+    uint16 rows;
+};
+
+/**
+ * Song in ROM; each pattern holds rows * channels cells, row-major
+ *
+ * Channels 0 to 3 are square 1, square 2, wave and noise; further channels are Direct Sound PCM voices.
+ */
+struct music_song {
+    const uint8 * order;
+    uint16 order_length;
+    uint16 restart;
+    const music_pattern * patterns;
+    const music_instrument * instruments;
+    uint8 channels;
+    uint8 speed;
+};
+
+namespace detail {
+
+constexpr double music_note_hz( const int note ) noexcept {
+    // Note 1 is C2
+    double hz = 65.40639;
+    for ( int ii = 1; ii < note; ++ii ) {
+        hz *= 1.0594630943592953;
+    }
+    return hz;
+}
+
+template <int Numerator>
+constexpr auto music_rate_table() noexcept {
+    std::array<uint16, 73> table {};
+    for ( int ii = 1; ii < 73; ++ii ) {
+        table[ii] = uint16( 2048 - int( Numerator / music_note_hz( ii ) + 0.5 ) );
+    }
+    return table;
+}
+
+// Semitone ratios in 16.16 fixed point
+constexpr uint32 music_semitone[12] = { 65536, 69433, 73562, 77936, 82570, 87480, 92682, 98193, 104032, 110218, 116772, 123715 };
+
+} // detail
+
+/**
+ * Frequency register values for square (131072 / ( 2048 - x ) Hz) and wave (65536 / ( 2048 - x ) Hz) channels
+ */
+constexpr auto music_square_rate = detail::music_rate_table<131072>();
+constexpr auto music_wave_rate = detail::music_rate_table<65536>();
+
+/**
+ * Output that writes the sound registers directly
+ */
+struct register_output {
+    template <class Register>
+    void write( const typename Register::type& value ) noexcept {
+        Register::write( value );
+    }
+};
+
+/**
+ * Output that writes the sound registers and plays PCM channels on a sound::mixer
+ */
+template <class Mixer>
+class mixer_output : public register_output {
+public:
+    explicit mixer_output( Mixer& mixer ) noexcept : m_mixer { &mixer } {}
+
+    void pcm_play( const unsigned voice, const int8 * data, const uint32 length, const uint32 loopLength, const uint32 rate ) noexcept {
+        m_mixer->play( voice, data, length, Mixer::step_for( rate ), loopLength );
+    }
+
+    void pcm_rate( const unsigned voice, const uint32 rate ) noexcept {
+        m_mixer->set_step( voice, Mixer::step_for( rate ) );
+    }
+
+    void pcm_volume( const unsigned voice, const uint32 volume ) noexcept {
+        m_mixer->set_volume( voice, volume, 0 );
+    }
+
+    void pcm_stop( const unsigned voice ) noexcept {
+        m_mixer->stop( voice );
+    }
+
+private:
+    Mixer * m_mixer;
+};
+
+/**
+ * Output that records every write, for checking playback off-hardware
+ *
+ * Registers wider than 32 bits are logged as consecutive words. PCM calls are logged at pcm_address + voice with
+ * the rate (play and pcm_rate), volume or 0 (stop) as value.
+ * @tparam Capacity writes kept; later writes are counted but dropped
+ */
+template <unsigned Capacity>
+class register_log {
+public:
+    static constexpr uint32 pcm_address = 0x10000000;
+
+    struct entry {
+        uint32 address;
+        uint32 value;
+    };
+
+    constexpr register_log() noexcept : m_entries {}, m_size {} {}
+
+    template <class Register>
+    void write( const typename Register::type& value ) noexcept {
+        if constexpr ( sizeof( value ) <= 4 ) {
+            push( Register::address, uint32( uint_cast( value ) ) );
+        } else {
+            uint32 words[sizeof( value ) / 4];
+            std::memcpy( words, &value, sizeof( words ) );
+            for ( unsigned ii = 0; ii < sizeof( value ) / 4; ++ii ) {
+                push( Register::address + ii * 4, words[ii] );
+            }
+        }
+    }
+
+    void pcm_play( const unsigned voice, const int8 *, const uint32, const uint32, const uint32 rate ) noexcept {
+        push( pcm_address + voice, rate );
+    }
+
+    void pcm_rate( const unsigned voice, const uint32 rate ) noexcept {
+        push( pcm_address + voice, rate );
+    }
+
+    void pcm_volume( const unsigned voice, const uint32 volume ) noexcept {
+        push( pcm_address + voice, volume );
+    }
+
+    void pcm_stop( const unsigned voice ) noexcept {
+        push( pcm_address + voice, 0 );
+    }
+
+    void clear() noexcept {
+        m_size = 0;
+    }
+
+    [[nodiscard]]
+    uint32 size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]]
+    const entry& operator []( const uint32 index ) const noexcept {
+        return m_entries[index];
+    }
+
+private:
+    void push( const uint32 address, const uint32 value ) noexcept {
+        if ( m_size < Capacity ) {
+            m_entries[m_size] = entry { address, value };
+        }
+        ++m_size;
+    }
+
+    entry m_entries[Capacity];
+    uint32 m_size;
+};
+
+/**
+ * Pattern sequencer driving the DMG channels and optional Direct Sound PCM voices
+ *
+ * Call tick() once per frame. A tick decodes at most one row and touches each channel once, so its cost is
+ * O( Channels ) register writes; last_tick_writes() and peak_tick_writes() measure it.
+ * @tparam Output register_output, mixer_output or register_log; PCM voices need the pcm_ functions
+ * @tparam Channels 4 DMG channels plus any PCM voices
+ */
+template <class Output, unsigned Channels = 4>
+class music_player {
+    static_assert( Channels >= 4, "music_player needs the four DMG channels" );
+
+    struct voice {
+        uint32 rate;
+        const music_instrument * instrument;
+        uint8 volume;
+        music_effect effect;
+        uint8 parameter;
+        bool active;
+    };
+public:
+    explicit music_player( Output output = {} ) noexcept : m_output { output }, m_song {}, m_voices {}, m_order {}, m_row {}, m_tick {}, m_speed {}, m_jumpOrder {}, m_jumpRow {}, m_jump {}, m_writes {}, m_peakWrites {} {}
+
+    void play( const music_song& song ) noexcept {
+        m_song = &song;
+        m_order = 0;
+        m_row = 0;
+        m_tick = 0;
+        m_speed = song.speed ? song.speed : 6;
+        m_jump = false;
+        m_peakWrites = 0;
+        for ( auto& v : m_voices ) {
+            v = voice {};
+        }
+
+        write<reg::sndstat>( { .enable_sounds = true } );
+        write<reg::snddmgcnt>( {
+            .volume_right = 7, .volume_left = 7,
+            .right_square1 = true, .right_square2 = true, .right_wave = true, .right_noise = true,
+            .left_square1 = true, .left_square2 = true, .left_wave = true, .left_noise = true
+        } );
+        write<reg::snd1sweep>( {} );
+    }
+
+    void stop() noexcept {
+        if ( !m_song ) {
+            return;
+        }
+        for ( unsigned ii = 0; ii < Channels; ++ii ) {
+            silence( ii );
+        }
+        m_song = nullptr;
+    }
+
+    void tick() noexcept {
+        if ( !m_song ) {
+            return;
+        }
+
+        m_writes = 0;
+        if ( m_tick == 0 ) {
+            process_row();
+        } else {
+            process_effects();
+        }
+
+        if ( ++m_tick >= m_speed ) {
+            m_tick = 0;
+            advance_row();
+        }
+
+        if ( m_writes > m_peakWrites ) {
+            m_peakWrites = m_writes;
+        }
+    }
+
+    [[nodiscard]]
+    bool playing() const noexcept {
+        return m_song != nullptr;
+    }
+
+    [[nodiscard]]
+    uint32 order() const noexcept {
+        return m_order;
+    }
+
+    [[nodiscard]]
+    uint32 row() const noexcept {
+        return m_row;
+    }
+
+    [[nodiscard]]
+    uint32 last_tick_writes() const noexcept {
+        return m_writes;
+    }
+
+    [[nodiscard]]
+    uint32 peak_tick_writes() const noexcept {
+        return m_peakWrites;
+    }
+
+    [[nodiscard]]
+    Output& output() noexcept {
+        return m_output;
+    }
+
+private:
+    /**
+     * Counted like register_log: one write per register, or per word of registers wider than 32 bits
+     */
+    template <class Register>
+    void write( const typename Register::type& value ) noexcept {
+        m_writes += sizeof( value ) <= 4 ? 1 : uint32( sizeof( value ) / 4 );
+        m_output.template write<Register>( value );
+    }
+
+    void process_row() noexcept {
+        const auto& pattern = m_song->patterns[m_song->order[m_order]];
+        const auto * cells = pattern.cells + m_row * m_song->channels;
+
+        for ( unsigned ii = 0; ii < Channels && ii < m_song->channels; ++ii ) {
+            const auto& cell = cells[ii];
+            auto& v = m_voices[ii];
+
+            v.effect = cell.effect;
+            v.parameter = cell.parameter;
+            if ( cell.instrument ) {
+                v.instrument = &m_song->instruments[cell.instrument - 1];
+                v.volume = clamp_volume( ii, v.instrument->volume );
+            }
+
+            switch ( cell.effect ) {
+                case music_effect::set_volume:
+                    v.volume = clamp_volume( ii, cell.parameter );
+                    break;
+                case music_effect::set_speed:
+                    m_speed = cell.parameter ? cell.parameter : 1;
+                    break;
+                case music_effect::jump:
+                    m_jump = true;
+                    m_jumpOrder = cell.parameter;
+                    m_jumpRow = 0;
+                    break;
+                case music_effect::pattern_break:
+                    m_jump = true;
+                    m_jumpOrder = m_order + 1;
+                    m_jumpRow = cell.parameter;
+                    break;
+                default:
+                    break;
+            }
+
+            if ( cell.note == music_cell::note_off ) {
+                silence( ii );
+            } else if ( cell.note && v.instrument ) {
+                v.rate = ii < 4 ? note_rate( ii, cell.note ) : pcm_rate( v.instrument->sample_rate, cell.note );
+                v.active = true;
+                trigger( ii );
+            } else if ( cell.effect == music_effect::set_volume && v.active ) {
+                trigger( ii );
+            }
+        }
+    }
+
+    void process_effects() noexcept {
+        for ( unsigned ii = 0; ii < Channels; ++ii ) {
+            auto& v = m_voices[ii];
+            if ( !v.active ) {
+                continue;
+            }
+
+            switch ( v.effect ) {
+                case music_effect::slide_up:
+                    v.rate = slide( ii, v.rate, int( v.parameter ) );
+                    update_rate( ii );
+                    break;
+                case music_effect::slide_down:
+                    v.rate = slide( ii, v.rate, -int( v.parameter ) );
+                    update_rate( ii );
+                    break;
+                case music_effect::volume_slide: {
+                    const auto volume = int( v.volume ) + int( v.parameter >> 4 ) - int( v.parameter & 0xf );
+                    const auto clamped = clamp_volume( ii, volume < 0 ? 0 : volume );
+                    if ( clamped != v.volume ) {
+                        v.volume = clamped;
+                        trigger( ii );
+                    }
+                    break;
+                }
+                case music_effect::note_cut:
+                    if ( m_tick == v.parameter ) {
+                        silence( ii );
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    void advance_row() noexcept {
+        if ( m_jump ) {
+            m_jump = false;
+            m_order = m_jumpOrder;
+            m_row = m_jumpRow;
+        } else if ( ++m_row >= m_song->patterns[m_song->order[m_order]].rows ) {
+            ++m_order;
+            m_row = 0;
+        }
+
+        if ( m_order >= m_song->order_length ) {
+            m_order = m_song->restart;
+        }
+        if ( m_row >= m_song->patterns[m_song->order[m_order]].rows ) {
+            m_row = 0;
+        }
+    }
+
+    /**
+     * DMG envelopes are 4-bit (0 to 15), PCM voices 0 to 64
+     */
+    static uint8 clamp_volume( const unsigned channel, const int volume ) noexcept {
+        const auto maximum = channel < 4 ? 15 : 64;
+        return uint8( volume > maximum ? maximum : volume );
+    }
+
+    static uint32 note_rate( const unsigned channel, const uint8 note ) noexcept {
+        if ( channel < 2 ) {
+            return music_square_rate[note];
+        }
+        if ( channel == 2 ) {
+            return music_wave_rate[note];
+        }
+        return note;
+    }
+
+    uint32 slide( const unsigned channel, const uint32 rate, const int amount ) const noexcept {
+        if ( channel == 3 ) {
+            const auto n = int( rate ) + ( amount > 0 ? 1 : -1 );
+            return uint32( n < 1 ? 1 : ( n > 72 ? 72 : n ) );
+        }
+        if ( channel > 3 ) {
+            const auto r = int( rate ) + amount * 16;
+            return uint32( r < 1 ? 1 : r );
+        }
+        const auto r = int( rate ) + amount;
+        return uint32( r < 0 ? 0 : ( r > 2047 ? 2047 : r ) );
+    }
+
+    /**
+     * Restart the note with the channel's instrument, volume and rate
+     */
+    void trigger( const unsigned channel ) noexcept {
+        const auto& v = m_voices[channel];
+        const auto& instrument = *v.instrument;
+
+        switch ( channel ) {
+            case 0:
+            case 1: {
+                const auto control = square_control { .duty = instrument.duty, .step = instrument.envelope_step, .direction = instrument.envelope_direction, .volume = uint16( v.volume ) };
+                const auto frequency = square_frequency { .frequency = uint16( v.rate ), .reset = true };
+                if ( channel == 0 ) {
+                    write<reg::snd1cnt>( control );
+                    write<reg::snd1freq>( frequency );
+                } else {
+                    write<reg::snd2cnt>( control );
+                    write<reg::snd2freq>( frequency );
+                }
+                break;
+            }
+            case 2:
+                if ( instrument.wave ) {
+                    // Wave RAM writes go to the bank that is not playing
+                    write<reg::snd3sel>( { .current_bank = 1 } );
+                    write<reg::wave_ram>( *instrument.wave );
+                }
+                write<reg::snd3sel>( { .current_bank = 0, .enable = true } );
+                write<reg::snd3cnt>( wave_control { .volume = wave_level( v.volume ) } );
+                write<reg::snd3freq>( { .frequency = uint16( v.rate ), .reset = true } );
+                break;
+            case 3:
+                write<reg::snd4cnt>( noise_control { .step = instrument.envelope_step, .direction = instrument.envelope_direction, .volume = uint16( v.volume ) } );
+                write<reg::snd4freq>( noise_rate( v.rate, instrument.noise_stages, true ) );
+                break;
+            default:
+                if constexpr ( Channels > 4 ) {
+                    m_output.pcm_play( channel - 4, instrument.sample, instrument.sample_length, instrument.loop_length, v.rate );
+                    m_output.pcm_volume( channel - 4, v.volume );
+                    m_writes += 2;
+                }
+                break;
+        }
+    }
+
+    void update_rate( const unsigned channel ) noexcept {
+        const auto& v = m_voices[channel];
+        switch ( channel ) {
+            case 0:
+                write<reg::snd1freq>( { .frequency = uint16( v.rate ) } );
+                break;
+            case 1:
+                write<reg::snd2freq>( { .frequency = uint16( v.rate ) } );
+                break;
+            case 2:
+                write<reg::snd3freq>( { .frequency = uint16( v.rate ) } );
+                break;
+            case 3:
+                write<reg::snd4freq>( noise_rate( v.rate, v.instrument->noise_stages, false ) );
+                break;
+            default:
+                if constexpr ( Channels > 4 ) {
+                    m_output.pcm_rate( channel - 4, v.rate );
+                    ++m_writes;
+                }
+                break;
+        }
+    }
+
+    void silence( const unsigned channel ) noexcept {
+        m_voices[channel].active = false;
+        switch ( channel ) {
+            case 0:
+                write<reg::snd1cnt>( {} );
+                write<reg::snd1freq>( { .reset = true } );
+                break;
+            case 1:
+                write<reg::snd2cnt>( {} );
+                write<reg::snd2freq>( { .reset = true } );
+                break;
+            case 2:
+                write<reg::snd3sel>( {} );
+                break;
+            case 3:
+                write<reg::snd4cnt>( {} );
+                write<reg::snd4freq>( { .reset = true } );
+                break;
+            default:
+                if constexpr ( Channels > 4 ) {
+                    m_output.pcm_stop( channel - 4 );
+                    ++m_writes;
+                }
+                break;
+        }
+    }
+
+    static wave_volume wave_level( const uint8 volume ) noexcept {
+        if ( volume >= 14 ) {
+            return wave_volume::full;
+        }
+        if ( volume >= 10 ) {
+            return wave_volume::three_quarters;
+        }
+        if ( volume >= 6 ) {
+            return wave_volume::half;
+        }
+        if ( volume >= 2 ) {
+            return wave_volume::quarter;
+        }
+        return wave_volume::zero;
+    }
+
+    /**
+     * Noise notes step through dividers within each shift, so higher notes are higher pitched
+     */
+    static noise_frequency noise_rate( const uint32 note, const counter_stages stages, const bool reset ) noexcept {
+        const auto n = note - 1;
+        return noise_frequency {
+            .clock_multiplier = clock_multiplier( 7 - ( n % 6 ) ),
+            .counter_stages = stages,
+            .shift_frequency = uint16( 13 - ( n / 6 ) ),
+            .reset = reset
+        };
+    }
+
+    /**
+     * Playback rate for a sample recorded at sampleRate as C4 (note 25)
+     */
+    static uint32 pcm_rate( const uint32 sampleRate, const uint8 note ) noexcept {
+        const auto semitone = int( note ) - 1;
+        const auto octave = semitone / 12 - 2;
+        const auto rate = ( sampleRate * ( detail::music_semitone[semitone % 12] >> 4 ) ) >> 12;
+        return octave < 0 ? rate >> -octave : rate << octave;
+    }
+
+    Output m_output;
+    const music_song * m_song;
+    voice m_voices[Channels];
+    uint32 m_order;
+    uint32 m_row;
+    uint32 m_tick;
+    uint32 m_speed;
+    uint32 m_jumpOrder;
+    uint32 m_jumpRow;
+    bool m_jump;
+    uint32 m_writes;
+    uint32 m_peakWrites;
+};
+
+} // sound
+} // gba
+
+#endif // define GBAXX_SOUND_MUSIC_PLAYER_HPP
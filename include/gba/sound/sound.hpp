@@ -13,6 +13,7 @@ struct status {
         is_playing_noise : 1;
     uint16 : 3;
     bool enable_sounds : 1;
+    uint16 : 8;
 };
 
 static_assert( sizeof( status ) == 2, "status must be tightly packed" );
@@ -0,0 +1,16 @@
+#ifndef GBAXX_SYSTEM_IWRAM_HPP
+#define GBAXX_SYSTEM_IWRAM_HPP
+
+/**
+ * Attributes for hot inner loops: ARM code placed in IWRAM (32-bit bus, no wait states)
+ *
+ * Usage: [[GBAXX_IWRAM_ARM]] inline void kernel();
+ * Requires a linker script that copies .iwram sections, such as devkitARM's. Off-target only noinline remains.
+ */
+#if defined( __arm__ ) || defined( __thumb__ )
+#define GBAXX_IWRAM_ARM gnu::section( ".iwram" ), gnu::target( "arm" ), gnu::noinline
+#else
+#define GBAXX_IWRAM_ARM gnu::noinline
+#endif
+
+#endif // define GBAXX_SYSTEM_IWRAM_HPP
@@ -0,0 +1,188 @@
+#ifndef GBAXX_SYSTEM_POWER_MANAGER_HPP
+#define GBAXX_SYSTEM_POWER_MANAGER_HPP
+
+#include <gba/bios/halt.hpp>
+#include <gba/keypad/keypad_manager.hpp>
+#include <gba/registers/display.hpp>
+#include <gba/registers/interrupt_control.hpp>
+#include <gba/registers/keypad_input.hpp>
+#include <gba/registers/sound.hpp>
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+
+/**
+ * Counts consecutive frames without a key held
+ */
+class idle_tracker {
+public:
+    static constexpr uint32 key_bits = 0x3ff;
+
+    explicit constexpr idle_tracker( const uint32 timeoutFrames ) noexcept : m_timeout { timeoutFrames }, m_idle {} {}
+
+    /**
+     * Record one frame
+     * @param pressed keys held this frame
+     * @return true once the timeout has been reached
+     */
+    constexpr bool update( const key_mask pressed ) noexcept {
+        if ( pressed & key_bits ) {
+            m_idle = 0;
+            return false;
+        }
+
+        if ( m_idle < m_timeout ) {
+            ++m_idle;
+        }
+        return expired();
+    }
+
+    template <class KeypadSource>
+    constexpr bool update( const keypad_manager<KeypadSource>& keypad ) noexcept {
+        return update( keypad.key_mask() );
+    }
+
+    constexpr void reset() noexcept {
+        m_idle = 0;
+    }
+
+    constexpr void set_timeout( const uint32 timeoutFrames ) noexcept {
+        m_timeout = timeoutFrames;
+    }
+
+    [[nodiscard]]
+    constexpr bool expired() const noexcept {
+        return m_idle >= m_timeout;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 idle_frames() const noexcept {
+        return m_idle;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 timeout() const noexcept {
+        return m_timeout;
+    }
+
+private:
+    uint32 m_timeout;
+    uint32 m_idle;
+};
+
+/**
+ * Puts the console in STOP mode after a period without input, until a key combination is pressed
+ *
+ * Only the keypad interrupt is enabled while stopped, with IME cleared, so no interrupt handler is needed to wake.
+ * Turning the sound master enable off resets the PSG channel registers; the control registers are restored, but
+ * playing notes must be retriggered.
+ */
+class power_manager {
+public:
+    /**
+     * @param wakeCombo keys that must all be held to wake
+     * @param idleFrames frames without input before stopping
+     */
+    constexpr power_manager( const key_mask wakeCombo, const uint32 idleFrames ) noexcept : m_tracker { idleFrames }, m_combo { wakeCombo }, m_sleeps {} {}
+
+    /**
+     * Call once per frame after keypad_manager::poll()
+     * @return true if the console slept and has just woken
+     */
+    template <class KeypadSource>
+    bool update( const keypad_manager<KeypadSource>& keypad ) noexcept {
+        if ( !m_tracker.update( keypad ) ) {
+            return false;
+        }
+
+        sleep();
+        m_tracker.reset();
+        return true;
+    }
+
+    /**
+     * Enter STOP immediately and return once the wake combination has been pressed
+     */
+    void sleep() noexcept {
+        const auto ime = reg::ime::read();
+        reg::ime::write( 0 );
+
+        const auto display = reg::dispcnt::read();
+        const auto dmg = reg::snddmgcnt::read();
+        const auto directSound = reg::snddscnt::read();
+        const auto soundStatus = reg::sndstat::read();
+        const auto bias = reg::sdbias::read();
+        const auto enabled = reg::ie::read();
+        const auto keyControl = reg::keycnt::read();
+
+        auto blank = display;
+        blank.force_blank = true;
+        reg::dispcnt::write( blank );
+        reg::sndstat::write( {} );
+
+        reg::keycnt::write( wake_control() );
+        reg::ie::write( make_interrupt_mask( keypad_irq ) );
+        reg::if_::write( make_interrupt_mask( keypad_irq ) );
+
+        bios::stop();
+
+        reg::if_::write( make_interrupt_mask( keypad_irq ) );
+        reg::keycnt::write( keyControl );
+        reg::ie::write( enabled );
+
+        reg::sndstat::write( soundStatus );
+        reg::sdbias::write( bias );
+        reg::snddmgcnt::write( dmg );
+        reg::snddscnt::write( directSound );
+        reg::dispcnt::write( display );
+
+        reg::ime::write( ime );
+        ++m_sleeps;
+    }
+
+    constexpr void set_wake_combo( const key_mask wakeCombo ) noexcept {
+        m_combo = wakeCombo;
+    }
+
+    [[nodiscard]]
+    constexpr idle_tracker& tracker() noexcept {
+        return m_tracker;
+    }
+
+    /**
+     * Times the console has been put to sleep
+     */
+    [[nodiscard]]
+    constexpr uint32 sleeps() const noexcept {
+        return m_sleeps;
+    }
+
+private:
+    static constexpr uint16 keypad_irq = 0x1000;
+
+    [[nodiscard]]
+    constexpr keypad_control wake_control() const noexcept {
+        return keypad_control {
+            ( m_combo & key::button_a ) != 0,
+            ( m_combo & key::button_b ) != 0,
+            ( m_combo & key::select ) != 0,
+            ( m_combo & key::start ) != 0,
+            ( m_combo & key::right ) != 0,
+            ( m_combo & key::left ) != 0,
+            ( m_combo & key::up ) != 0,
+            ( m_combo & key::down ) != 0,
+            ( m_combo & key::button_r ) != 0,
+            ( m_combo & key::button_l ) != 0,
+            true,
+            true
+        };
+    }
+
+    idle_tracker m_tracker;
+    key_mask m_combo;
+    uint32 m_sleeps;
+};
+
+} // gba
+
+#endif // define GBAXX_SYSTEM_POWER_MANAGER_HPP
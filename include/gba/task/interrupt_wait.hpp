@@ -0,0 +1,44 @@
+#ifndef GBAXX_TASK_INTERRUPT_WAIT_HPP
+#define GBAXX_TASK_INTERRUPT_WAIT_HPP
+
+#include <gba/bios/halt.hpp>
+#include <gba/registers/interrupt_control.hpp>
+#include <gba/types/int_cast.hpp>
+#include <gba/types/int_type.hpp>
+#include <gba/types/interrupt_mask.hpp>
+
+namespace gba {
+namespace task {
+
+/**
+ * Halt until any interrupt in mask has been flagged in REG_IFBIOS
+ *
+ * Unlike bios::intr_wait(), which clears the flags it waited on, this reports which interrupts were raised.
+ * Flags raised before the call are consumed immediately. The interrupt handler must acknowledge REG_IFBIOS, and
+ * REG_IME must be set on entry.
+ * @param mask interrupts to wait for (REG_IE bit layout)
+ * @return the flags in mask that were raised; they are cleared from REG_IFBIOS
+ */
+inline uint16 intr_wait( const uint16 mask ) noexcept {
+    // REG_IME stays clear between checking the flags and halting, so an interrupt handled in between cannot leave
+    // the CPU halted until the next one. Halt still ends on any interrupt enabled in REG_IE; it stays pending in
+    // REG_IF until REG_IME is restored and the handler flags REG_IFBIOS.
+    const auto ime = reg::ime::read();
+    reg::ime::write( 0 );
+    auto flags = uint16( uint_cast( reg::ifbios::read() ) );
+    while ( ( flags & mask ) == 0 ) {
+        bios::halt();
+        reg::ime::write( ime );
+        reg::ime::write( 0 );
+        flags = uint16( uint_cast( reg::ifbios::read() ) );
+    }
+
+    reg::ifbios::write( make_interrupt_mask( flags & ~mask ) );
+    reg::ime::write( ime );
+    return flags & mask;
+}
+
+} // task
+} // gba
+
+#endif // define GBAXX_TASK_INTERRUPT_WAIT_HPP
@@ -0,0 +1,237 @@
+#ifndef GBAXX_TASK_SCHEDULER_CORE_HPP
+#define GBAXX_TASK_SCHEDULER_CORE_HPP
+
+#include <limits>
+
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+namespace task {
+
+enum class state : uint8 {
+    free = 0,
+    ready = 1,
+    sleeping = 2,
+    waiting = 3
+};
+
+/**
+ * Scheduling policy of a fixed pool of cooperative tasks
+ *
+ * Knows nothing about how a task is resumed, so it can be driven by fibers, C++20 coroutines or a host test.
+ * Every ready task is resumed at most once per frame, lowest priority value first.
+ * Interrupt masks use the REG_IE/REG_IF bit layout.
+ * @tparam Capacity maximum number of live tasks (1 to 32)
+ */
+template <unsigned Capacity>
+class scheduler_core {
+    static_assert( Capacity > 0 && Capacity <= 32, "scheduler_core Capacity must be between 1 and 32" );
+
+    struct slot {
+        uint32 wake_frame;
+        uint16 irq_mask;
+        uint8 priority;
+        task::state state;
+    };
+
+    static_assert( sizeof( slot ) == 8, "scheduler_core::slot must be tightly packed" );
+public:
+    static constexpr int none = -1;
+    static constexpr uint32 unlimited = std::numeric_limits<uint32>::max();
+
+    constexpr scheduler_core() noexcept : m_slots {}, m_frame {}, m_budget { unlimited }, m_used {}, m_pending {}, m_cursor {} {}
+
+    /**
+     * @param priority lower values are resumed first
+     * @return task id, or none if every slot is live
+     */
+    [[nodiscard]]
+    constexpr int spawn( const uint8 priority ) noexcept {
+        for ( unsigned ii = 0; ii < Capacity; ++ii ) {
+            if ( m_slots[ii].state == state::free ) {
+                m_slots[ii] = slot { 0, 0, priority, state::ready };
+                m_pending |= ( 1u << ii );
+                return int( ii );
+            }
+        }
+        return none;
+    }
+
+    constexpr void kill( const int id ) noexcept {
+        m_slots[id].state = state::free;
+        m_pending &= ~( 1u << id );
+    }
+
+    /**
+     * Suspend a task until a number of frames have been ticked
+     * @param id task to suspend
+     * @param frames 0 or 1 resumes on the next frame
+     */
+    constexpr void sleep( const int id, const uint32 frames ) noexcept {
+        if ( frames <= 1 ) {
+            m_slots[id].state = state::ready;
+            return;
+        }
+        m_slots[id].wake_frame = m_frame + frames;
+        m_slots[id].state = state::sleeping;
+    }
+
+    /**
+     * Suspend a task until signal() raises any of the interrupts in irqMask
+     */
+    constexpr void wait( const int id, const uint16 irqMask ) noexcept {
+        m_slots[id].irq_mask = irqMask;
+        m_slots[id].state = state::waiting;
+    }
+
+    /**
+     * Make a suspended task ready, whatever it was waiting for
+     */
+    constexpr void wake( const int id ) noexcept {
+        m_slots[id].state = state::ready;
+        m_pending |= ( 1u << id );
+    }
+
+    /**
+     * Wake every task waiting on any of the raised interrupts
+     *
+     * Woken tasks are resumed within the current frame if budget remains.
+     */
+    constexpr void signal( const uint16 raised ) noexcept {
+        for ( unsigned ii = 0; ii < Capacity; ++ii ) {
+            auto& s = m_slots[ii];
+            if ( s.state == state::waiting && ( s.irq_mask & raised ) ) {
+                s.irq_mask &= raised;
+                s.state = state::ready;
+                m_pending |= ( 1u << ii );
+            }
+        }
+    }
+
+    /**
+     * Advance the frame counter and wake sleeping tasks that are due
+     */
+    constexpr void tick() noexcept {
+        ++m_frame;
+        for ( auto& s : m_slots ) {
+            if ( s.state == state::sleeping && int32( m_frame - s.wake_frame ) >= 0 ) {
+                s.state = state::ready;
+            }
+        }
+    }
+
+    /**
+     * Start a new time slice; every ready task becomes pending once
+     * @param budget cycles that may be spent resuming tasks this frame
+     */
+    constexpr void begin_frame( const uint32 budget = unlimited ) noexcept {
+        m_budget = budget;
+        m_used = 0;
+        m_pending = 0;
+        for ( unsigned ii = 0; ii < Capacity; ++ii ) {
+            if ( m_slots[ii].state == state::ready ) {
+                m_pending |= ( 1u << ii );
+            }
+        }
+        // Rotate the starting slot so equal priorities share budget overruns fairly
+        m_cursor = ( m_cursor + 1u ) % Capacity;
+    }
+
+    /**
+     * Pick the next task to resume
+     * @return task id, or none if nothing is pending or the budget is used
+     */
+    [[nodiscard]]
+    constexpr int next() noexcept {
+        if ( !m_pending || m_used >= m_budget ) {
+            return none;
+        }
+
+        int best = none;
+        for ( unsigned ii = 0; ii < Capacity; ++ii ) {
+            const auto id = ( m_cursor + ii ) % Capacity;
+            if ( ( m_pending & ( 1u << id ) ) == 0 ) {
+                continue;
+            }
+            if ( best == none || m_slots[id].priority < m_slots[best].priority ) {
+                best = int( id );
+            }
+        }
+
+        m_pending &= ~( 1u << best );
+        return best;
+    }
+
+    constexpr void charge( [[maybe_unused]] const int id, const uint32 cycles ) noexcept {
+        m_used += cycles;
+    }
+
+    /**
+     * @return union of the interrupts that waiting tasks are blocked on
+     */
+    [[nodiscard]]
+    constexpr uint16 wait_mask() const noexcept {
+        uint16 mask = 0;
+        for ( const auto& s : m_slots ) {
+            if ( s.state == state::waiting ) {
+                mask |= s.irq_mask;
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * @return interrupts that woke this task from its last wait()
+     */
+    [[nodiscard]]
+    constexpr uint16 raised_mask( const int id ) const noexcept {
+        return m_slots[id].irq_mask;
+    }
+
+    [[nodiscard]]
+    constexpr task::state get_state( const int id ) const noexcept {
+        return m_slots[id].state;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 size() const noexcept {
+        uint32 count = 0;
+        for ( const auto& s : m_slots ) {
+            count += ( s.state != state::free );
+        }
+        return count;
+    }
+
+    [[nodiscard]]
+    constexpr bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 frame() const noexcept {
+        return m_frame;
+    }
+
+    [[nodiscard]]
+    constexpr uint32 budget_used() const noexcept {
+        return m_used;
+    }
+
+    [[nodiscard]]
+    constexpr bool budget_exhausted() const noexcept {
+        return m_used >= m_budget;
+    }
+
+private:
+    slot m_slots[Capacity];
+    uint32 m_frame;
+    uint32 m_budget;
+    uint32 m_used;
+    uint32 m_pending;
+    uint32 m_cursor;
+};
+
+} // task
+} // gba
+
+#endif // define GBAXX_TASK_SCHEDULER_CORE_HPP
@@ -1,6 +1,8 @@
 #ifndef GBAXX_TYPES_DIMENSION_HPP
 #define GBAXX_TYPES_DIMENSION_HPP
 
+#include <cstdint>
+
 #include <gba/types/int_type.hpp>
 
 namespace gba {
@@ -8,6 +10,8 @@ namespace gba {
 class dimension {
 protected:
     static constexpr auto mask = 0xf;
+    /// Top address bit, unused by the data, selects the height nibble
+    static constexpr auto high = std::uintptr_t( 1 ) << ( sizeof( std::uintptr_t ) * 8 - 1 );
 
 public:
     class reference {
@@ -33,19 +37,19 @@ public:
 
     protected:
         reference( uint8 * data ) noexcept : m_data { data } {}
-        reference( uint8 * data, const bool ) noexcept : m_data { reinterpret_cast<uint8 *>( reinterpret_cast<uint32>( data ) | 0x80000000 ) } {}
+        reference( uint8 * data, const bool ) noexcept : m_data { reinterpret_cast<uint8 *>( reinterpret_cast<std::uintptr_t>( data ) | high ) } {}
 
     private:
         uint8 shift() const noexcept {
-            return 4 * ( reinterpret_cast<uint32>( m_data ) >> 31 );
+            return reinterpret_cast<std::uintptr_t>( m_data ) & high ? 4 : 0;
         }
 
         const uint8& data() const noexcept {
-            return *reinterpret_cast<const uint8 *>( reinterpret_cast<uint32>( m_data ) & 0x7fffffff );
+            return *reinterpret_cast<const uint8 *>( reinterpret_cast<std::uintptr_t>( m_data ) & ~high );
         }
 
         uint8& data() noexcept {
-            return *reinterpret_cast<uint8 *>( reinterpret_cast<uint32>( m_data ) & 0x7fffffff );
+            return *reinterpret_cast<uint8 *>( reinterpret_cast<std::uintptr_t>( m_data ) & ~high );
         }
 
         uint8 * const m_data;
@@ -66,22 +70,22 @@ public:
 
     protected:
         const_reference( const uint8 * data ) noexcept : m_data { data } {}
-        const_reference( const uint8 * data, const bool ) noexcept : m_data { reinterpret_cast<const uint8 *>( reinterpret_cast<uint32>( data ) | 0x80000000 ) } {}
+        const_reference( const uint8 * data, const bool ) noexcept : m_data { reinterpret_cast<const uint8 *>( reinterpret_cast<std::uintptr_t>( data ) | high ) } {}
 
     private:
         uint8 shift() const noexcept {
-            return 4 * ( reinterpret_cast<uint32>( m_data ) >> 31 );
+            return reinterpret_cast<std::uintptr_t>( m_data ) & high ? 4 : 0;
         }
 
         const uint8& data() const noexcept {
-            return *reinterpret_cast<const uint8 *>( reinterpret_cast<uint32>( m_data ) & 0x7fffffff );
+            return *reinterpret_cast<const uint8 *>( reinterpret_cast<std::uintptr_t>( m_data ) & ~high );
         }
 
         const uint8 * const m_data;
     };
 
     constexpr dimension() noexcept : m_data { 0 } {}
-    constexpr dimension( const dimension& o ) noexcept : m_data { o.m_data } {}
+    constexpr dimension( const dimension& ) noexcept = default;
 
     constexpr dimension( uint32 width, uint32 height ) noexcept : m_data( ( ( height - 1 ) & mask ) << 4 | ( ( width - 1 ) & mask ) ) {}
 
@@ -1,6 +1,8 @@
 #ifndef GBAXX_TYPES_INT_CAST_HPP
 #define GBAXX_TYPES_INT_CAST_HPP
 
+#include <cstdint>
+
 #include <gba/types/int_type.hpp>
 
 #if !defined( __has_builtin )
@@ -48,6 +50,13 @@ gbaxx_int_cast_constexpr auto uint_cast( const Type& value ) noexcept -> typenam
 #endif
 }
 
+/**
+ * Address of a pointer as the 32-bit value that DMA and other address registers take
+ */
+inline auto address_cast( const volatile void * pointer ) noexcept -> uint32 {
+    return uint32( reinterpret_cast<std::uintptr_t>( pointer ) );
+}
+
 } // gba
 
 #undef gbaxx_int_cast_constexpr
@@ -1,6 +1,8 @@
 #ifndef GBAXX_TYPES_INTERRUPT_MASK_HPP
 #define GBAXX_TYPES_INTERRUPT_MASK_HPP
 
+#include <gba/types/int_type.hpp>
+
 namespace gba {
 
 struct interrupt_mask {
@@ -22,6 +24,26 @@ struct interrupt_mask {
 
 static_assert( sizeof( interrupt_mask ) == 2, "interrupt_mask must be tightly packed" );
 
+[[nodiscard]]
+constexpr interrupt_mask make_interrupt_mask( const uint16 bits ) noexcept {
+    return interrupt_mask {
+        ( bits & 0x0001 ) != 0,
+        ( bits & 0x0002 ) != 0,
+        ( bits & 0x0004 ) != 0,
+        ( bits & 0x0008 ) != 0,
+        ( bits & 0x0010 ) != 0,
+        ( bits & 0x0020 ) != 0,
+        ( bits & 0x0040 ) != 0,
+        ( bits & 0x0080 ) != 0,
+        ( bits & 0x0100 ) != 0,
+        ( bits & 0x0200 ) != 0,
+        ( bits & 0x0400 ) != 0,
+        ( bits & 0x0800 ) != 0,
+        ( bits & 0x1000 ) != 0,
+        ( bits & 0x2000 ) != 0
+    };
+}
+
 } // gba
 
 #endif // define GBAXX_TYPES_INTERRUPT_MASK_HPP
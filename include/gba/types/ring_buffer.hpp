@@ -0,0 +1,143 @@
+#ifndef GBAXX_TYPES_RING_BUFFER_HPP
+#define GBAXX_TYPES_RING_BUFFER_HPP
+
+#include <atomic>
+
+#include <gba/types/int_type.hpp>
+
+namespace gba {
+
+/**
+ * Lock-free single-producer/single-consumer queue between an interrupt handler and the main loop
+ *
+ * Indices run freely and are only written by their own side, so no interrupt masking is needed on a single core.
+ * @tparam Type element type
+ * @tparam Capacity number of elements (power of two)
+ */
+template <typename Type, unsigned Capacity>
+class ring_buffer {
+    static_assert( Capacity > 0 && ( Capacity & ( Capacity - 1 ) ) == 0, "ring_buffer Capacity must be a power of two" );
+public:
+    static constexpr uint32 capacity = Capacity;
+
+    constexpr ring_buffer() noexcept : m_data {}, m_head {}, m_tail {} {}
+
+    /**
+     * Producer side
+     * @return false if the buffer is full
+     */
+    bool push( const Type& value ) noexcept {
+        const uint32 tail = m_tail;
+        if ( tail - m_head == Capacity ) {
+            return false;
+        }
+
+        m_data[tail % Capacity] = value;
+        std::atomic_signal_fence( std::memory_order_release );
+        m_tail = tail + 1;
+        return true;
+    }
+
+    /**
+     * Producer side
+     * @return number of elements queued, fewer than count if the buffer fills
+     */
+    uint32 write( const Type * data, const uint32 count ) noexcept {
+        const uint32 tail = m_tail;
+        const auto space = Capacity - ( tail - m_head );
+        const auto n = count < space ? count : space;
+
+        for ( uint32 ii = 0; ii < n; ++ii ) {
+            m_data[( tail + ii ) % Capacity] = data[ii];
+        }
+        std::atomic_signal_fence( std::memory_order_release );
+        m_tail = tail + n;
+        return n;
+    }
+
+    /**
+     * Consumer side
+     * @return false if the buffer is empty
+     */
+    bool pop( Type& value ) noexcept {
+        const uint32 head = m_head;
+        if ( head == m_tail ) {
+            return false;
+        }
+
+        std::atomic_signal_fence( std::memory_order_acquire );
+        value = m_data[head % Capacity];
+        std::atomic_signal_fence( std::memory_order_release );
+        m_head = head + 1;
+        return true;
+    }
+
+    /**
+     * Consumer side
+     * @return number of elements dequeued
+     */
+    uint32 read( Type * data, const uint32 count ) noexcept {
+        const uint32 head = m_head;
+        const auto available = m_tail - head;
+        const auto n = count < available ? count : available;
+
+        std::atomic_signal_fence( std::memory_order_acquire );
+        for ( uint32 ii = 0; ii < n; ++ii ) {
+            data[ii] = m_data[( head + ii ) % Capacity];
+        }
+        std::atomic_signal_fence( std::memory_order_release );
+        m_head = head + n;
+        return n;
+    }
+
+    /**
+     * Consumer side; the element stays queued
+     */
+    [[nodiscard]]
+    bool peek( Type& value ) const noexcept {
+        const uint32 head = m_head;
+        if ( head == m_tail ) {
+            return false;
+        }
+
+        std::atomic_signal_fence( std::memory_order_acquire );
+        value = m_data[head % Capacity];
+        return true;
+    }
+
+    /**
+     * Consumer side; discard everything queued
+     */
+    void clear() noexcept {
+        m_head = uint32( m_tail );
+    }
+
+    [[nodiscard]]
+    uint32 size() const noexcept {
+        return m_tail - m_head;
+    }
+
+    [[nodiscard]]
+    uint32 space() const noexcept {
+        return Capacity - size();
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept {
+        return m_tail == m_head;
+    }
+
+    [[nodiscard]]
+    bool full() const noexcept {
+        return size() == Capacity;
+    }
+
+private:
+    Type m_data[Capacity];
+    volatile uint32 m_head;
+    volatile uint32 m_tail;
+};
+
+} // gba
+
+#endif // define GBAXX_TYPES_RING_BUFFER_HPP
@@ -0,0 +1,28 @@
+#ifndef GBAXX_TESTS_AGBABI_SYS_UCONTEXT_H
+#define GBAXX_TESTS_AGBABI_SYS_UCONTEXT_H
+
+#include <cstddef>
+
+/*
+ * Host stand-in for libagbabi's <sys/ucontext.h>: the same members the library uses, with the host context kept
+ * opaque in uc_mcontext. Implemented by ucontext.cpp on top of the host's makecontext and swapcontext
+ */
+
+typedef struct {
+    void * ss_sp;
+    int ss_flags;
+    std::size_t ss_size;
+} stack_t;
+
+typedef struct {
+    unsigned long arm_pc; ///< entry point until the context first switches away
+    alignas( 16 ) unsigned char host[1024];
+} mcontext_t;
+
+typedef struct ucontext_t {
+    struct ucontext_t * uc_link;
+    stack_t uc_stack;
+    mcontext_t uc_mcontext;
+} ucontext_t;
+
+#endif // define GBAXX_TESTS_AGBABI_SYS_UCONTEXT_H
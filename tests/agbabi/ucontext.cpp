@@ -0,0 +1,62 @@
+// Built without the stand-in header on the include path, so <ucontext.h> is the host's
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+#include <ucontext.h>
+
+namespace {
+
+// Layout of the stand-in types in sys/ucontext.h
+struct agb_stack {
+    void * ss_sp;
+    int ss_flags;
+    std::size_t ss_size;
+};
+
+struct agb_mcontext {
+    unsigned long arm_pc;
+    alignas( 16 ) unsigned char host[1024];
+};
+
+struct agb_ucontext {
+    agb_ucontext * uc_link;
+    agb_stack uc_stack;
+    agb_mcontext uc_mcontext;
+};
+
+static_assert( sizeof( ucontext_t ) <= sizeof( agb_mcontext::host ), "host ucontext_t must fit the stand-in" );
+
+ucontext_t * host( const agb_ucontext * context ) noexcept {
+    return reinterpret_cast<ucontext_t *>( const_cast<unsigned char *>( context->uc_mcontext.host ) );
+}
+
+} // namespace
+
+extern "C" {
+
+// The library always passes two std::reference_wrapper arguments, which are passed as pointers
+void __agbabi_makecontext( agb_ucontext * ucp, void ( * func )( void ), int argc, ... ) {
+    auto * const context = host( ucp );
+    getcontext( context );
+    context->uc_stack.ss_sp = ucp->uc_stack.ss_sp;
+    context->uc_stack.ss_size = ucp->uc_stack.ss_size;
+    context->uc_link = ucp->uc_link ? host( ucp->uc_link ) : nullptr;
+
+    va_list args;
+    va_start( args, argc );
+    auto * const first = va_arg( args, void * );
+    auto * const second = va_arg( args, void * );
+    va_end( args );
+
+    makecontext( context, func, 2, first, second );
+    ucp->uc_mcontext.arm_pc = reinterpret_cast<std::uintptr_t>( func );
+}
+
+int __agbabi_swapcontext( agb_ucontext * oucp, const agb_ucontext * ucp ) {
+    oucp->uc_mcontext.arm_pc = reinterpret_cast<std::uintptr_t>( __builtin_return_address( 0 ) );
+    return swapcontext( host( oucp ), host( ucp ) );
+}
+
+} // extern "C"
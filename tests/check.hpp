@@ -0,0 +1,37 @@
+#ifndef GBAXX_TESTS_CHECK_HPP
+#define GBAXX_TESTS_CHECK_HPP
+
+#include <cstdio>
+
+namespace gba {
+namespace test {
+
+inline int failures = 0;
+
+/**
+ * Record a failed expectation and keep going, so one run reports every failure
+ */
+inline bool check( const bool passed, const char * expression, const char * file, const int line ) noexcept {
+    if ( !passed ) {
+        std::fprintf( stderr, "%s:%d: check failed: %s\n", file, line, expression );
+        ++failures;
+    }
+    return passed;
+}
+
+/**
+ * Exit status of a test executable
+ */
+inline int result() noexcept {
+    if ( failures ) {
+        std::fprintf( stderr, "%d check(s) failed\n", failures );
+    }
+    return failures ? 1 : 0;
+}
+
+} // test
+} // gba
+
+#define GBAXX_CHECK( expression ) ::gba::test::check( bool( expression ), #expression, __FILE__, __LINE__ )
+
+#endif // define GBAXX_TESTS_CHECK_HPP
@@ -0,0 +1,195 @@
+#include <gba/coroutine/awaitable.hpp>
+#include <gba/coroutine/executor.hpp>
+#include <gba/coroutine/frame_arena.hpp>
+#include <gba/coroutine/task.hpp>
+#include <gba/types/int_cast.hpp>
+
+#include "check.hpp"
+
+using namespace gba::coroutine;
+using gba::coroutine::task;
+using gba::cycles_per_frame;
+using gba::cycles_type;
+using gba::make_interrupt_mask;
+using gba::uint16;
+using gba::uint32;
+using gba::uint_cast;
+
+namespace {
+
+using host_executor = executor<4, host_platform>;
+
+constexpr uint16 timer3_mask = 0x40;
+constexpr uint16 serial_mask = 0x80;
+
+frame_arena<16, 128> arena;
+
+struct log {
+    int entries[32];
+    int size;
+
+    void add( const int value ) noexcept {
+        entries[size++] = value;
+    }
+};
+
+task<> count_frames( host_executor& ex, log& out, const int frames ) {
+    for ( int ii = 0; ii < frames; ++ii ) {
+        out.add( int( ex.core().frame() ) );
+        co_await next_frame {};
+    }
+}
+
+task<> record( log& out, const int value ) {
+    out.add( value );
+    co_return;
+}
+
+task<int> twice( const int value ) {
+    co_await next_frame {};
+    co_return value * 2;
+}
+
+task<> await_child( log& out ) {
+    out.add( co_await twice( 21 ) );
+}
+
+task<> sleep_cycles( host_executor& ex, uint32& wokeAt, const uint32 cycles ) {
+    co_await timer( cycles_type( cycles ) );
+    wokeAt = ex.platform().now();
+}
+
+task<> wait_serial( uint16& raised ) {
+    raised = uint16( uint_cast( co_await interrupt( make_interrupt_mask( serial_mask ) ) ) );
+}
+
+task<> work( host_executor& ex, log& out, const int id, const uint32 cycles ) {
+    for ( int ii = 0; ii < 2; ++ii ) {
+        ex.platform().advance( cycles );
+        out.add( id );
+        co_await next_frame {};
+    }
+}
+
+task<> in_arena( detail::frame_arena_base&, log& out ) {
+    out.add( 7 );
+    co_return;
+}
+
+void tasks_resume_once_per_frame() {
+    host_executor ex;
+    log out {};
+    GBAXX_CHECK( ex.spawn( count_frames( ex, out, 3 ) ) != ex.none );
+    ex.run();
+
+    GBAXX_CHECK( out.size == 3 );
+    GBAXX_CHECK( out.entries[0] == 0 && out.entries[1] == 1 && out.entries[2] == 2 );
+    GBAXX_CHECK( ex.platform().now() % cycles_per_frame.count() == 0 );
+    GBAXX_CHECK( arena.blocks_used() == 0 );
+}
+
+void priority_order() {
+    host_executor ex;
+    log out {};
+    ex.spawn( record( out, 2 ), 200 );
+    ex.spawn( record( out, 0 ), 0 );
+    ex.spawn( record( out, 1 ), 100 );
+    ex.run_frame();
+
+    GBAXX_CHECK( out.size == 3 );
+    GBAXX_CHECK( out.entries[0] == 0 && out.entries[1] == 1 && out.entries[2] == 2 );
+    GBAXX_CHECK( ex.core().empty() );
+}
+
+void awaiting_a_child_task() {
+    host_executor ex;
+    log out {};
+    ex.spawn( await_child( out ) );
+    ex.run();
+
+    GBAXX_CHECK( out.size == 1 && out.entries[0] == 42 );
+    GBAXX_CHECK( arena.blocks_used() == 0 );
+}
+
+void timer_wakes_within_the_frame() {
+    host_executor ex;
+    uint32 wokeAt = 0;
+    ex.spawn( sleep_cycles( ex, wokeAt, 1000 ) );
+    ex.run_frame();
+
+    GBAXX_CHECK( ex.core().empty() );
+    GBAXX_CHECK( wokeAt >= 1000 && wokeAt < cycles_per_frame.count() );
+}
+
+void interrupt_wakes_waiting_task() {
+    host_executor ex;
+    uint16 raised = 0;
+    ex.spawn( wait_serial( raised ) );
+    ex.run_frame();
+    ex.run_frame();
+    GBAXX_CHECK( raised == 0 );
+    GBAXX_CHECK( ex.core().size() == 1 );
+
+    ex.platform().raise( serial_mask | timer3_mask );
+    ex.run_frame();
+    GBAXX_CHECK( raised == serial_mask );
+    GBAXX_CHECK( ex.core().empty() );
+}
+
+void budget_defers_to_next_frame() {
+    host_executor ex;
+    log out {};
+    ex.set_budget( cycles_type( 5000 ) );
+    ex.spawn( work( ex, out, 1, 6000 ) );
+    ex.spawn( work( ex, out, 2, 6000 ) );
+
+    // Task 1 overruns the budget, so task 2 waits for the next frame
+    ex.run_frame();
+    GBAXX_CHECK( out.size == 1 );
+    ex.run();
+    GBAXX_CHECK( out.size == 4 );
+}
+
+void explicit_arena_and_exhaustion() {
+    frame_arena<2, 128> small;
+    host_executor ex;
+    log out {};
+    GBAXX_CHECK( ex.spawn( in_arena( small, out ) ) != ex.none );
+    GBAXX_CHECK( small.blocks_used() > 0 );
+    GBAXX_CHECK( arena.blocks_used() == 0 );
+    ex.run();
+    GBAXX_CHECK( out.size == 1 && out.entries[0] == 7 );
+    GBAXX_CHECK( small.blocks_used() == 0 );
+
+    // An arena that is full yields an empty task, which spawn() refuses
+    frame_arena<1, 8> tiny;
+    auto empty = in_arena( tiny, out );
+    GBAXX_CHECK( !empty );
+    GBAXX_CHECK( ex.spawn( std::move( empty ) ) == ex.none );
+
+    // A 32 block arena hands out one frame spanning every block
+    frame_arena<32, 8> full;
+    void * all = full.allocate( 32 * 8 );
+    GBAXX_CHECK( all != nullptr && full.blocks_used() == 32 );
+    GBAXX_CHECK( full.allocate( 8 ) == nullptr );
+    full.deallocate( all, 32 * 8 );
+    GBAXX_CHECK( full.blocks_used() == 0 );
+    void * one = full.allocate( 8 );
+    GBAXX_CHECK( full.allocate( 32 * 8 ) == nullptr );
+    full.deallocate( one, 8 );
+}
+
+} // namespace
+
+int main() {
+    set_frame_arena( arena );
+
+    tasks_resume_once_per_frame();
+    priority_order();
+    awaiting_a_child_task();
+    timer_wakes_within_the_frame();
+    interrupt_wakes_waiting_task();
+    budget_defers_to_next_frame();
+    explicit_arena_and_exhaustion();
+    return gba::test::result();
+}
@@ -0,0 +1,208 @@
+#include <cstring>
+
+#include <gba/display/bitmap.hpp>
+
+#include "check.hpp"
+
+using gba::bitmap;
+using gba::int32;
+using gba::uint8;
+using gba::uint16;
+using gba::uint32;
+
+namespace {
+
+using small8 = bitmap<16, 8, 8>;
+using small16 = bitmap<16, 8, 16>;
+
+uint16 small_pixels[16 * 8];
+
+/**
+ * Compare a small bitmap against rows of text: '.' is 0, a digit is that color
+ */
+template <class Bitmap>
+bool matches( const Bitmap& image, const char * const ( & rows )[8] ) {
+    bool same = true;
+    for ( int32 y = 0; y < 8; ++y ) {
+        for ( int32 x = 0; x < 16; ++x ) {
+            const auto expected = rows[y][x] == '.' ? 0 : rows[y][x] - '0';
+            if ( image.get( x, y ) != expected ) {
+                std::fprintf( stderr, "pixel %d,%d is %d, expected %d\n", x, y, int( image.get( x, y ) ), expected );
+                same = false;
+            }
+        }
+    }
+    return same;
+}
+
+template <class Bitmap>
+Bitmap blank() {
+    std::memset( small_pixels, 0, sizeof( small_pixels ) );
+    return Bitmap { small_pixels };
+}
+
+template <class Bitmap>
+void golden_lines() {
+    auto image = blank<Bitmap>();
+    image.line( 0, 0, 15, 7, 1 );
+    image.line( 0, 7, 3, 0, 2 );
+    GBAXX_CHECK( matches( image, {
+        "11.2............",
+        "..12............",
+        "..2.11..........",
+        "..2...11........",
+        ".2......11......",
+        ".2........11....",
+        "2...........11..",
+        "2.............11"
+    } ) );
+
+    // Clipped at every edge, entering and leaving off the bitmap
+    image = blank<Bitmap>();
+    image.line( -8, -4, 23, 11, 3 );
+    image.line( 20, 1, -4, 3, 4 );
+    image.line( 13, -20, 15, 40, 5 );
+    GBAXX_CHECK( matches( image, {
+        "33............5.",
+        "..33..........54",
+        "...444444444445.",
+        "444...33......5.",
+        "........33....5.",
+        "..........33..5.",
+        "............335.",
+        "..............53"
+    } ) );
+}
+
+template <class Bitmap>
+void golden_shapes() {
+    auto image = blank<Bitmap>();
+    image.rect( 0, 0, 16, 8, 1 );
+    image.fill_rect( 3, 2, 5, 3, 2 );
+    image.fill_rect( -4, 6, 6, 9, 3 );
+    image.hline( 9, 14, 6, 4 );
+    image.vline( 11, -3, 3, 5 );
+    GBAXX_CHECK( matches( image, {
+        "1111111111151111",
+        "1..........5...1",
+        "1..22222...5...1",
+        "1..22222...5...1",
+        "1..22222.......1",
+        "1..............1",
+        "33.......4444441",
+        "3311111111111111"
+    } ) );
+}
+
+template <class Bitmap>
+void golden_circles() {
+    auto image = blank<Bitmap>();
+    image.circle( 3, 3, 3, 1 );
+    image.fill_circle( 11, 4, 3, 2 );
+    image.fill_circle( 15, 0, 1, 3 );
+    GBAXX_CHECK( matches( image, {
+        "..111.........33",
+        ".1...1....222..3",
+        "1.....1..22222..",
+        "1.....1.2222222.",
+        "1.....1.2222222.",
+        ".1...1..2222222.",
+        "..111....22222..",
+        "..........222..."
+    } ) );
+}
+
+void blit_odd_alignment() {
+    auto image = blank<small8>();
+    const uint8 sprite[] = {
+        1, 2, 3,
+        4, 5, 6
+    };
+    image.blit( 5, 3, sprite, 3, 2, 3 );
+    image.blit( -1, 0, sprite, 3, 2, 3 );
+    image.blit( 14, 7, sprite, 3, 2, 3 );
+    GBAXX_CHECK( matches( image, {
+        "23..............",
+        "56..............",
+        "................",
+        ".....123........",
+        ".....456........",
+        "................",
+        "................",
+        "..............12"
+    } ) );
+}
+
+/**
+ * Reference: every step of the line in turn, each checked against the bitmap
+ */
+template <class Bitmap>
+void reference_line( Bitmap& image, const int32 x0, const int32 y0, const int32 x1, const int32 y1, const typename Bitmap::pixel color ) {
+    const auto dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    const auto dy = y1 > y0 ? y1 - y0 : y0 - y1;
+    const auto major = dx >= dy ? dx : dy;
+    const auto minor = dx >= dy ? dy : dx;
+    if ( !major ) {
+        image.plot( x0, y0, color );
+        return;
+    }
+    for ( int32 ii = 0; ii <= major; ++ii ) {
+        const auto offset = int32( ( 2ll * ii * minor + major ) / ( 2ll * major ) );
+        const auto x = dx >= dy ? ii : offset;
+        const auto y = dx >= dy ? offset : ii;
+        image.plot( x0 + ( x0 < x1 ? x : -x ), y0 + ( y0 < y1 ? y : -y ), color );
+    }
+}
+
+template <class Bitmap>
+void lines_match_reference() {
+    static typename Bitmap::pixel drawn[Bitmap::width * Bitmap::height];
+    static typename Bitmap::pixel expected[Bitmap::width * Bitmap::height];
+
+    uint32 seed = 12345;
+    const auto next = [&seed]( const int32 range ) {
+        seed = seed * 1664525 + 1013904223;
+        return int32( ( seed >> 8 ) % uint32( range ) ) - range / 4;
+    };
+
+    uint32 mismatches = 0;
+    for ( int ii = 0; ii < 2000; ++ii ) {
+        std::memset( drawn, 0, sizeof( drawn ) );
+        std::memset( expected, 0, sizeof( expected ) );
+        Bitmap a { drawn };
+        Bitmap b { expected };
+
+        // Mostly near the bitmap, some far off it
+        const auto range = ii % 10 ? Bitmap::width * 2 : 4000;
+        const auto x0 = next( range );
+        const auto y0 = next( range );
+        const auto x1 = next( range );
+        const auto y1 = next( range );
+        a.line( x0, y0, x1, y1, 7 );
+        reference_line( b, x0, y0, x1, y1, 7 );
+        if ( std::memcmp( drawn, expected, sizeof( drawn ) ) != 0 ) {
+            if ( !mismatches ) {
+                std::fprintf( stderr, "line %d,%d to %d,%d differs\n", x0, y0, x1, y1 );
+            }
+            ++mismatches;
+        }
+    }
+    GBAXX_CHECK( mismatches == 0 );
+}
+
+} // namespace
+
+int main() {
+    golden_lines<small8>();
+    golden_lines<small16>();
+    golden_shapes<small8>();
+    golden_shapes<small16>();
+    golden_circles<small8>();
+    golden_circles<small16>();
+    blit_odd_alignment();
+
+    lines_match_reference<gba::bitmap_mode3>();
+    lines_match_reference<gba::bitmap_mode4>();
+    lines_match_reference<gba::bitmap_mode5>();
+    return gba::test::result();
+}
@@ -0,0 +1,170 @@
+#include <cstring>
+
+#include <gba/display/compositor.hpp>
+
+#include "check.hpp"
+
+using gba::blend_control;
+using gba::blend_mode;
+using gba::compositor;
+using gba::int32;
+using gba::tween;
+using gba::tween_curve;
+using gba::uint16;
+using gba::uint32;
+
+namespace {
+
+template <uint32 Frames>
+constexpr bool tween_steps( const int32 from, const int32 to, const tween_curve curve, const int32 ( & expected )[Frames] ) {
+    tween t;
+    t.start( from, to, Frames, curve );
+    if ( t.value() != from || !t.active() ) {
+        return false;
+    }
+    for ( uint32 ii = 0; ii < Frames; ++ii ) {
+        if ( t.step() != expected[ii] ) {
+            return false;
+        }
+    }
+    return !t.active() && t.step() == to;
+}
+
+static_assert( tween_steps<4>( 0, 16, tween_curve::linear, { 4, 8, 12, 16 } ), "linear tweens move evenly" );
+static_assert( tween_steps<4>( 16, 0, tween_curve::linear, { 12, 8, 4, 0 } ), "tweens move down as well as up" );
+static_assert( tween_steps<4>( 0, 16, tween_curve::ease_in_out, { 2, 8, 13, 16 } ), "ease in and out is slow at the ends" );
+
+constexpr bool zero_frames_jump() {
+    tween t;
+    t.start( 3, 9, 0 );
+    return t.value() == 9 && !t.active();
+}
+static_assert( zero_frames_jump(), "a tween over no frames is already at its target" );
+
+// Halfwords of the block: win0h, win1h, win0v, win1v, winin, winout, mosaic (2), bldcnt, bldalpha, bldy
+constexpr uint32 win1h = 1;
+constexpr uint32 win1v = 3;
+constexpr uint32 winin = 4;
+constexpr uint32 winout = 5;
+constexpr uint32 bldcnt = 8;
+constexpr uint32 bldalpha = 9;
+constexpr uint32 bldy = 10;
+
+uint16 io[compositor::halfwords];
+
+bool io_matches( const compositor& c ) {
+    return std::memcmp( io, &c.registers(), sizeof( io ) ) == 0;
+}
+
+void commits_only_changes() {
+    std::memset( io, 0xff, sizeof( io ) );
+    compositor c { io };
+
+    // The first commit writes the whole block, then idle frames write nothing
+    GBAXX_CHECK( c.commit() == compositor::halfwords );
+    GBAXX_CHECK( io_matches( c ) );
+    GBAXX_CHECK( c.commit() == 0 );
+
+    // The changed range: window 1's horizontal and vertical halves, and win0v between them. Ends are stored as a
+    // uint_size8, one less than the value given
+    c.set_window( 1, 16, 24, 64, 32 );
+    GBAXX_CHECK( c.commit() == win1v - win1h + 1 );
+    GBAXX_CHECK( io[win1h] == uint16( ( 16 + 64 - 1 ) | 16 << 8 ) && io[win1v] == uint16( ( 24 + 32 - 1 ) | 24 << 8 ) );
+
+    // Writing the same values again changes nothing
+    c.set_window( 1, 16, 24, 64, 32 );
+    GBAXX_CHECK( c.commit() == 0 );
+
+    c.set_alpha( 10, 6 );
+    GBAXX_CHECK( c.commit() == 1 );
+    GBAXX_CHECK( io[bldalpha] == uint16( 10 | 6 << 8 ) );
+
+    // invalidate() rewrites everything, such as after other code wrote the registers
+    io[winin] = 0x1234;
+    c.invalidate();
+    GBAXX_CHECK( c.commit() == compositor::halfwords );
+    GBAXX_CHECK( io_matches( c ) );
+}
+
+void window_layers_keep_the_other_half() {
+    std::memset( io, 0, sizeof( io ) );
+    compositor c { io };
+    c.set_window_layers( 0, compositor::bg0 | compositor::obj );
+    c.set_window_layers( 1, compositor::bg2 );
+    c.set_outside_layers( compositor::bg3 );
+    c.set_object_window_layers( compositor::all );
+    c.commit();
+    GBAXX_CHECK( io[winin] == uint16( 0x11 | 0x04 << 8 ) );
+    GBAXX_CHECK( io[winout] == uint16( 0x08 | 0x3f << 8 ) );
+
+    c.spotlight( 40, 30, 80, 60 );
+    c.commit();
+    GBAXX_CHECK( io[winin] == uint16( 0x3f | 0x04 << 8 ) );
+    GBAXX_CHECK( io[winout] == uint16( 0x00 | 0x3f << 8 ) );
+}
+
+void fades_one_register_a_frame() {
+    std::memset( io, 0, sizeof( io ) );
+    compositor c { io };
+    c.commit();
+
+    c.fade( 16, 8 );
+    GBAXX_CHECK( c.tweening() );
+    GBAXX_CHECK( c.commit() == 1 ); // only BLDCNT until the tween moves
+    blend_control control;
+    std::memcpy( &control, &io[bldcnt], sizeof( control ) );
+    GBAXX_CHECK( control.mode == blend_mode::black && control.src_bg0 && control.src_backdrop && !control.dst_bg0 );
+
+    uint32 frames = 0;
+    uint32 written = 0;
+    uint16 previous = io[bldy];
+    bool rising = true;
+    while ( c.tweening() ) {
+        c.update();
+        written += c.commit();
+        rising = rising && io[bldy] > previous;
+        previous = io[bldy];
+        ++frames;
+    }
+    GBAXX_CHECK( frames == 8 );
+    GBAXX_CHECK( written == 8 );
+    GBAXX_CHECK( rising );
+    GBAXX_CHECK( io[bldy] == 16 );
+
+    // Finished tweens cost nothing
+    c.update();
+    GBAXX_CHECK( c.commit() == 0 );
+
+    // Fading back starts from where the fade ended
+    c.fade( 0, 4 );
+    c.update();
+    c.commit();
+    GBAXX_CHECK( io[bldy] == 12 );
+}
+
+void alpha_tween_clamps() {
+    std::memset( io, 0, sizeof( io ) );
+    compositor c { io };
+    c.set_alpha( 0, 16 );
+    c.tween_alpha( 16, 0, 4, tween_curve::ease_in_out );
+    for ( int ii = 0; ii < 2; ++ii ) {
+        c.update();
+    }
+    c.commit();
+    GBAXX_CHECK( io[bldalpha] == uint16( 8 | 8 << 8 ) );
+
+    // Weights past 16 are clamped
+    c.set_alpha( 40, 20 );
+    c.commit();
+    GBAXX_CHECK( io[bldalpha] == uint16( 16 | 16 << 8 ) );
+}
+
+} // namespace
+
+int main() {
+    commits_only_changes();
+    window_layers_keep_the_other_half();
+    fades_one_register_a_frame();
+    alpha_tween_clamps();
+    return gba::test::result();
+}
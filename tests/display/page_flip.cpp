@@ -0,0 +1,207 @@
+#include <cstring>
+
+#include <gba/display/page_flip.hpp>
+#include <gba/registers/display_shadow.hpp>
+
+#include "check.hpp"
+
+using gba::bitmap_mode4;
+using gba::bitmap_mode5;
+using gba::cpu_copy;
+using gba::dirty_rects;
+using gba::display_shadow;
+using gba::int32;
+using gba::page_flipper;
+using gba::uint8;
+using gba::uint16;
+using gba::uint32;
+
+namespace {
+
+constexpr bool touching_rects_merge() {
+    dirty_rects<4> rects { 240, 160 };
+    rects.add( 0, 0, 10, 10 );
+    rects.add( 10, 0, 10, 10 ); // shares an edge
+    rects.add( 50, 50, 5, 5 );
+    rects.add( 5, 5, 50, 46 ); // bridges both
+    return rects.size() == 1 && rects[0].x0 == 0 && rects[0].y0 == 0 && rects[0].x1 == 55 && rects[0].y1 == 55;
+}
+static_assert( touching_rects_merge(), "dirty_rects must merge touching regions" );
+
+constexpr bool clipped_and_aligned() {
+    dirty_rects<4, 4> rects { 240, 160 };
+    rects.add( -5, -5, 10, 10 );
+    rects.add( 101, 20, 2, 2 );
+    rects.add( 238, 150, 20, 20 );
+    rects.add( 300, 0, 10, 10 ); // outside
+    return rects.size() == 3
+        && rects[0].x0 == 0 && rects[0].y0 == 0 && rects[0].x1 == 8 && rects[0].y1 == 5
+        && rects[1].x0 == 100 && rects[1].x1 == 104
+        && rects[2].x0 == 236 && rects[2].x1 == 240 && rects[2].y1 == 160;
+}
+static_assert( clipped_and_aligned(), "dirty_rects must clip to the page and align to words" );
+
+constexpr bool full_set_grows_least() {
+    dirty_rects<2> rects { 240, 160 };
+    rects.add( 0, 0, 10, 10 );
+    rects.add( 100, 100, 10, 10 );
+    rects.add( 12, 0, 4, 10 ); // nearer the first
+    return rects.size() == 2 && rects.area() == 16 * 10 + 10 * 10;
+}
+static_assert( full_set_grows_least(), "a full dirty_rects must merge into the rect that grows least" );
+
+uint32 seed = 12345;
+
+int32 random( const int32 range ) {
+    seed = seed * 1664525 + 1013904223;
+    return int32( ( seed >> 8 ) % uint32( range ) );
+}
+
+/**
+ * Random merge sequences: every marked pixel stays covered, and the rects stay within bounds, aligned and apart
+ */
+template <unsigned Rects, unsigned Align>
+void merge_sequences() {
+    constexpr int32 width = 240;
+    constexpr int32 height = 160;
+    static bool marked[width * height];
+
+    uint32 uncovered = 0;
+    uint32 overlapping = 0;
+    uint32 misplaced = 0;
+    for ( int sequence = 0; sequence < 2000; ++sequence ) {
+        std::memset( marked, 0, sizeof( marked ) );
+        dirty_rects<Rects, Align> rects { width, height };
+
+        const auto adds = 1 + random( 24 );
+        for ( int32 ii = 0; ii < adds; ++ii ) {
+            const auto x = random( width + 40 ) - 20;
+            const auto y = random( height + 40 ) - 20;
+            const auto w = 1 + random( 48 );
+            const auto h = 1 + random( 48 );
+            rects.add( x, y, w, h );
+            for ( auto py = y < 0 ? 0 : y; py < y + h && py < height; ++py ) {
+                for ( auto px = x < 0 ? 0 : x; px < x + w && px < width; ++px ) {
+                    marked[py * width + px] = true;
+                }
+            }
+        }
+
+        misplaced += rects.size() > Rects;
+        for ( uint32 ii = 0; ii < rects.size(); ++ii ) {
+            const auto& r = rects[ii];
+            misplaced += r.x0 < 0 || r.y0 < 0 || r.x1 > width || r.y1 > height || r.x0 >= r.x1 || r.y0 >= r.y1;
+            misplaced += ( r.x0 % int32( Align ) ) != 0 || ( r.x1 % int32( Align ) ) != 0;
+            for ( uint32 jj = ii + 1; jj < rects.size(); ++jj ) {
+                overlapping += r.touches( rects[jj] );
+            }
+        }
+
+        for ( int32 py = 0; py < height; ++py ) {
+            for ( int32 px = 0; px < width; ++px ) {
+                if ( !marked[py * width + px] ) {
+                    continue;
+                }
+                bool covered = false;
+                for ( uint32 ii = 0; ii < rects.size(); ++ii ) {
+                    const auto& r = rects[ii];
+                    covered = covered || ( px >= r.x0 && px < r.x1 && py >= r.y0 && py < r.y1 );
+                }
+                uncovered += !covered;
+            }
+        }
+    }
+    GBAXX_CHECK( uncovered == 0 );
+    GBAXX_CHECK( overlapping == 0 );
+    GBAXX_CHECK( misplaced == 0 );
+}
+
+/**
+ * Simulated frames of a few moving boxes: each flip shows exactly the reference image, while copying far less than a
+ * full page forward
+ */
+template <class Bitmap>
+void flip_frames() {
+    constexpr auto page_words = Bitmap::pitch * Bitmap::height / 4;
+    static uint32 page0[page_words];
+    static uint32 page1[page_words];
+    static uint32 reference[page_words];
+    std::memset( page0, 0, sizeof( page0 ) );
+    std::memset( page1, 0, sizeof( page1 ) );
+    std::memset( reference, 0, sizeof( reference ) );
+
+    page_flipper<Bitmap, 8, cpu_copy> flipper { page0, page1 };
+    Bitmap expected { reference };
+
+    uint32 stale = 0;
+    uint32 wrong = 0;
+    uint32 copied = 0;
+    for ( int32 frame = 0; frame < 500; ++frame ) {
+        GBAXX_CHECK( flipper.begin() );
+        copied += flipper.copied_bytes();
+        stale += std::memcmp( flipper.back().data(), flipper.front().data(), sizeof( page0 ) ) != 0;
+
+        auto back = flipper.back();
+        for ( int32 box = 0; box < 4; ++box ) {
+            const auto x = ( frame * ( box + 1 ) + box * 50 ) % ( Bitmap::width + 16 ) - 8;
+            const auto y = ( frame * ( 3 - box ) + box * 30 ) % ( Bitmap::height + 16 ) - 8;
+            const auto color = typename Bitmap::pixel( 1 + ( frame + box ) % 200 );
+            back.fill_rect( x, y, 12, 12, color );
+            expected.fill_rect( x, y, 12, 12, color );
+            flipper.mark( x, y, 12, 12 );
+        }
+        if ( frame % 97 == 0 ) {
+            back.clear( typename Bitmap::pixel( frame ) );
+            expected.clear( typename Bitmap::pixel( frame ) );
+            flipper.mark_all();
+        }
+
+        flipper.present();
+        GBAXX_CHECK( !flipper.begin() );
+        flipper.flip();
+        wrong += std::memcmp( flipper.front().data(), reference, sizeof( reference ) ) != 0;
+    }
+    GBAXX_CHECK( stale == 0 );
+    GBAXX_CHECK( wrong == 0 );
+    GBAXX_CHECK( copied < 500 * sizeof( page0 ) / 8 );
+}
+
+void flips_through_the_shadow() {
+    static uint16 page0[240 * 160 / 2];
+    static uint16 page1[240 * 160 / 2];
+    static uint16 io[display_shadow<>::halfwords];
+    display_shadow<8, cpu_copy> shadow { io };
+    page_flipper<bitmap_mode4, 8, cpu_copy> flipper { page0, page1 };
+
+    // Nothing presented, nothing written
+    GBAXX_CHECK( !flipper.vblank( shadow ) );
+
+    // Another change to DISPCNT in the same frame keeps the page bit
+    flipper.begin();
+    flipper.present();
+    shadow.transform<gba::reg::dispcnt>( []( auto& control ) {
+        control.mode = 4;
+    } );
+    GBAXX_CHECK( flipper.vblank( shadow ) );
+    shadow.commit();
+    GBAXX_CHECK( io[0] == ( 4 | 0x10 ) && flipper.front_page() == 1 );
+
+    flipper.begin();
+    flipper.present();
+    GBAXX_CHECK( flipper.vblank( shadow ) );
+    GBAXX_CHECK( shadow.commit() == 1 );
+    GBAXX_CHECK( io[0] == 4 && flipper.front_page() == 0 );
+}
+
+} // namespace
+
+int main() {
+    merge_sequences<1, 1>();
+    merge_sequences<4, 4>();
+    merge_sequences<16, 2>();
+
+    flip_frames<bitmap_mode4>();
+    flip_frames<bitmap_mode5>();
+    flips_through_the_shadow();
+    return gba::test::result();
+}
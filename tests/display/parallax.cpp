@@ -0,0 +1,105 @@
+#include <gba/display/parallax.hpp>
+#include <gba/registers/display_shadow.hpp>
+
+#include "check.hpp"
+
+using gba::cpu_copy;
+using gba::display_shadow;
+using gba::int16;
+using gba::parallax;
+using gba::parallax_band;
+using gba::parallax_factor;
+using gba::parallax_position;
+using gba::uint16;
+using gba::uint32;
+namespace reg = gba::reg;
+
+namespace {
+
+using shadow_type = display_shadow<8, cpu_copy>;
+
+constexpr uint32 mosaic = ( reg::mosaic::address - 0x4000000 ) / 2;
+
+uint16 io[shadow_type::halfwords];
+
+void layers_follow_the_camera() {
+    parallax scroll;
+    scroll.set_layer( 0, parallax_factor( 1 ), parallax_factor( 1 ) );
+    scroll.set_layer( 1, parallax_factor( 0.5 ), parallax_factor( 0.25 ), 3, -2 );
+    scroll.set_camera( parallax_position( 100 ), parallax_position( 40 ) );
+    scroll.update();
+    GBAXX_CHECK( scroll.offsets( 0 ).x == 100 && scroll.offsets( 0 ).y == 40 );
+    GBAXX_CHECK( scroll.offsets( 1 ).x == 53 && scroll.offsets( 1 ).y == 8 );
+
+    // Disabled layers keep their last offsets
+    scroll.disable( 1 );
+    scroll.set_camera( parallax_position( 20 ), parallax_position( 0 ) );
+    scroll.update();
+    GBAXX_CHECK( scroll.offsets( 0 ).x == 20 && scroll.offsets( 1 ).x == 53 );
+}
+
+void bands_fill_every_line() {
+    static constexpr parallax_band bands[] = {
+        { 0, parallax_factor( 0.25 ), 0 },
+        { 64, parallax_factor( 0.5 ), 0 },
+        { 128, parallax_factor( 1 ), 7 }
+    };
+
+    parallax scroll;
+    scroll.set_layer( 2, parallax_factor( 1 ), parallax_factor( 0.5 ) );
+    scroll.set_bands( 2, bands, 3 );
+    scroll.set_camera( parallax_position( 80 ), parallax_position( 12 ) );
+    scroll.update();
+
+    const auto * table = scroll.table();
+    uint32 wrong = 0;
+    for ( uint32 line = 0; line < parallax::lines; ++line ) {
+        const auto expected = line < 64 ? 20u : line < 128 ? 40u : 87u;
+        wrong += ( table[line] & 0xffff ) != expected || table[line] >> 16 != 6;
+    }
+    GBAXX_CHECK( wrong == 0 );
+    GBAXX_CHECK( scroll.offsets( 2 ).x == 20 && scroll.offsets( 2 ).y == 6 );
+
+    // The HBlank after line 159 reads one entry past the last line
+    GBAXX_CHECK( table[parallax::lines] == table[0] );
+}
+
+void mosaic_keeps_both_halves() {
+    for ( auto& halfword : io ) {
+        halfword = 0;
+    }
+    shadow_type shadow { io };
+    shadow.commit();
+
+    // Without a mosaic size, commit( shadow ) leaves MOSAIC to whoever else owns it
+    io[mosaic] = 0x1234;
+    parallax scroll;
+    scroll.set_layer( 0, parallax_factor( 1 ), parallax_factor( 1 ) );
+    scroll.set_camera( parallax_position( 5 ), parallax_position( 0 ) );
+    scroll.update();
+    scroll.commit( shadow );
+    GBAXX_CHECK( shadow.commit() == 1 ); // BG0HOFS
+    GBAXX_CHECK( io[mosaic] == 0x1234 );
+
+    // Sizes are stored minus one: background in the low byte, objects in the high
+    scroll.set_object_mosaic( 2, 3 );
+    scroll.set_mosaic( 4, 5 );
+    scroll.commit( shadow );
+    shadow.commit();
+    GBAXX_CHECK( io[mosaic] == 0x2143 );
+
+    // Changing the background size keeps the object size
+    scroll.set_mosaic( 1, 1 );
+    scroll.commit( shadow );
+    GBAXX_CHECK( shadow.commit() == 1 );
+    GBAXX_CHECK( io[mosaic] == 0x2100 );
+}
+
+} // namespace
+
+int main() {
+    layers_follow_the_camera();
+    bands_fill_every_line();
+    mosaic_keeps_both_halves();
+    return gba::test::result();
+}
@@ -0,0 +1,260 @@
+#include <cstring>
+
+#include <gba/display/rasterizer.hpp>
+
+#include "check.hpp"
+
+using gba::bitmap;
+using gba::bitmap_mode4;
+using gba::int32;
+using gba::mat4x4;
+using gba::raster_fixed;
+using gba::raster_texture;
+using gba::raster_texture_span;
+using gba::raster_vertex;
+using gba::rasterizer;
+using gba::uint8;
+using gba::uint16;
+using gba::uint32;
+
+namespace {
+
+using small8 = bitmap<16, 8, 8>;
+using small16 = bitmap<16, 8, 16>;
+
+uint16 small_pixels[16 * 8];
+
+template <class Bitmap>
+bool matches( const Bitmap& image, const char * const ( & rows )[8] ) {
+    bool same = true;
+    for ( int32 y = 0; y < 8; ++y ) {
+        for ( int32 x = 0; x < 16; ++x ) {
+            const auto expected = rows[y][x] == '.' ? 0 : rows[y][x] - '0';
+            if ( image.get( x, y ) != expected ) {
+                std::fprintf( stderr, "pixel %d,%d is %d, expected %d\n", x, y, int( image.get( x, y ) ), expected );
+                same = false;
+            }
+        }
+    }
+    return same;
+}
+
+template <class Bitmap>
+Bitmap blank() {
+    std::memset( small_pixels, 0, sizeof( small_pixels ) );
+    return Bitmap { small_pixels };
+}
+
+constexpr raster_vertex vertex( const int32 x, const int32 y, const int32 u = 0, const int32 v = 0 ) noexcept {
+    return raster_vertex { raster_fixed( x ), raster_fixed( y ), raster_fixed( u ), raster_fixed( v ) };
+}
+
+template <class Bitmap>
+void golden_flat() {
+    auto image = blank<Bitmap>();
+    rasterizer<Bitmap> raster { image };
+    raster.fill( vertex( 0, 0 ), vertex( 8, 0 ), vertex( 0, 8 ), 1 );
+    raster.fill( vertex( 8, 0 ), vertex( 8, 8 ), vertex( 0, 8 ), 2 ); // shares the diagonal
+    raster.fill( vertex( 12, -4 ), vertex( 20, 4 ), vertex( 10, 12 ), 3 ); // clipped
+    GBAXX_CHECK( raster.triangles() == 3 );
+    GBAXX_CHECK( matches( image, {
+        "11111112...33333",
+        "11111122...33333",
+        "11111222...33333",
+        "11112222...33333",
+        "11122222...33333",
+        "11222222...33333",
+        "12222222...33333",
+        "22222222...33333"
+    } ) );
+
+    // Degenerate and offscreen triangles draw nothing
+    uint16 before[16 * 8];
+    std::memcpy( before, small_pixels, sizeof( before ) );
+    raster.fill( vertex( 0, 0 ), vertex( 16, 8 ), vertex( 8, 4 ), 4 );
+    raster.fill( vertex( 0, 20 ), vertex( 8, 20 ), vertex( 4, 30 ), 4 );
+    raster.fill( vertex( -9, 0 ), vertex( -1, 0 ), vertex( -5, 8 ), 4 );
+    GBAXX_CHECK( std::memcmp( before, small_pixels, sizeof( before ) ) == 0 );
+}
+
+void far_vertices_clip() {
+    // Nearly vertical edges from far above the screen to far below it; the first row walked is row 0
+    auto image = blank<small8>();
+    rasterizer<small8> raster { image };
+    raster.fill( vertex( 2, -16000 ), vertex( 14, -16000 ), vertex( 8, 16000 ), 6 );
+    GBAXX_CHECK( matches( image, {
+        ".....666666.....",
+        ".....666666.....",
+        ".....666666.....",
+        ".....666666.....",
+        ".....666666.....",
+        ".....666666.....",
+        ".....666666.....",
+        ".....666666....."
+    } ) );
+
+    // Middle vertices above and below the screen, with the shared edge crossing it near x = 8
+    image = blank<small8>();
+    raster.target() = image;
+    raster.fill( vertex( 0, -16000 ), vertex( 16, -16000 ), vertex( 0, 16000 ), 7 );
+    raster.fill( vertex( 16, -16000 ), vertex( 16, 16000 ), vertex( 0, 16000 ), 8 );
+    GBAXX_CHECK( matches( image, {
+        "7777777788888888",
+        "7777777788888888",
+        "7777777788888888",
+        "7777777788888888",
+        "7777777788888888",
+        "7777777788888888",
+        "7777777788888888",
+        "7777777788888888"
+    } ) );
+}
+
+void golden_textured() {
+    const uint8 texels[4 * 4] = {
+        1, 2, 3, 4,
+        5, 6, 7, 8,
+        9, 1, 2, 3,
+        4, 5, 6, 7
+    };
+    const raster_texture texture { texels, 2, 2 };
+
+    // One texel per pixel, then wrapping across a wider quad at half scale
+    auto image = blank<small8>();
+    rasterizer<small8> raster { image };
+    raster.fill( vertex( 1, 0, 0, 0 ), vertex( 5, 0, 4, 0 ), vertex( 1, 4, 0, 4 ), texture );
+    raster.fill( vertex( 5, 0, 4, 0 ), vertex( 5, 4, 4, 4 ), vertex( 1, 4, 0, 4 ), texture );
+    raster.fill( vertex( 6, 0, 0, 0 ), vertex( 16, 0, 5, 0 ), vertex( 6, 8, 0, 4 ), texture );
+    raster.fill( vertex( 16, 0, 5, 0 ), vertex( 16, 8, 5, 4 ), vertex( 6, 8, 0, 4 ), texture );
+    GBAXX_CHECK( matches( image, {
+        ".1234.1122334411",
+        ".5678.1122334411",
+        ".9123.5566778855",
+        ".4567.5566778855",
+        "......9911223399",
+        "......9911223399",
+        "......4455667744",
+        "......4455667744"
+    } ) );
+}
+
+void texture_span_alignment() {
+    uint8 texels[8 * 2];
+    for ( uint32 ii = 0; ii < sizeof( texels ); ++ii ) {
+        texels[ii] = uint8( 10 + ii );
+    }
+    const raster_texture texture { texels, 3, 1 };
+
+    // Every start and end alignment writes exactly its pixels, leaving the neighbours alone
+    alignas( 4 ) uint16 row[16];
+    uint32 wrong = 0;
+    for ( int32 x0 = 0; x0 < 16; ++x0 ) {
+        for ( int32 x1 = x0 + 1; x1 <= 32; ++x1 ) {
+            std::memset( row, 0xee, sizeof( row ) );
+            raster_texture_span( row, x0, x1, 3u << 16, 1u << 16, 1u << 16, 0, texture );
+            const auto * bytes = reinterpret_cast<const uint8 *>( row );
+            for ( int32 x = 0; x < 32; ++x ) {
+                const auto expected = x >= x0 && x < x1 ? uint8( 18 + ( ( 3 + x - x0 ) & 7 ) ) : uint8( 0xee );
+                wrong += bytes[x] != expected;
+            }
+        }
+    }
+    GBAXX_CHECK( wrong == 0 );
+}
+
+/**
+ * Counts how often each pixel is filled; stands in for a bitmap
+ */
+struct coverage {
+    using pixel = uint8;
+    static constexpr int32 width = 240;
+    static constexpr int32 height = 160;
+    static constexpr uint32 pitch = width;
+
+    uint8 * counts;
+
+    void hline( const int32 x0, const int32 x1, const int32 y, pixel ) const noexcept {
+        for ( auto x = x0; x <= x1; ++x ) {
+            ++counts[y * width + x];
+        }
+    }
+};
+
+void jittered_mesh_covers_once() {
+    static uint8 counts[coverage::width * coverage::height];
+    constexpr int32 columns = 13;
+    constexpr int32 rows = 9;
+
+    uint32 seed = 2024;
+    for ( int pass = 0; pass < 20; ++pass ) {
+        // A grid past every screen edge, each inner vertex moved by up to 4.5 pixels in 16.16 so every cell stays convex
+        raster_vertex grid[( rows + 1 ) * ( columns + 1 )];
+        for ( int32 y = 0; y <= rows; ++y ) {
+            for ( int32 x = 0; x <= columns; ++x ) {
+                auto& vertex = grid[y * ( columns + 1 ) + x];
+                auto px = ( x * 20 - 10 ) << 16;
+                auto py = ( y * 20 - 10 ) << 16;
+                if ( x > 0 && x < columns && y > 0 && y < rows ) {
+                    seed = seed * 1664525 + 1013904223;
+                    px += int32( ( seed >> 8 ) % ( 9 << 16 ) ) - ( 9 << 15 );
+                    seed = seed * 1664525 + 1013904223;
+                    py += int32( ( seed >> 8 ) % ( 9 << 16 ) ) - ( 9 << 15 );
+                }
+                vertex = raster_vertex { raster_fixed::from_data( px ), raster_fixed::from_data( py ), {}, {} };
+            }
+        }
+
+        std::memset( counts, 0, sizeof( counts ) );
+        rasterizer<coverage> raster { coverage { counts } };
+        for ( int32 y = 0; y < rows; ++y ) {
+            for ( int32 x = 0; x < columns; ++x ) {
+                const auto& a = grid[y * ( columns + 1 ) + x];
+                const auto& b = grid[y * ( columns + 1 ) + x + 1];
+                const auto& c = grid[( y + 1 ) * ( columns + 1 ) + x];
+                const auto& d = grid[( y + 1 ) * ( columns + 1 ) + x + 1];
+                // Alternate the diagonal and the winding
+                if ( ( x + y ) & 1 ) {
+                    raster.fill( a, b, d, 1 );
+                    raster.fill( d, c, a, 1 );
+                } else {
+                    raster.fill( a, b, c, 1 );
+                    raster.fill( b, d, c, 1 );
+                }
+            }
+        }
+
+        uint32 wrong = 0;
+        for ( const auto count : counts ) {
+            wrong += count != 1;
+        }
+        GBAXX_CHECK( wrong == 0 );
+    }
+}
+
+void projects_to_the_viewport() {
+    const mat4x4<raster_fixed> identity;
+    raster_vertex out {};
+    GBAXX_CHECK( rasterizer<bitmap_mode4>::project( identity, raster_fixed( 0.5 ), raster_fixed( -0.5 ), raster_fixed( 0 ), out ) );
+    GBAXX_CHECK( out.x == raster_fixed( 180 ) && out.y == raster_fixed( 120 ) );
+
+    // w = -z: points in front have negative z
+    auto perspective = identity;
+    perspective.column2.w = raster_fixed( -1 );
+    perspective.column3.w = raster_fixed( 0 );
+    GBAXX_CHECK( rasterizer<bitmap_mode4>::project( perspective, raster_fixed( 1 ), raster_fixed( 1 ), raster_fixed( -2 ), out ) );
+    GBAXX_CHECK( out.x == raster_fixed( 180 ) && out.y == raster_fixed( 40 ) );
+    GBAXX_CHECK( !rasterizer<bitmap_mode4>::project( perspective, raster_fixed( 0 ), raster_fixed( 0 ), raster_fixed( 1 ), out ) );
+}
+
+} // namespace
+
+int main() {
+    golden_flat<small8>();
+    golden_flat<small16>();
+    far_vertices_clip();
+    golden_textured();
+    texture_span_alignment();
+    jittered_mesh_covers_once();
+    projects_to_the_viewport();
+    return gba::test::result();
+}
@@ -0,0 +1,233 @@
+#include <cstring>
+
+#include <gba/display/text_renderer.hpp>
+
+#include "check.hpp"
+
+using gba::font_1bpp;
+using gba::screen_size_regular;
+using gba::screen_tile;
+using gba::text_renderer;
+using gba::uint8;
+using gba::uint16;
+using gba::uint32;
+
+namespace {
+
+static_assert( text_renderer<>::expand( 0x01, 3 ) == 0x00000003, "bit 0 is the leftmost pixel" );
+static_assert( text_renderer<>::expand( 0x81, 15 ) == 0xf000000f, "bit 7 is the rightmost pixel" );
+static_assert( text_renderer<>::expand( 0x15a, 1 ) == 0x01011010, "only the low 8 bits are expanded" );
+
+// 'A' is a 3 pixel letter advancing 4, 'B' a bar advancing 2 and 'C' a 3 pixel space
+constexpr uint8 glyphs[] = {
+    0x2, 0x5, 0x7, 0x5, 0x5,
+    0x1, 0x1, 0x1, 0x1, 0x1,
+    0x0, 0x0, 0x0, 0x0, 0x0
+};
+constexpr uint8 widths[] = { 4, 2, 3 };
+constexpr font_1bpp font { glyphs, widths, 'A', 3, 5 };
+
+constexpr uint32 start_index = 32;
+
+uint32 tiles[64 * 8];
+screen_tile screen[64 * 32];
+
+void clear() {
+    std::memset( tiles, 0xcc, sizeof( tiles ) );
+    std::memset( screen, 0, sizeof( screen ) );
+}
+
+/**
+ * Compare tiles shown along a row of the screen against rows of text: '.' is 0, a digit is that color
+ */
+template <unsigned Columns>
+bool shows( const uint32 column, const uint32 row, const char * const ( & rows )[8], const uint32 screenWidth = 32 ) {
+    bool same = true;
+    for ( uint32 cc = 0; cc < Columns; ++cc ) {
+        const auto x = column + cc;
+        const auto block = x / 32 + ( row / 32 ) * ( screenWidth / 32 );
+        const auto& entry = screen[block * 1024 + ( row % 32 ) * 32 + x % 32];
+        const auto * tile = tiles + ( entry.tile_index - start_index ) * 8;
+        for ( uint32 y = 0; y < 8; ++y ) {
+            for ( uint32 px = 0; px < 8; ++px ) {
+                const auto expected = rows[y][cc * 8 + px] == '.' ? 0u : uint32( rows[y][cc * 8 + px] - '0' );
+                const auto pixel = tile[y] >> ( px * 4 ) & 0xf;
+                if ( pixel != expected ) {
+                    std::fprintf( stderr, "tile %u pixel %u,%u is %u, expected %u\n", cc, px, y, pixel, expected );
+                    same = false;
+                }
+            }
+        }
+    }
+    return same;
+}
+
+void golden_packing() {
+    clear();
+    text_renderer<64> text { tiles, start_index, 64, screen, screen_size_regular::_32x32, font };
+    GBAXX_CHECK( text.measure( "ABACAB\nAAAA" ) == 19 );
+    GBAXX_CHECK( text.print( 2, 3, "ABACAB", 2 ) == 1 );
+
+    // Glyphs pack across tile edges; the last tile is partly filled
+    GBAXX_CHECK( shows<3>( 2, 3, {
+        ".2..2..2......2..2......",
+        "2.2.2.2.2....2.2.2......",
+        "222.2.222....222.2......",
+        "2.2.2.2.2....2.2.2......",
+        "2.2.2.2.2....2.2.2......",
+        "........................",
+        "........................",
+        "........................"
+    } ) );
+    GBAXX_CHECK( text.tiles_used() == 4 );
+    GBAXX_CHECK( text.stats().uploads == 3 );
+
+    // A new line restarts at the first column, with its own packing
+    GBAXX_CHECK( text.print( 0, 5, "B\nBB", 7, 4 ) == 2 );
+    GBAXX_CHECK( shows<1>( 0, 5, {
+        "7.......",
+        "7.......",
+        "7.......",
+        "7.......",
+        "7.......",
+        "........",
+        "........",
+        "........"
+    } ) );
+    GBAXX_CHECK( shows<1>( 0, 6, {
+        "7.7.....",
+        "7.7.....",
+        "7.7.....",
+        "7.7.....",
+        "7.7.....",
+        "........",
+        "........",
+        "........"
+    } ) );
+    GBAXX_CHECK( screen[6 * 32].palette_bank == 4 );
+
+    // Characters outside the font are skipped
+    text.print( 0, 8, "A?B", 2 );
+    text.print( 0, 9, "AB", 2 );
+    GBAXX_CHECK( screen[8 * 32].tile_index == screen[9 * 32].tile_index );
+}
+
+void cache_reuses_tiles() {
+    clear();
+    text_renderer<64> text { tiles, start_index, 64, screen, screen_size_regular::_32x32, font };
+    text.print( 0, 0, "ABAB", 1 );
+    const auto uploads = text.stats().uploads;
+    GBAXX_CHECK( uploads == 2 );
+
+    // The same text at the same alignment uploads nothing
+    text.print( 10, 4, "ABAB", 1 );
+    GBAXX_CHECK( text.stats().uploads == uploads );
+    GBAXX_CHECK( text.stats().hits == 2 );
+    GBAXX_CHECK( screen[4 * 32 + 10].tile_index == screen[0].tile_index );
+    GBAXX_CHECK( screen[4 * 32 + 11].tile_index == screen[1].tile_index );
+
+    // Another color, or another alignment, is another tile
+    text.print( 0, 1, "ABAB", 3 );
+    GBAXX_CHECK( text.stats().uploads == uploads + 2 );
+    text.print( 0, 2, "BABAB", 1 );
+    GBAXX_CHECK( screen[2 * 32].tile_index != screen[0].tile_index );
+
+    // Blank tiles share the first tile and are not counted
+    const auto tilesBefore = text.stats().tiles;
+    text.print( 0, 9, "CCC", 1 );
+    GBAXX_CHECK( screen[9 * 32].tile_index == start_index && screen[9 * 32 + 1].tile_index == start_index );
+    GBAXX_CHECK( text.stats().tiles == tilesBefore );
+    GBAXX_CHECK( tiles[0] == 0 && tiles[7] == 0 );
+
+    // reset() forgets everything
+    text.reset();
+    GBAXX_CHECK( text.tiles_used() == 1 );
+    text.print( 0, 0, "ABAB", 1 );
+    GBAXX_CHECK( screen[0].tile_index == start_index + 1 );
+}
+
+void runs_out_of_tiles() {
+    clear();
+    text_renderer<16> text { tiles, start_index, 3, screen, screen_size_regular::_32x32, font };
+    text.print( 0, 0, "ABAB", 1 );
+    GBAXX_CHECK( text.tiles_used() == 3 );
+
+    // Tiles that do not fit fall back to the blank tile
+    text.print( 0, 1, "ABAB", 2 );
+    GBAXX_CHECK( text.tiles_used() == 3 );
+    GBAXX_CHECK( text.stats().failures == 2 );
+    GBAXX_CHECK( screen[32].tile_index == start_index && screen[33].tile_index == start_index );
+}
+
+void wide_screens_span_blocks() {
+    clear();
+    text_renderer<64> text { tiles, start_index, 64, screen, screen_size_regular::_64x32, font };
+    text.print( 31, 0, "ABACAB", 5 );
+    GBAXX_CHECK( shows<3>( 31, 0, {
+        ".5..5..5......5..5......",
+        "5.5.5.5.5....5.5.5......",
+        "555.5.555....555.5......",
+        "5.5.5.5.5....5.5.5......",
+        "5.5.5.5.5....5.5.5......",
+        "........................",
+        "........................",
+        "........................"
+    }, 64 ) );
+    GBAXX_CHECK( screen[31].tile_index != 0 && screen[1024].tile_index != 0 && screen[32].tile_index == 0 );
+}
+
+void text_clips_at_the_screen_edge() {
+    clear();
+    text_renderer<64> text { tiles, start_index, 64, screen, screen_size_regular::_32x32, font };
+    text.print( 30, 0, "AAAAAAAAAAAA", 1 );
+    GBAXX_CHECK( screen[30].tile_index != 0 && screen[31].tile_index != 0 );
+
+    // Columns past the right edge write neither the next row nor the next screen block
+    uint32 written = 0;
+    for ( uint32 ii = 32; ii < 64 * 32; ++ii ) {
+        written += screen[ii].tile_index != 0;
+    }
+    GBAXX_CHECK( written == 0 );
+    GBAXX_CHECK( text.stats().tiles == 2 );
+
+    // Rows past the bottom edge are counted but not drawn
+    GBAXX_CHECK( text.print( 0, 31, "A\nA", 1 ) == 2 );
+    GBAXX_CHECK( screen[31 * 32].tile_index != 0 );
+    for ( uint32 ii = 1024; ii < 64 * 32; ++ii ) {
+        written += screen[ii].tile_index != 0;
+    }
+    GBAXX_CHECK( written == 0 );
+}
+
+void tall_fonts_stop_at_eight_rows() {
+    static constexpr uint8 tallGlyphs[] = { 0x1, 0x2, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80, 0xff, 0xff };
+    static constexpr uint8 tallWidths[] = { 8 };
+    constexpr font_1bpp tall { tallGlyphs, tallWidths, 'A', 1, 10 };
+
+    clear();
+    text_renderer<16> text { tiles, start_index, 16, screen, screen_size_regular::_32x32, tall };
+    text.print( 0, 0, "AA", 6 );
+    GBAXX_CHECK( shows<2>( 0, 0, {
+        "6.......6.......",
+        ".6.......6......",
+        "..6.......6.....",
+        "...6.......6....",
+        "....6.......6...",
+        ".....6.......6..",
+        "......6.......6.",
+        ".......6.......6"
+    } ) );
+    GBAXX_CHECK( text.stats().uploads == 1 );
+}
+
+} // namespace
+
+int main() {
+    golden_packing();
+    cache_reuses_tiles();
+    runs_out_of_tiles();
+    wide_screens_span_blocks();
+    text_clips_at_the_screen_edge();
+    tall_fonts_stop_at_eight_rows();
+    return gba::test::result();
+}
@@ -0,0 +1,190 @@
+#include <gba/display/tile_cache.hpp>
+#include <gba/display/tilemap_streamer.hpp>
+
+#include "check.hpp"
+
+using gba::cached_world;
+using gba::cpu_copy;
+using gba::int32;
+using gba::screen_size_regular;
+using gba::screen_tile;
+using gba::tile_cache;
+using gba::tile_flip;
+using gba::tile_id_map;
+using gba::tilemap_streamer;
+using gba::uint8;
+using gba::uint16;
+using gba::uint32;
+
+namespace {
+
+constexpr uint32 world_tiles = 3000;
+constexpr uint32 start_index = 64;
+
+// Every word of a tile names its world id, so a slot's contents show which tile it holds
+tile_cache<4>::tile_data source[world_tiles];
+uint32 vram[1024 * 8];
+
+bool holds( const uint16 index, const uint32 world ) {
+    if ( index < start_index ) {
+        return false;
+    }
+    const auto * tile = vram + ( index - start_index ) * 8;
+    for ( uint32 ii = 0; ii < 8; ++ii ) {
+        if ( tile[ii] != source[world][ii] ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void hits_and_misses() {
+    tile_cache<4, world_tiles> cache { vram, start_index, source };
+    const auto a = cache.acquire( 10 );
+    GBAXX_CHECK( a == start_index );
+    GBAXX_CHECK( holds( a, 10 ) );
+    GBAXX_CHECK( cache.acquire( 10 ) == a );
+    GBAXX_CHECK( cache.references( 10 ) == 2 );
+
+    // Ids beyond the 10 bits of a screen entry's tile_index
+    const auto b = cache.acquire( 2500 );
+    GBAXX_CHECK( b != cache.none && b != a );
+    GBAXX_CHECK( holds( b, 2500 ) );
+
+    GBAXX_CHECK( cache.stats().hits == 1 );
+    GBAXX_CHECK( cache.stats().misses == 2 );
+    GBAXX_CHECK( cache.find( 11 ) == cache.none );
+}
+
+void evicts_least_recently_released() {
+    tile_cache<4, world_tiles> cache { vram, start_index, source };
+    for ( uint32 id = 0; id < 4; ++id ) {
+        cache.acquire( id );
+    }
+    GBAXX_CHECK( cache.acquire( 4 ) == cache.none );
+    GBAXX_CHECK( cache.stats().failures == 1 );
+
+    cache.release( 2 );
+    cache.release( 0 );
+    cache.release( 3 );
+
+    // Released tiles stay resident, and a hit takes one back off the free list
+    GBAXX_CHECK( cache.find( 2 ) != cache.none );
+    cache.acquire( 0 );
+
+    const auto slotOf2 = cache.find( 2 );
+    GBAXX_CHECK( cache.acquire( 100 ) == slotOf2 );
+    GBAXX_CHECK( cache.find( 2 ) == cache.none );
+    GBAXX_CHECK( cache.acquire( 101 ) != cache.none );
+    GBAXX_CHECK( cache.find( 3 ) == cache.none );
+    GBAXX_CHECK( cache.find( 0 ) != cache.none && cache.find( 1 ) != cache.none );
+    GBAXX_CHECK( cache.stats().evictions == 2 );
+    GBAXX_CHECK( cache.acquire( 102 ) == cache.none );
+}
+
+constexpr uint32 world_width = 160;
+constexpr uint32 world_height = 96;
+
+uint16 ids[world_width * world_height];
+uint8 attributes[world_width * world_height];
+screen_tile screen[32 * 32];
+
+struct camera_move {
+    int32 dx;
+    int32 dy;
+    uint32 frames;
+};
+
+constexpr camera_move camera_path[] = {
+    { 2, 0, 200 },
+    { 0, 3, 120 },
+    { -5, 1, 150 },
+    { 4, -4, 80 },
+    { 1000, 0, 1 },
+    { -3, 2, 200 },
+    { 7, 7, 60 },
+    { -8, -8, 90 }
+};
+
+void camera_path_through_a_large_world() {
+    // World ids run well past 1024, with runs of repeats so the view reuses tiles
+    for ( uint32 y = 0; y < world_height; ++y ) {
+        for ( uint32 x = 0; x < world_width; ++x ) {
+            ids[y * world_width + x] = uint16( ( ( x / 2 ) * 37 + ( y / 2 ) * 101 ) % world_tiles );
+            attributes[y * world_width + x] = uint8( ( ( x + y ) & 0x3 ) << 2 | ( y & 0xf ) << 4 );
+        }
+    }
+
+    using cache_type = tile_cache<512, world_tiles>;
+    using world_type = cached_world<tile_id_map, cache_type, screen_size_regular::_32x32>;
+    cache_type cache { vram, start_index, source };
+    const tile_id_map map { ids, attributes, world_width, world_height };
+    world_type world { map, cache };
+    tilemap_streamer<world_type, cpu_copy> streamer { world, screen, world_type::screen_size };
+
+    int32 x = 0;
+    int32 y = 0;
+    uint32 wrongFrames = 0;
+    uint32 highest = 0;
+    streamer.update();
+    for ( const auto& move : camera_path ) {
+        for ( uint32 ii = 0; ii < move.frames; ++ii ) {
+            x += move.dx;
+            y += move.dy;
+            streamer.scroll_to( x, y );
+            x = int32( streamer.camera_x() );
+            y = int32( streamer.camera_y() );
+            streamer.update();
+
+            // Every visible entry shows its world tile's graphics, flip and palette bank
+            uint32 wrong = 0;
+            const auto left = streamer.camera_x() / 8;
+            const auto top = streamer.camera_y() / 8;
+            for ( auto ty = top; ty < top + 21 && ty < world_height; ++ty ) {
+                for ( auto tx = left; tx < left + 31 && tx < world_width; ++tx ) {
+                    const auto entry = screen[streamer.ring_index( tx, ty )];
+                    const auto id = map.id( tx, ty );
+                    const auto attribute = map.attributes( tx, ty );
+                    highest = id > highest ? id : highest;
+                    if ( world.held( tx, ty ) != id || !holds( entry.tile_index, id ) || entry.flip != tile_flip( attribute >> 2 & 0x3 ) || entry.palette_bank != attribute >> 4 ) {
+                        ++wrong;
+                    }
+                }
+            }
+            wrongFrames += wrong != 0;
+        }
+    }
+    GBAXX_CHECK( wrongFrames == 0 );
+    GBAXX_CHECK( highest >= 1024 );
+    GBAXX_CHECK( cache.stats().failures == 0 );
+    GBAXX_CHECK( cache.stats().evictions > 0 );
+    GBAXX_CHECK( cache.stats().hits > cache.stats().misses );
+
+    // Each screen block entry holds exactly one reference
+    uint32 references = 0;
+    uint32 held = 0;
+    for ( uint32 id = 0; id < world_tiles; ++id ) {
+        references += cache.references( id );
+    }
+    for ( uint32 ty = 0; ty < 32; ++ty ) {
+        for ( uint32 tx = 0; tx < 32; ++tx ) {
+            held += world.held( tx, ty ) != world_type::empty;
+        }
+    }
+    GBAXX_CHECK( references == held );
+}
+
+} // namespace
+
+int main() {
+    for ( uint32 id = 0; id < world_tiles; ++id ) {
+        for ( uint32 ii = 0; ii < 8; ++ii ) {
+            source[id][ii] = id << 8 | ii;
+        }
+    }
+
+    hits_and_misses();
+    evicts_least_recently_released();
+    camera_path_through_a_large_world();
+    return gba::test::result();
+}
@@ -0,0 +1,164 @@
+#include <gba/display/tile_convert.hpp>
+
+#include "check.hpp"
+
+using gba::make_palette;
+using gba::make_tileset;
+using gba::rgb15;
+using gba::tile_dedup;
+using gba::tile_flip;
+using gba::tileset;
+using gba::uint8;
+using gba::uint16;
+using gba::uint32;
+
+namespace {
+
+static_assert( rgb15( 0xffffff ) == 0x7fff && rgb15( 0x000000 ) == 0, "rgb15 must map the extremes" );
+static_assert( rgb15( 0xff0000 ) == 0x001f && rgb15( 0x00ff00 ) == 0x03e0 && rgb15( 0x0000ff ) == 0x7c00, "rgb15 must place red low and blue high" );
+static_assert( rgb15( 0x808080 ) == ( 16 | 16 << 5 | 16 << 10 ), "rgb15 must round to nearest" );
+static_assert( make_palette<2>( { 0xff0000, 0x0000ff } )[1] == 0x7c00, "make_palette must convert every color" );
+
+constexpr uint32 columns = 4;
+constexpr uint32 rows = 2;
+constexpr uint32 width = columns * 8;
+constexpr uint32 height = rows * 8;
+
+using image = std::array<uint8, width * height>;
+
+// An asymmetric tile: a diagonal, an L in the corner and a lone pixel
+constexpr uint8 pattern( const uint32 x, const uint32 y ) noexcept {
+    if ( x == y ) {
+        return 1;
+    }
+    if ( ( y == 6 && x < 3 ) || ( x == 0 && y > 3 ) ) {
+        return 2;
+    }
+    return x == 6 && y == 1 ? 3 : 0;
+}
+
+/**
+ * Row by row: the pattern, again, mirrored horizontally, vertically and both, blank, the pattern with its pixels
+ * moved (same colors, so the same signature, but no flip matches) and blank; every value is offset by base
+ */
+constexpr image make_image( const uint8 base ) noexcept {
+    image pixels {};
+    for ( uint32 tt = 0; tt < columns * rows; ++tt ) {
+        for ( uint32 y = 0; y < 8; ++y ) {
+            for ( uint32 x = 0; x < 8; ++x ) {
+                uint8 value = 0;
+                switch ( tt ) {
+                    case 0: case 1: value = pattern( x, y ); break;
+                    case 2: value = pattern( 7 - x, y ); break;
+                    case 3: value = pattern( x, 7 - y ); break;
+                    case 4: value = pattern( 7 - x, 7 - y ); break;
+                    case 6: value = pattern( ( x + 3 ) % 8, y ); break;
+                    default: break;
+                }
+                pixels[( ( tt / columns ) * 8 + y ) * width + ( tt % columns ) * 8 + x] = value ? uint8( base + value ) : 0;
+            }
+        }
+    }
+    return pixels;
+}
+
+constexpr auto plain = make_image( 0 );
+constexpr auto banked = make_image( 0x30 );
+
+template <unsigned Bpp, unsigned Tiles>
+constexpr uint32 pixel_of( const tileset<Bpp, Tiles>& set, const uint32 tt, uint32 x, uint32 y ) noexcept {
+    const auto& entry = set.map[tt];
+    x = uint32( entry.flip ) & 1 ? 7 - x : x;
+    y = uint32( entry.flip ) & 2 ? 7 - y : y;
+    const auto * tile = set.tile( entry.tile_index );
+    if constexpr ( Bpp == 4 ) {
+        const auto value = tile[y] >> ( x * 4 ) & 0xf;
+        return value ? value | entry.palette_bank << 4 : 0;
+    } else {
+        return tile[y * 2 + x / 4] >> ( ( x % 4 ) * 8 ) & 0xff;
+    }
+}
+
+/**
+ * The tiles and map show the image again
+ */
+template <unsigned Bpp, unsigned Tiles>
+constexpr bool reconstructs( const tileset<Bpp, Tiles>& set, const image& pixels ) noexcept {
+    for ( uint32 tt = 0; tt < Tiles; ++tt ) {
+        for ( uint32 y = 0; y < 8; ++y ) {
+            for ( uint32 x = 0; x < 8; ++x ) {
+                if ( pixel_of( set, tt, x, y ) != pixels[( ( tt / columns ) * 8 + y ) * width + ( tt % columns ) * 8 + x] ) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+constexpr auto none8 = make_tileset<8, width, height>( plain, tile_dedup::none );
+constexpr auto exact8 = make_tileset<8, width, height>( plain, tile_dedup::exact );
+constexpr auto flipped8 = make_tileset<8, width, height>( plain, tile_dedup::flipped );
+constexpr auto flipped4 = make_tileset<4, width, height>( banked );
+
+static_assert( none8.count == 8, "no dedup keeps every tile" );
+static_assert( exact8.count == 6, "exact dedup merges the repeat and the second blank" );
+static_assert( flipped8.count == 3, "flipped dedup leaves the pattern, blank and the moved pattern" );
+static_assert( flipped4.count == 3, "4bpp dedup matches 8bpp" );
+static_assert( flipped8.size() == 3 * 64 && flipped4.size() == 3 * 32, "size counts only unique tiles" );
+
+static_assert( exact8.map[1].tile_index == 0 && exact8.map[7].tile_index == exact8.map[5].tile_index, "exact repeats share a tile" );
+static_assert( exact8.map[2].tile_index != 0 && exact8.map[2].flip == tile_flip::none, "exact dedup does not flip" );
+
+static_assert( flipped8.map[2].tile_index == 0 && flipped8.map[2].flip == tile_flip::horizontal, "mirrored tiles flip horizontally" );
+static_assert( flipped8.map[3].tile_index == 0 && flipped8.map[3].flip == tile_flip::vertical, "mirrored tiles flip vertically" );
+static_assert( flipped8.map[4].tile_index == 0 && flipped8.map[4].flip == tile_flip::both, "mirrored tiles flip both ways" );
+static_assert( flipped8.map[6].tile_index == 2 && flipped8.map[6].flip == tile_flip::none, "a tile with the same colors but another shape is kept" );
+
+static_assert( flipped4.map[0].palette_bank == 3 && flipped4.map[5].palette_bank == 0, "4bpp tiles take the bank of their highest index" );
+static_assert( flipped4.tile( 0 )[0] == 0x1, "4bpp tiles store the low 4 bits" );
+
+static_assert( reconstructs( none8, plain ) && reconstructs( exact8, plain ) && reconstructs( flipped8, plain ), "8bpp tiles must rebuild the image" );
+static_assert( reconstructs( flipped4, banked ), "4bpp tiles must rebuild the image" );
+
+// A full screen converts at compile time: 30x20 tiles from eight distinct ones, each also seen mirrored
+constexpr std::array<uint8, 240 * 160> make_screen() noexcept {
+    std::array<uint8, 240 * 160> pixels {};
+    for ( uint32 y = 0; y < 160; ++y ) {
+        for ( uint32 x = 0; x < 240; ++x ) {
+            const auto tx = x / 8;
+            const auto ty = y / 8;
+            const auto px = tx & 1 ? 7 - x % 8 : x % 8;
+            const auto variant = ( tx / 2 + ty * 3 ) % 8;
+            pixels[y * 240 + x] = pattern( px, ( y % 8 + variant ) % 8 ) ? uint8( 1 + variant ) : 0;
+        }
+    }
+    return pixels;
+}
+
+constexpr auto screen = make_tileset<4, 240, 160>( make_screen() );
+static_assert( screen.count == 8, "a full screen dedups to its distinct tiles" );
+static_assert( screen.map[1].flip == tile_flip::horizontal && screen.map[1].tile_index == screen.map[0].tile_index, "odd columns reuse the mirrored tile" );
+
+// At run time, more unique tiles than a screen entry can address shows in the count
+void reports_too_many_tiles() {
+    constexpr uint32 bigColumns = 41;
+    constexpr uint32 bigRows = 25;
+    static std::array<uint8, bigColumns * 8 * bigRows * 8> pixels {};
+    for ( uint32 tt = 0; tt < bigColumns * bigRows; ++tt ) {
+        const auto row = ( tt / bigColumns ) * 8 * bigColumns * 8 + ( tt % bigColumns ) * 8;
+        pixels[row] = uint8( 1 + tt % 255 );
+        pixels[row + 1] = uint8( 1 + tt / 255 );
+    }
+    static const auto set = make_tileset<8, bigColumns * 8, bigRows * 8>( pixels, tile_dedup::exact );
+    GBAXX_CHECK( set.count == bigColumns * bigRows );
+    GBAXX_CHECK( set.count > 1024 );
+}
+
+} // namespace
+
+int main() {
+    GBAXX_CHECK( reconstructs( flipped8, plain ) );
+    reports_too_many_tiles();
+    return gba::test::result();
+}
@@ -0,0 +1,210 @@
+#include <gba/display/tilemap_streamer.hpp>
+
+#include "check.hpp"
+
+using gba::cpu_copy;
+using gba::int32;
+using gba::metatile_world_map;
+using gba::screen_size_regular;
+using gba::screen_tile;
+using gba::tile_flip;
+using gba::tilemap_streamer;
+using gba::uint16;
+using gba::uint32;
+using gba::world_map;
+
+namespace {
+
+constexpr uint32 world_width = 300;
+constexpr uint32 world_height = 60;
+
+// Every entry of the world is distinct: x in the tile index, y across palette bank and flip
+constexpr screen_tile world_tile( const uint32 x, const uint32 y ) noexcept {
+    return screen_tile { uint16( x ), tile_flip( y >> 4 ), uint16( y & 0xf ) };
+}
+
+constexpr bool same( const screen_tile a, const screen_tile b ) noexcept {
+    return a.tile_index == b.tile_index && a.flip == b.flip && a.palette_bank == b.palette_bank;
+}
+
+screen_tile world_tiles[world_width * world_height];
+screen_tile screen[64 * 64];
+
+// Fills the screen block with an entry no world tile uses, so anything not streamed in shows up
+void clear_screen() {
+    for ( auto& entry : screen ) {
+        entry = screen_tile { 0x3ff, tile_flip::both, 0xf };
+    }
+}
+
+/**
+ * Every world tile under the camera is in its ring slot
+ */
+template <class World, class Streamer>
+uint32 stale_entries( const World& world, const Streamer& streamer ) {
+    const auto left = streamer.camera_x() / 8;
+    const auto top = streamer.camera_y() / 8;
+    uint32 stale = 0;
+    for ( auto y = top; y < top + Streamer::view_rows && y < world.height(); ++y ) {
+        for ( auto x = left; x < left + Streamer::view_columns && x < world.width(); ++x ) {
+            screen_tile expected;
+            world.row( x, y, 1, &expected );
+            if ( !same( screen[streamer.ring_index( x, y )], expected ) ) {
+                ++stale;
+            }
+        }
+    }
+    return stale;
+}
+
+struct camera_move {
+    int32 dx;
+    int32 dy;
+    uint32 frames;
+};
+
+// Pans, diagonals, reversals, a teleport and pushes past every edge
+constexpr camera_move camera_path[] = {
+    { 1, 0, 40 },
+    { 3, 0, 100 },
+    { 0, 2, 60 },
+    { 5, 5, 40 },
+    { -7, 0, 80 },
+    { 0, -3, 100 },
+    { 8, 8, 30 },
+    { -8, -8, 30 },
+    { 1000, 0, 1 },
+    { 6, -1, 80 },
+    { -2000, 2000, 1 },
+    { 4, -4, 120 },
+    { 0, 0, 5 },
+    { -3, 7, 50 }
+};
+
+template <class World>
+void follow_camera_path( const World& world, const screen_size_regular size ) {
+    clear_screen();
+    using streamer_type = tilemap_streamer<const World, cpu_copy>;
+    streamer_type streamer { world, screen, size };
+    streamer.update();
+    GBAXX_CHECK( streamer.last_written() == streamer_type::view_columns * streamer_type::view_rows );
+    GBAXX_CHECK( stale_entries( world, streamer ) == 0 );
+
+    int32 x = 0;
+    int32 y = 0;
+    uint32 staleFrames = 0;
+    uint32 overBudget = 0;
+    for ( const auto& move : camera_path ) {
+        for ( uint32 ii = 0; ii < move.frames; ++ii ) {
+            x += move.dx;
+            y += move.dy;
+            streamer.scroll_to( x, y );
+            x = int32( streamer.camera_x() );
+            y = int32( streamer.camera_y() );
+
+            const auto written = streamer.update();
+            if ( stale_entries( world, streamer ) ) {
+                ++staleFrames;
+            }
+
+            // Moving at most a tile per axis exposes at most one row and one column
+            if ( move.dx <= 8 && move.dx >= -8 && move.dy <= 8 && move.dy >= -8 && written > 21 + 31 ) {
+                ++overBudget;
+            }
+        }
+    }
+    GBAXX_CHECK( staleFrames == 0 );
+    GBAXX_CHECK( overBudget == 0 );
+    GBAXX_CHECK( streamer.peak_written() == 31 * 21 );
+
+    // The scroll registers place the camera within the ring
+    GBAXX_CHECK( streamer.scroll_x() == streamer.camera_x() % ( size == screen_size_regular::_64x32 || size == screen_size_regular::_64x64 ? 512 : 256 ) );
+    GBAXX_CHECK( streamer.scroll_y() == streamer.camera_y() % ( size == screen_size_regular::_32x64 || size == screen_size_regular::_64x64 ? 512 : 256 ) );
+}
+
+void single_steps_write_one_line() {
+    world_map world { world_tiles, world_width, world_height };
+    tilemap_streamer<world_map, cpu_copy> streamer { world, screen, screen_size_regular::_32x32 };
+    streamer.scroll_to( 16, 16 );
+    streamer.update();
+
+    // Within a tile nothing is exposed
+    streamer.scroll_to( 23, 16 );
+    GBAXX_CHECK( streamer.update() == 0 );
+
+    streamer.scroll_to( 24, 16 );
+    GBAXX_CHECK( streamer.update() == 21 );
+    streamer.scroll_to( 24, 8 );
+    GBAXX_CHECK( streamer.update() == 31 );
+    streamer.scroll_to( 32, 16 );
+    GBAXX_CHECK( streamer.update() == 31 + 21 );
+
+    streamer.invalidate();
+    GBAXX_CHECK( streamer.update() == 31 * 21 );
+}
+
+void camera_clamps_to_world() {
+    world_map world { world_tiles, world_width, world_height };
+    tilemap_streamer<world_map, cpu_copy> streamer { world, screen, screen_size_regular::_32x32 };
+    streamer.scroll_to( -50, -50 );
+    GBAXX_CHECK( streamer.camera_x() == 0 && streamer.camera_y() == 0 );
+    streamer.scroll_to( 100000, 100000 );
+    GBAXX_CHECK( streamer.camera_x() == world_width * 8 - 240 );
+    GBAXX_CHECK( streamer.camera_y() == world_height * 8 - 160 );
+
+    // The last partial column and row lie outside the world and are skipped
+    streamer.update();
+    GBAXX_CHECK( streamer.last_written() == 30 * 20 );
+}
+
+void ring_layouts() {
+    world_map world { world_tiles, world_width, world_height };
+    tilemap_streamer<world_map, cpu_copy> wide { world, screen, screen_size_regular::_64x32 };
+    GBAXX_CHECK( wide.ring_index( 31, 0 ) == 31 );
+    GBAXX_CHECK( wide.ring_index( 32, 0 ) == 1024 );
+    GBAXX_CHECK( wide.ring_index( 64, 1 ) == 32 );
+
+    tilemap_streamer<world_map, cpu_copy> tall { world, screen, screen_size_regular::_32x64 };
+    GBAXX_CHECK( tall.ring_index( 0, 32 ) == 1024 );
+    GBAXX_CHECK( tall.ring_index( 33, 64 ) == 1 );
+
+    tilemap_streamer<world_map, cpu_copy> large { world, screen, screen_size_regular::_64x64 };
+    GBAXX_CHECK( large.ring_index( 40, 40 ) == 3 * 1024 + 8 * 32 + 8 );
+}
+
+} // namespace
+
+int main() {
+    for ( uint32 y = 0; y < world_height; ++y ) {
+        for ( uint32 x = 0; x < world_width; ++x ) {
+            world_tiles[y * world_width + x] = world_tile( x, y );
+        }
+    }
+
+    single_steps_write_one_line();
+    camera_clamps_to_world();
+    ring_layouts();
+
+    const world_map world { world_tiles, world_width, world_height };
+    follow_camera_path( world, screen_size_regular::_32x32 );
+    follow_camera_path( world, screen_size_regular::_64x32 );
+    follow_camera_path( world, screen_size_regular::_32x64 );
+    follow_camera_path( world, screen_size_regular::_64x64 );
+
+    // 2x2 metatiles: each map entry picks one of eight blocks of four distinct entries
+    static metatile_world_map::metatile metatiles[8];
+    for ( uint32 ii = 0; ii < 8; ++ii ) {
+        for ( uint32 jj = 0; jj < 4; ++jj ) {
+            metatiles[ii][jj] = world_tile( ii * 4 + jj, ii );
+        }
+    }
+    static uint16 map[( world_width / 2 ) * ( world_height / 2 )];
+    for ( uint32 ii = 0; ii < sizeof( map ) / sizeof( map[0] ); ++ii ) {
+        map[ii] = uint16( ( ii * 5 + ii / 7 ) % 8 );
+    }
+    const metatile_world_map metaWorld { map, world_width / 2, world_height / 2, metatiles };
+    follow_camera_path( metaWorld, screen_size_regular::_32x32 );
+    follow_camera_path( metaWorld, screen_size_regular::_64x64 );
+
+    return gba::test::result();
+}
@@ -0,0 +1,121 @@
+#include <cstdlib>
+#include <new>
+
+#include <gba/ext/agbabi/fiber.hpp>
+#include <gba/ext/agbabi/pull_coroutine.hpp>
+#include <gba/ext/agbabi/push_coroutine.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+int allocations = 0;
+
+// Captured state larger than std::function's small buffer, so a type-erased path would allocate
+struct payload {
+    int values[16];
+    int * destroyed;
+
+    payload( int * counter ) noexcept : values {}, destroyed { counter } {}
+    payload( payload&& other ) noexcept : values {}, destroyed { other.destroyed } {
+        other.destroyed = nullptr;
+    }
+
+    ~payload() noexcept {
+        if ( destroyed ) {
+            ++*destroyed;
+        }
+    }
+};
+
+gba::agbabi::fiber_stack<0x10000> stack;
+
+void fiber_runs_without_allocating() {
+    int destroyed = 0;
+    int steps = 0;
+    allocations = 0;
+    {
+        gba::agbabi::fiber fib( stack, [state = payload( &destroyed ), &steps]( auto& yield ) mutable {
+            for ( int ii = 0; ii < 3; ++ii ) {
+                state.values[ii] = ++steps;
+                yield();
+            }
+        } );
+
+        int resumed = 0;
+        while ( fib() ) {
+            ++resumed;
+        }
+        GBAXX_CHECK( resumed == 3 );
+        GBAXX_CHECK( steps == 3 );
+    }
+    GBAXX_CHECK( allocations == 0 );
+    GBAXX_CHECK( destroyed == 1 );
+}
+
+void pull_coroutine_generates_without_allocating() {
+    int destroyed = 0;
+    allocations = 0;
+    {
+        gba::agbabi::pull_coroutine<int> squares( stack, [state = payload( &destroyed )]( auto& push ) mutable {
+            for ( int ii = 1; ii <= 4; ++ii ) {
+                state.values[ii] = ii * ii;
+                push( state.values[ii] );
+            }
+        } );
+
+        int sum = 0;
+        for ( const auto value : squares ) {
+            sum += value;
+        }
+        GBAXX_CHECK( sum == 1 + 4 + 9 + 16 );
+    }
+    GBAXX_CHECK( allocations == 0 );
+    GBAXX_CHECK( destroyed == 1 );
+}
+
+void push_coroutine_consumes_without_allocating() {
+    int destroyed = 0;
+    int total = 0;
+    allocations = 0;
+    {
+        gba::agbabi::push_coroutine<int> sink( stack, [state = payload( &destroyed ), &total]( auto& pull ) mutable {
+            for ( int ii = 0; ii < 3; ++ii ) {
+                state.values[ii] = pull();
+                total += state.values[ii];
+            }
+        } );
+
+        sink( 1 );
+        sink( 2 );
+        sink( 3 );
+        GBAXX_CHECK( total == 6 );
+    }
+    GBAXX_CHECK( allocations == 0 );
+    GBAXX_CHECK( destroyed == 1 );
+}
+
+} // namespace
+
+void * operator new( const std::size_t size ) {
+    ++allocations;
+    if ( auto * const p = std::malloc( size ? size : 1 ) ) {
+        return p;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete( void * p ) noexcept {
+    std::free( p );
+}
+
+void operator delete( void * p, std::size_t ) noexcept {
+    std::free( p );
+}
+
+int main() {
+    fiber_runs_without_allocating();
+    pull_coroutine_generates_without_allocating();
+    push_coroutine_consumes_without_allocating();
+    return gba::test::result();
+}
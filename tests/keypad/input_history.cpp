@@ -0,0 +1,172 @@
+#include <gba/keypad/input_history.hpp>
+
+#include "check.hpp"
+
+using gba::input_history;
+using gba::input_sequence;
+using gba::input_step;
+using gba::key_mask;
+using gba::uint32;
+namespace key = gba::key;
+
+namespace {
+
+constexpr auto down_right = key_mask( key::down | key::right );
+
+// Quarter circle forward then A, within 20 frames
+constexpr input_step fireball[] = {
+    input_step::direction( key::down ),
+    input_step::direction( down_right ),
+    input_step::direction( key::right ),
+    input_step::press( key::button_a )
+};
+
+template <unsigned Steps>
+struct player {
+    input_history<16> history {};
+    input_sequence<Steps> sequence;
+    uint32 matches = 0;
+    uint32 matchedOn = 0;
+
+    constexpr player( const input_step ( & steps )[Steps], const uint32 window ) noexcept : sequence { steps, window } {}
+
+    constexpr void feed( const uint32 keys, const uint32 frames = 1 ) noexcept {
+        for ( uint32 ii = 0; ii < frames; ++ii ) {
+            history.push( keys );
+            if ( sequence.update( history ) ) {
+                ++matches;
+                matchedOn = history.frame();
+            }
+        }
+    }
+};
+
+constexpr bool history_tracks_edges() {
+    input_history<4> history;
+    history.push( key::button_a );
+    history.push( key::button_a | key::button_b );
+    history.push( key::button_b );
+    history.push( 0 );
+
+    return history.frame() == 4
+        && history.keys( 3 ) == key::button_a && history.pressed( 3 ) == key::button_a
+        && history.pressed( 2 ) == key::button_b
+        && history.released( 1 ) == key::button_a && history.pressed( 1 ) == 0
+        && history.released( 0 ) == key::button_b && history.keys( 0 ) == 0;
+}
+static_assert( history_tracks_edges(), "input_history must report presses and releases" );
+
+constexpr bool history_wraps() {
+    input_history<2> history;
+    for ( uint32 ii = 0; ii < 5; ++ii ) {
+        history.push( ii );
+    }
+    return history.keys( 0 ) == 4 && history.keys( 1 ) == 3 && history.pressed( 0 ) == 4;
+}
+static_assert( history_wraps(), "input_history must keep the most recent frames" );
+
+void motion_then_button() {
+    player p { fireball, 20 };
+    p.feed( 0, 5 );
+    p.feed( key::down, 3 );
+    p.feed( down_right, 2 );
+    p.feed( key::right, 2 );
+    GBAXX_CHECK( p.matches == 0 );
+    p.feed( key::right | key::button_a );
+    GBAXX_CHECK( p.matches == 1 );
+    GBAXX_CHECK( p.matchedOn == 13 );
+
+    // Completing starts matching over: holding A or repeating it without the motion does nothing
+    p.feed( key::right | key::button_a, 3 );
+    p.feed( key::right );
+    p.feed( key::right | key::button_a );
+    GBAXX_CHECK( p.matches == 1 );
+}
+
+void too_slow() {
+    player p { fireball, 20 };
+    p.feed( key::down, 2 );
+    p.feed( down_right, 2 );
+    p.feed( key::right, 18 );
+    p.feed( key::right | key::button_a );
+    GBAXX_CHECK( p.matches == 0 );
+}
+
+void latest_start_is_kept() {
+    // An abandoned motion is superseded by a later one, which completes within the window
+    player p { fireball, 20 };
+    p.feed( key::down, 2 );
+    p.feed( 0, 25 );
+    p.feed( key::down );
+    p.feed( down_right );
+    p.feed( key::right );
+    p.feed( key::button_a );
+    GBAXX_CHECK( p.matches == 1 );
+}
+
+void order_matters() {
+    player p { fireball, 20 };
+    p.feed( key::right, 2 );
+    p.feed( down_right, 2 );
+    p.feed( key::down, 2 );
+    p.feed( key::down | key::button_a );
+    GBAXX_CHECK( p.matches == 0 );
+
+    // Skipping the diagonal breaks the motion
+    p.feed( key::down, 2 );
+    p.feed( key::right, 2 );
+    p.feed( key::right | key::button_a );
+    GBAXX_CHECK( p.matches == 0 );
+}
+
+void button_must_go_down() {
+    player p { fireball, 20 };
+    p.feed( key::down | key::button_a, 2 );
+    p.feed( down_right | key::button_a, 2 );
+    p.feed( key::right | key::button_a, 2 );
+    GBAXX_CHECK( p.matches == 0 );
+}
+
+void steps_use_different_frames() {
+    // Two presses of the same button need a release between them
+    constexpr input_step dash[] = { input_step::press( key::right ), input_step::press( key::right ) };
+    player p { dash, 12 };
+    p.feed( key::right, 6 );
+    GBAXX_CHECK( p.matches == 0 );
+
+    p.feed( 0, 3 );
+    p.feed( key::right );
+    GBAXX_CHECK( p.matches == 1 );
+
+    // Too far apart
+    p.feed( 0, 3 );
+    p.feed( key::right );
+    p.feed( 0, 14 );
+    p.feed( key::right );
+    GBAXX_CHECK( p.matches == 1 );
+}
+
+void press_while_holding() {
+    constexpr input_step uppercut[] = { input_step::press( key::button_b, key::up ) };
+    player p { uppercut, 1 };
+    p.feed( key::button_b );
+    p.feed( 0 );
+    p.feed( key::up | key::left | key::button_b );
+    GBAXX_CHECK( p.matches == 0 );
+    p.feed( key::up );
+    p.feed( key::up | key::button_b );
+    GBAXX_CHECK( p.matches == 1 );
+}
+
+} // namespace
+
+int main() {
+    motion_then_button();
+    too_slow();
+    latest_start_is_kept();
+    order_matters();
+    button_must_go_down();
+    steps_use_different_frames();
+    press_while_holding();
+    return gba::test::result();
+}
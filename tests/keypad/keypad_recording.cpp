@@ -0,0 +1,152 @@
+#include <cstring>
+
+#include <gba/keypad/keypad_recording.hpp>
+
+#include "check.hpp"
+
+using gba::keypad;
+using gba::keypad_recorder;
+using gba::keypad_replayer;
+using gba::keypad_rle;
+using gba::keypad_rle_reader;
+using gba::keypad_rle_writer;
+using gba::uint8;
+using gba::uint16;
+using gba::uint32;
+using gba::uint_cast;
+
+namespace {
+
+// Raw KEYINPUT over a play session: idle stretches, held directions, taps and one very long hold
+uint16 session_keys( const uint32 frame ) noexcept {
+    if ( frame < 90 ) {
+        return keypad_rle::released;
+    }
+    if ( frame < 400 ) {
+        return uint16( keypad_rle::released & ~( ( frame / 7 ) & 1 ? 0x10 : 0x01 ) );
+    }
+    if ( frame < 70400 ) {
+        return uint16( keypad_rle::released & ~0x40 );
+    }
+    return uint16( ( frame * 2654435761u ) >> 22 );
+}
+
+constexpr uint32 session_frames = 70600;
+
+uint8 storage[4096];
+
+void round_trip() {
+    keypad_rle_writer writer( storage, sizeof( storage ) );
+    for ( uint32 ii = 0; ii < session_frames; ++ii ) {
+        GBAXX_CHECK( writer.push( session_keys( ii ) ) );
+    }
+    const auto size = writer.finish();
+    GBAXX_CHECK( !writer.overflowed() );
+    GBAXX_CHECK( writer.frames() == session_frames );
+    GBAXX_CHECK( size == writer.size() );
+
+    // Runs are two bytes, long ones four: far smaller than a byte pair per frame
+    GBAXX_CHECK( size < 1024 );
+
+    keypad_rle_reader reader( storage, size );
+    uint32 mismatches = 0;
+    for ( uint32 ii = 0; ii < session_frames; ++ii ) {
+        if ( reader.next() != ( session_keys( ii ) & keypad_rle::key_bits ) ) {
+            ++mismatches;
+        }
+    }
+    GBAXX_CHECK( mismatches == 0 );
+    GBAXX_CHECK( reader.frame() == session_frames );
+    GBAXX_CHECK( reader.done() );
+
+    // Past the end every key reads as released
+    GBAXX_CHECK( reader.next() == keypad_rle::released );
+    GBAXX_CHECK( reader.frame() == session_frames );
+
+    reader.rewind();
+    GBAXX_CHECK( reader.next() == session_keys( 0 ) );
+    GBAXX_CHECK( reader.frame() == 1 );
+}
+
+void run_lengths() {
+    uint8 buffer[16] = {};
+    keypad_rle_writer writer( buffer, sizeof( buffer ) );
+
+    // 63 frames fit a short run; 64 needs a long one
+    for ( int ii = 0; ii < 63; ++ii ) {
+        writer.push( 0x001 );
+    }
+    for ( int ii = 0; ii < 64; ++ii ) {
+        writer.push( 0x002 );
+    }
+    GBAXX_CHECK( writer.finish() == 6 );
+    GBAXX_CHECK( buffer[0] == 0x01 && buffer[1] == ( 63 << 2 ) );
+    GBAXX_CHECK( buffer[2] == 0x02 && buffer[3] == 0 && buffer[4] == 64 && buffer[5] == 0 );
+}
+
+void overflow_stops_recording() {
+    uint8 buffer[4] = {};
+    keypad_rle_writer writer( buffer, sizeof( buffer ) );
+    GBAXX_CHECK( writer.push( 1 ) );
+    GBAXX_CHECK( writer.push( 2 ) );
+    GBAXX_CHECK( writer.push( 3 ) );
+    GBAXX_CHECK( !writer.push( 4 ) );
+    GBAXX_CHECK( writer.overflowed() );
+    GBAXX_CHECK( writer.finish() == 4 );
+    GBAXX_CHECK( writer.frames() == 2 );
+
+    keypad_rle_reader reader( buffer, writer.size() );
+    GBAXX_CHECK( reader.next() == 1 );
+    GBAXX_CHECK( reader.next() == 2 );
+    GBAXX_CHECK( reader.done() );
+}
+
+// Stands in for KEYINPUT, reading back the scripted session
+struct scripted_keyinput {
+    using type = keypad;
+
+    static inline uint32 frame = 0;
+
+    static keypad read() noexcept {
+        keypad keys;
+        const auto value = session_keys( frame++ );
+        static_assert( sizeof( keys ) == sizeof( value ), "keypad must be one halfword" );
+        std::memcpy( &keys, &value, sizeof( keys ) );
+        return keys;
+    }
+};
+
+void record_and_replay_sources() {
+    keypad_rle_writer writer( storage, sizeof( storage ) );
+    keypad_recorder<scripted_keyinput>::attach( &writer );
+    for ( uint32 ii = 0; ii < 500; ++ii ) {
+        GBAXX_CHECK( uint_cast( keypad_recorder<scripted_keyinput>::read() ) == session_keys( ii ) );
+    }
+    keypad_recorder<scripted_keyinput>::attach( nullptr );
+    const auto size = writer.finish();
+    GBAXX_CHECK( writer.frames() == 500 );
+
+    keypad_rle_reader reader( storage, size );
+    keypad_replayer<>::attach( &reader );
+    uint32 mismatches = 0;
+    for ( uint32 ii = 0; ii < 500; ++ii ) {
+        if ( uint_cast( keypad_replayer<>::read() ) != session_keys( ii ) ) {
+            ++mismatches;
+        }
+    }
+    GBAXX_CHECK( mismatches == 0 );
+    GBAXX_CHECK( uint_cast( keypad_replayer<>::read() ) == keypad_rle::released );
+
+    // A replayer with nothing attached reads as no keys held
+    GBAXX_CHECK( uint_cast( keypad_replayer<1>::read() ) == keypad_rle::released );
+}
+
+} // namespace
+
+int main() {
+    round_trip();
+    run_lengths();
+    overflow_stops_recording();
+    record_and_replay_sources();
+    return gba::test::result();
+}
@@ -0,0 +1,130 @@
+#include <gba/object/animation_streamer.hpp>
+
+#include "check.hpp"
+
+using gba::animation_streamer;
+using gba::cpu_copy;
+using gba::uint32;
+
+namespace {
+
+using streamer_type = animation_streamer<4, cpu_copy>;
+
+// 16x16 4bpp frames: four tiles, 32 words each
+constexpr uint32 frame_words = 32;
+
+uint32 frames[6][frame_words];
+uint32 vram[4][frame_words];
+
+bool slot_shows( const uint32 slot, const uint32 frame ) {
+    for ( uint32 ii = 0; ii < frame_words; ++ii ) {
+        if ( vram[slot][ii] != frames[frame][ii] ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void attach_all( streamer_type& streamer ) {
+    for ( uint32 ii = 0; ii < 4; ++ii ) {
+        vram[ii][0] = 0;
+        streamer.attach( vram[ii], 100 + ii * 4, frame_words * 4, 1, 0 );
+    }
+}
+
+void uploads_only_changes() {
+    streamer_type streamer;
+    attach_all( streamer );
+    streamer.set_frame( 0, frames[0] );
+    streamer.set_frame( 1, frames[1] );
+    GBAXX_CHECK( streamer.prepare() == 2 * frame_words * 4 );
+    streamer.flush();
+    GBAXX_CHECK( slot_shows( 0, 0 ) && slot_shows( 1, 1 ) );
+    GBAXX_CHECK( streamer.tile_index( 0 ) == 100 && streamer.tile_index( 1 ) == 104 );
+
+    // Unchanged frames cost nothing
+    GBAXX_CHECK( streamer.prepare() == 0 );
+    GBAXX_CHECK( streamer.transfers() == 0 );
+
+    streamer.set_frame( 1, frames[2] );
+    GBAXX_CHECK( streamer.prepare() == frame_words * 4 );
+    streamer.flush();
+    GBAXX_CHECK( slot_shows( 1, 2 ) );
+    GBAXX_CHECK( streamer.total_bytes() == 3 * frame_words * 4 );
+}
+
+void same_frame_is_shared() {
+    streamer_type streamer;
+    attach_all( streamer );
+    for ( int sprite = 0; sprite < 4; ++sprite ) {
+        streamer.set_frame( sprite, frames[3] );
+    }
+    GBAXX_CHECK( streamer.prepare() == frame_words * 4 );
+    streamer.flush();
+    for ( int sprite = 0; sprite < 4; ++sprite ) {
+        GBAXX_CHECK( streamer.tile_index( sprite ) == 100 );
+    }
+    GBAXX_CHECK( slot_shows( 0, 3 ) );
+
+    // Slot 0 is reloaded with the new frame, which sprite 2 shares; the sprites left on the old one reload it once
+    streamer.set_frame( 0, frames[4] );
+    streamer.set_frame( 2, frames[4] );
+    GBAXX_CHECK( streamer.prepare() == 2 * frame_words * 4 );
+    GBAXX_CHECK( streamer.transfers() == 2 );
+    streamer.flush();
+    GBAXX_CHECK( streamer.tile_index( 0 ) == streamer.tile_index( 2 ) );
+    GBAXX_CHECK( streamer.tile_index( 1 ) == streamer.tile_index( 3 ) );
+    GBAXX_CHECK( streamer.tile_index( 0 ) != streamer.tile_index( 1 ) );
+}
+
+void hidden_slots_are_shared() {
+    streamer_type streamer;
+    attach_all( streamer );
+    streamer.set_frame( 0, frames[5] );
+    streamer.prepare();
+    streamer.flush();
+
+    // Sprite 0 hides; its slot keeps frame 5, so sprite 3 showing it uploads nothing
+    streamer.set_frame( 0, nullptr );
+    streamer.set_frame( 3, frames[5] );
+    GBAXX_CHECK( streamer.prepare() == 0 );
+    streamer.flush();
+    GBAXX_CHECK( streamer.tile_index( 3 ) == 100 );
+    GBAXX_CHECK( slot_shows( 0, 5 ) );
+
+    // When sprite 0 reappears with another frame it reloads its slot and sprite 3 takes its own
+    streamer.set_frame( 0, frames[1] );
+    GBAXX_CHECK( streamer.prepare() == 2 * frame_words * 4 );
+    streamer.flush();
+    GBAXX_CHECK( streamer.tile_index( 0 ) == 100 && slot_shows( 0, 1 ) );
+    GBAXX_CHECK( streamer.tile_index( 3 ) == 112 && slot_shows( 3, 5 ) );
+}
+
+void rows_of_a_2d_slot() {
+    // A 16x16 sprite in 2D mapping: two rows of two tiles, 32 tiles apart
+    static uint32 vram2d[2 * 256];
+    animation_streamer<1, cpu_copy> streamer;
+    const auto sprite = streamer.attach( vram2d, 0, 2 * 32, 2, 32 * 32 );
+    streamer.set_frame( sprite, frames[2] );
+    GBAXX_CHECK( streamer.prepare() == 128 );
+    GBAXX_CHECK( streamer.transfers() == 2 );
+    streamer.flush();
+    GBAXX_CHECK( vram2d[0] == frames[2][0] && vram2d[15] == frames[2][15] );
+    GBAXX_CHECK( vram2d[256] == frames[2][16] && vram2d[256 + 15] == frames[2][31] );
+}
+
+} // namespace
+
+int main() {
+    for ( uint32 ff = 0; ff < 6; ++ff ) {
+        for ( uint32 ii = 0; ii < frame_words; ++ii ) {
+            frames[ff][ii] = ( ff + 1 ) << 16 | ii;
+        }
+    }
+
+    uploads_only_changes();
+    same_frame_is_shared();
+    hidden_slots_are_shared();
+    rows_of_a_2d_slot();
+    return gba::test::result();
+}
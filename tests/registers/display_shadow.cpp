@@ -0,0 +1,163 @@
+#include <cstring>
+
+#include <gba/display/compositor.hpp>
+#include <gba/registers/display_shadow.hpp>
+
+#include "check.hpp"
+
+using gba::compositor;
+using gba::cpu_copy;
+using gba::display_shadow;
+using gba::uint16;
+using gba::uint32;
+namespace reg = gba::reg;
+
+namespace {
+
+using shadow_type = display_shadow<8, cpu_copy>;
+
+constexpr uint32 dispstat = 2;
+constexpr uint32 vcount = 3;
+constexpr uint16 untouched = 0xa5a5;
+
+uint16 io[shadow_type::halfwords];
+
+// Hardware owned values, and a marker in every other halfword so any write shows
+void reset_io() {
+    for ( auto& halfword : io ) {
+        halfword = untouched;
+    }
+    io[dispstat] = 0x0008; // VBlank IRQ enabled
+    io[vcount] = 0x0050;
+}
+
+uint32 count_written() {
+    uint32 written = 0;
+    for ( uint32 ii = 0; ii < shadow_type::halfwords; ++ii ) {
+        written += io[ii] != untouched && ii != dispstat && ii != vcount;
+    }
+    return written;
+}
+
+void first_commit_spares_dispstat() {
+    reset_io();
+    shadow_type shadow { io };
+    GBAXX_CHECK( ( shadow.dirty() & 0x1f ) == 0x13 );
+
+    // Every managed halfword, in a burst split around DISPSTAT and VCOUNT
+    GBAXX_CHECK( shadow.commit() == shadow_type::halfwords - 2 );
+    GBAXX_CHECK( io[dispstat] == 0x0008 && io[vcount] == 0x0050 );
+    GBAXX_CHECK( io[0] == 0 && io[4] == 0 && io[shadow_type::halfwords - 1] == 0 );
+    GBAXX_CHECK( shadow.commit() == 0 );
+
+    reset_io();
+    shadow.invalidate();
+    GBAXX_CHECK( shadow.commit() == shadow_type::halfwords - 2 );
+    GBAXX_CHECK( io[dispstat] == 0x0008 && io[vcount] == 0x0050 );
+}
+
+void writes_only_what_changed() {
+    reset_io();
+    shadow_type shadow { io };
+    shadow.commit();
+    reset_io();
+
+    shadow.write<reg::bg1hofs>( 12 );
+    GBAXX_CHECK( shadow.dirty() == decltype( shadow.dirty() )( 1 ) << ( ( reg::bg1hofs::address - 0x4000000 ) / 2 ) );
+    GBAXX_CHECK( shadow.commit() == 1 );
+    GBAXX_CHECK( count_written() == 1 && io[( reg::bg1hofs::address - 0x4000000 ) / 2] == 12 );
+
+    // Unchanged values are not written again
+    reset_io();
+    shadow.write<reg::bg1hofs>( 12 );
+    GBAXX_CHECK( shadow.dirty() == 0 && shadow.commit() == 0 && count_written() == 0 );
+
+    // Only the changed half of a 32-bit register
+    shadow.write<reg::bg2x>( reg::bg2x::type::from_data( 0x00010000 ) );
+    GBAXX_CHECK( shadow.commit() == 1 );
+    GBAXX_CHECK( count_written() == 1 && io[( reg::bg2x::address - 0x4000000 ) / 2 + 1] == 1 );
+
+    // Scattered writes below the threshold go one by one, leaving the halfwords between them alone
+    reset_io();
+    shadow.write<reg::bg0vofs>( 3 );
+    shadow.transform<reg::dispcnt>( []( auto& control ) {
+        control.mode = 1;
+    } );
+    shadow.write<reg::bldalpha>( { .eva = gba::make_ufixed<4, 4>::from_data( 5 ), .evb = gba::make_ufixed<4, 4>::from_data( 11 ) } );
+    GBAXX_CHECK( shadow.commit() == 3 );
+    GBAXX_CHECK( count_written() == 3 );
+    GBAXX_CHECK( shadow.read<reg::dispcnt>().mode == 1 && io[0] == 1 );
+}
+
+void bursts_from_the_threshold() {
+    reset_io();
+    shadow_type shadow { io };
+    shadow.commit();
+    reset_io();
+
+    // Eight offsets from BG0HOFS to BG3VOFS: one span of eight
+    shadow.write<reg::bg0hofs>( 1 );
+    shadow.write<reg::bg0vofs>( 2 );
+    shadow.write<reg::bg1hofs>( 3 );
+    shadow.write<reg::bg1vofs>( 4 );
+    shadow.write<reg::bg2hofs>( 5 );
+    shadow.write<reg::bg2vofs>( 6 );
+    shadow.write<reg::bg3hofs>( 7 );
+    shadow.write<reg::bg3vofs>( 8 );
+    GBAXX_CHECK( shadow.commit() == 8 );
+    GBAXX_CHECK( count_written() == 8 );
+
+    // A span across DISPSTAT and VCOUNT copies both sides, rewriting the unchanged halfwords between
+    reset_io();
+    shadow.write<reg::bg0hofs>( 10 );
+    shadow.write<reg::bg1hofs>( 11 );
+    shadow.write<reg::bg2hofs>( 12 );
+    shadow.write<reg::bg3hofs>( 13 );
+    shadow.write<reg::bg0vofs>( 14 );
+    shadow.write<reg::bg1vofs>( 15 );
+    shadow.write<reg::bg2vofs>( 16 );
+    shadow.transform<reg::dispcnt>( []( auto& control ) {
+        control.mode = 2;
+    } );
+    const auto span = ( reg::bg3hofs::address - 0x4000000 ) / 2 + 1;
+    GBAXX_CHECK( shadow.commit() == span - 2 );
+    GBAXX_CHECK( count_written() == span - 2 );
+    GBAXX_CHECK( io[dispstat] == 0x0008 && io[vcount] == 0x0050 );
+}
+
+void compositor_commits_through_the_shadow() {
+    reset_io();
+    shadow_type shadow { io };
+    shadow.commit();
+    reset_io();
+
+    compositor effects;
+    effects.fade( 16, 4 );
+    effects.commit( shadow );
+    GBAXX_CHECK( shadow.commit() == 1 ); // BLDCNT
+    GBAXX_CHECK( std::memcmp( &io[( reg::bldcnt::address - 0x4000000 ) / 2], &effects.registers().bldcnt, 2 ) == 0 );
+
+    uint32 written = 0;
+    while ( effects.tweening() ) {
+        effects.update();
+        effects.commit( shadow );
+        written += shadow.commit();
+    }
+    GBAXX_CHECK( written == 4 );
+    GBAXX_CHECK( io[( reg::bldy::address - 0x4000000 ) / 2] == 16 );
+
+    // Idle frames write nothing
+    effects.update();
+    effects.commit( shadow );
+    GBAXX_CHECK( shadow.commit() == 0 );
+}
+
+} // namespace
+
+int main() {
+    first_commit_spares_dispstat();
+    writes_only_what_changed();
+    bursts_from_the_threshold();
+    compositor_commits_through_the_shadow();
+    return gba::test::result();
+}
@@ -0,0 +1,141 @@
+#include <gba/sio/bulk_transfer.hpp>
+
+#include "check.hpp"
+
+using namespace gba;
+using namespace gba::sio;
+
+namespace {
+
+constexpr uint32 words = 300;
+constexpr uint32 block = 32;
+
+uint32 source[words];
+
+constexpr auto clean = []( uint32, uint32&, uint32& ) noexcept {};
+
+bool matches( const uint32 * buffer, const uint32 count ) noexcept {
+    for ( uint32 ii = 0; ii < count; ++ii ) {
+        if ( buffer[ii] != source[ii] ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void clean_transfer() {
+    uint32 buffer[words] {};
+    bulk_sender sender( source, words, block );
+    bulk_receiver receiver( buffer, words, block );
+
+    const auto transfers = bulk_loopback( sender, receiver, 2000, clean );
+    GBAXX_CHECK( transfers < 2000 );
+    GBAXX_CHECK( sender.done() && receiver.complete() );
+    GBAXX_CHECK( matches( buffer, words ) );
+    GBAXX_CHECK( sender.errors() == 0 && receiver.errors() == 0 );
+    GBAXX_CHECK( sender.delivered() == words && receiver.delivered() == words );
+
+    // Blocks add a checksum and a turnaround each, on top of the offer
+    GBAXX_CHECK( transfers > words && transfers < words + 4 * ( words / block + 1 ) + 8 );
+}
+
+void corrupted_block_is_resent() {
+    uint32 buffer[words] {};
+    bulk_sender sender( source, words, block );
+    bulk_receiver receiver( buffer, words, block );
+
+    // Flip a data word in the third block once
+    bool flipped = false;
+    const auto transfers = bulk_loopback( sender, receiver, 2000, [&]( uint32, uint32& toReceiver, uint32& ) noexcept {
+        if ( !flipped && toReceiver == source[2 * block + 5] ) {
+            toReceiver ^= 0x100;
+            flipped = true;
+        }
+    } );
+
+    GBAXX_CHECK( flipped );
+    GBAXX_CHECK( transfers < 2000 );
+    GBAXX_CHECK( matches( buffer, words ) );
+    GBAXX_CHECK( receiver.errors() == 1 );
+    GBAXX_CHECK( sender.errors() == 1 );
+    GBAXX_CHECK( receiver.delivered() == words );
+}
+
+void interrupted_transfer_resumes() {
+    uint32 buffer[words] {};
+    bulk_receiver receiver( buffer, words, block );
+
+    uint32 fresh = 0;
+    {
+        uint32 other[words] {};
+        bulk_sender sender( source, words, block );
+        bulk_receiver full( other, words, block );
+        fresh = bulk_loopback( sender, full, 2000, clean );
+    }
+
+    // The cable is pulled part way through
+    {
+        bulk_sender sender( source, words, block );
+        GBAXX_CHECK( bulk_loopback( sender, receiver, 150, clean ) == 150 );
+    }
+    const auto committed = receiver.committed();
+    GBAXX_CHECK( committed > 0 && committed < words && committed % block == 0 );
+    GBAXX_CHECK( matches( buffer, committed ) );
+
+    // A new sender offering the same length picks up from the committed offset
+    receiver.begin_session();
+    bulk_sender sender( source, words, block );
+    const auto transfers = bulk_loopback( sender, receiver, 2000, clean );
+    GBAXX_CHECK( receiver.complete() );
+    GBAXX_CHECK( matches( buffer, words ) );
+    // Starting over would take as long as a fresh transfer; the committed blocks are not sent again
+    GBAXX_CHECK( transfers < fresh - committed / 2 );
+
+    // Only this session's words count towards its throughput
+    GBAXX_CHECK( sender.delivered() == words - committed && receiver.delivered() == words - committed );
+    const normal32_port<bulk_sender> senderPort( sender );
+    const normal32_port<bulk_receiver> receiverPort( receiver );
+    GBAXX_CHECK( senderPort.bytes_per_second( cycles_per_second ) == ( words - committed ) * 4 );
+    GBAXX_CHECK( receiverPort.bytes_per_second( cycles_per_second ) == ( words - committed ) * 4 );
+}
+
+void different_length_restarts() {
+    uint32 buffer[words] {};
+    bulk_receiver receiver( buffer, words, block );
+    {
+        bulk_sender sender( source, words, block );
+        bulk_loopback( sender, receiver, 150, clean );
+    }
+    GBAXX_CHECK( receiver.committed() > 0 );
+
+    bulk_sender shorter( source, 100, block );
+    bulk_loopback( shorter, receiver, 2000, clean );
+    GBAXX_CHECK( receiver.complete() );
+    GBAXX_CHECK( receiver.size() == 100 && receiver.committed() == 100 );
+}
+
+void throughput_counts_payload_only() {
+    uint32 buffer[words] {};
+    bulk_sender sender( source, words, block );
+    bulk_receiver receiver( buffer, words, block );
+    bulk_loopback( sender, receiver, 2000, clean );
+
+    const normal32_port<bulk_sender> port( sender );
+    GBAXX_CHECK( port.bytes_per_second( cycles_per_second ) == words * 4 );
+    GBAXX_CHECK( port.bytes_per_second( cycles_type( 0 ) ) == 0 );
+}
+
+} // namespace
+
+int main() {
+    for ( uint32 ii = 0; ii < words; ++ii ) {
+        source[ii] = ii * 0x9e3779b9u;
+    }
+
+    clean_transfer();
+    corrupted_block_is_resent();
+    interrupted_transfer_resumes();
+    different_length_restarts();
+    throughput_counts_payload_only();
+    return gba::test::result();
+}
@@ -0,0 +1,134 @@
+#include <gba/sio/joy_bus_responder.hpp>
+
+#include "check.hpp"
+
+using gba::uint32;
+using gba::sio::host_joy_bus_port;
+using gba::sio::joy_bus_responder;
+
+namespace {
+
+using responder_type = joy_bus_responder<host_joy_bus_port>;
+
+// General purpose bits sit at bits 4 and 5 of the JOYSTAT byte the status command returns
+uint32 status_bits( responder_type& device ) {
+    return ( device.port().status() >> 4 ) & 0x3;
+}
+
+void service( responder_type& device ) {
+    if ( device.port().pending() ) {
+        device.on_joy_bus();
+    }
+}
+
+void controller_reads_a_buffer() {
+    responder_type device;
+    device.start();
+    GBAXX_CHECK( status_bits( device ) == 0 );
+
+    const uint32 data[] = { 0x11111111, 0x22222222, 0x33333333 };
+    GBAXX_CHECK( device.send( data, 3 ) );
+    GBAXX_CHECK( !device.send( data, 3 ) );
+    GBAXX_CHECK( status_bits( device ) == responder_type::status_sending );
+
+    uint32 words[3] = {};
+    for ( auto& word : words ) {
+        GBAXX_CHECK( device.port().read( word ) );
+        service( device );
+    }
+    GBAXX_CHECK( words[0] == data[0] && words[1] == data[1] && words[2] == data[2] );
+    GBAXX_CHECK( !device.sending() && device.sent() == 3 );
+    GBAXX_CHECK( device.stats().words_sent == 3 );
+    GBAXX_CHECK( status_bits( device ) == 0 );
+
+    // Nothing loaded: a further read gets a stale word and does not count
+    uint32 stale;
+    GBAXX_CHECK( !device.port().read( stale ) );
+    service( device );
+    GBAXX_CHECK( device.stats().words_sent == 3 );
+}
+
+void controller_writes_into_a_buffer() {
+    responder_type device;
+    device.start();
+
+    uint32 buffer[2] = {};
+    GBAXX_CHECK( device.receive( buffer, 2 ) );
+    GBAXX_CHECK( status_bits( device ) == responder_type::status_receiving );
+
+    GBAXX_CHECK( device.port().write( 0xcafe ) );
+    service( device );
+    GBAXX_CHECK( device.port().write( 0xf00d ) );
+    service( device );
+    GBAXX_CHECK( !device.receiving() && device.received() == 2 );
+    GBAXX_CHECK( buffer[0] == 0xcafe && buffer[1] == 0xf00d );
+    GBAXX_CHECK( status_bits( device ) == 0 );
+
+    // With no buffer offered the word is taken and dropped, and the bus is free again
+    GBAXX_CHECK( device.port().write( 0xdead ) );
+    service( device );
+    GBAXX_CHECK( device.stats().dropped == 1 );
+    GBAXX_CHECK( device.port().write( 0xbeef ) );
+    service( device );
+    GBAXX_CHECK( buffer[1] == 0xf00d );
+}
+
+void both_directions_at_once() {
+    responder_type device;
+    device.start();
+
+    const uint32 out[] = { 1, 2 };
+    uint32 in[2] = {};
+    device.send( out, 2 );
+    device.receive( in, 2 );
+    GBAXX_CHECK( status_bits( device ) == ( responder_type::status_sending | responder_type::status_receiving ) );
+
+    // One interrupt covering a read and a write
+    uint32 word;
+    device.port().read( word );
+    device.port().write( 10 );
+    service( device );
+    GBAXX_CHECK( word == 1 && in[0] == 10 );
+    GBAXX_CHECK( device.sent() == 1 && device.received() == 1 );
+
+    device.port().read( word );
+    device.port().write( 20 );
+    service( device );
+    GBAXX_CHECK( word == 2 && in[1] == 20 );
+    GBAXX_CHECK( status_bits( device ) == 0 );
+}
+
+void reset_aborts_transfers() {
+    responder_type device;
+    device.start();
+
+    const uint32 out[] = { 1, 2, 3 };
+    uint32 in[4] = {};
+    device.send( out, 3 );
+    device.receive( in, 4 );
+
+    uint32 word;
+    device.port().read( word );
+    service( device );
+    GBAXX_CHECK( device.sending() );
+
+    device.port().reset();
+    service( device );
+    GBAXX_CHECK( device.stats().resets == 1 );
+    GBAXX_CHECK( !device.sending() && !device.receiving() );
+    GBAXX_CHECK( status_bits( device ) == 0 );
+
+    // Free for a new transfer straight away
+    GBAXX_CHECK( device.send( out + 1, 2 ) );
+    GBAXX_CHECK( device.port().read( word ) && word == 2 );
+}
+
+} // namespace
+
+int main() {
+    controller_reads_a_buffer();
+    controller_writes_into_a_buffer();
+    both_directions_at_once();
+    reset_aborts_transfers();
+    return gba::test::result();
+}
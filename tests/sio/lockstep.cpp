@@ -0,0 +1,160 @@
+#include <gba/sio/lockstep.hpp>
+
+#include "check.hpp"
+
+using gba::uint16;
+using gba::uint32;
+using gba::sio::lockstep;
+
+namespace {
+
+constexpr uint16 idle = 0xffff;
+
+/**
+ * Consoles wired together, each running its own main loop; transfers lose words at a configurable rate
+ */
+template <unsigned Players>
+struct session {
+    using lockstep_type = lockstep<Players, 3>;
+
+    lockstep_type nodes[Players] {};
+    uint16 latched[Players] {};
+    uint32 state[Players] {};
+    uint32 mismatches = 0;
+    uint32 lossPerMille;
+    uint32 seed = 0x1234567;
+    uint32 lost = 0;
+
+    explicit session( const uint32 loss ) noexcept : lossPerMille { loss } {
+        for ( auto& word : latched ) {
+            word = idle;
+        }
+    }
+
+    static uint16 keys( const unsigned player, const uint32 frame ) noexcept {
+        return frame < lockstep_type::delay ? 0 : uint16( ( frame * 7 + player * 131 ) & lockstep_type::key_bits );
+    }
+
+    bool drop() noexcept {
+        seed = seed * 1664525 + 1013904223;
+        return ( seed >> 16 ) % 1000 < lossPerMille;
+    }
+
+    // Each receiver may miss any word independently; a missed word reads as an idle transfer
+    void transfer() noexcept {
+        uint16 outgoing[Players];
+        for ( unsigned node = 0; node < Players; ++node ) {
+            uint16 words[4] = { idle, idle, idle, idle };
+            for ( unsigned sender = 0; sender < Players; ++sender ) {
+                if ( sender != node && drop() ) {
+                    ++lost;
+                    continue;
+                }
+                words[sender] = latched[sender];
+            }
+            outgoing[node] = nodes[node].transfer( words, node );
+        }
+        for ( unsigned node = 0; node < Players; ++node ) {
+            latched[node] = outgoing[node];
+        }
+    }
+
+    void frame( const unsigned transfers, const unsigned desyncPlayer = Players ) noexcept {
+        for ( unsigned node = 0; node < Players; ++node ) {
+            nodes[node].submit( keys( node, nodes[node].frame() + lockstep_type::delay ) );
+        }
+        for ( unsigned ii = 0; ii < transfers; ++ii ) {
+            transfer();
+        }
+        for ( unsigned node = 0; node < Players; ++node ) {
+            auto& n = nodes[node];
+            if ( !n.ready() ) {
+                continue;
+            }
+
+            for ( unsigned player = 0; player < Players; ++player ) {
+                const auto input = uint32( n.input( player ) );
+                if ( input != keys( player, n.frame() ) ) {
+                    ++mismatches;
+                }
+                state[node] = state[node] * 31 + input;
+            }
+            n.advance( node == desyncPlayer ? ~state[node] : state[node] );
+        }
+    }
+};
+
+template <unsigned Players>
+void run_without_loss() {
+    session<Players> s { 0 };
+    for ( int frame = 0; frame < 120; ++frame ) {
+        s.frame( 4 );
+    }
+
+    GBAXX_CHECK( s.mismatches == 0 );
+    for ( const auto& n : s.nodes ) {
+        GBAXX_CHECK( n.frame() == 120 );
+        GBAXX_CHECK( n.stats().stalls == 0 );
+        GBAXX_CHECK( !n.desynced() );
+    }
+    for ( unsigned node = 1; node < Players; ++node ) {
+        GBAXX_CHECK( s.state[node] == s.state[0] );
+    }
+}
+
+template <unsigned Players>
+void run_with_loss( const uint32 perMille, uint32& stalls ) {
+    session<Players> s { perMille };
+    for ( int frame = 0; frame < 240; ++frame ) {
+        s.frame( 4 );
+    }
+
+    GBAXX_CHECK( s.lost > 0 );
+    GBAXX_CHECK( s.mismatches == 0 );
+    stalls = 0;
+    for ( const auto& n : s.nodes ) {
+        // Lost words only cost time: nobody diverges and everyone keeps advancing
+        GBAXX_CHECK( !n.desynced() );
+        GBAXX_CHECK( n.frame() > 60 );
+        stalls += n.stats().stalls;
+    }
+}
+
+void loss_costs_time_not_correctness() {
+    uint32 light = 0;
+    uint32 heavy = 0;
+    run_with_loss<2>( 100, light );
+    run_with_loss<2>( 400, heavy );
+    GBAXX_CHECK( heavy > light );
+
+    run_with_loss<4>( 100, light );
+    run_with_loss<4>( 300, heavy );
+    GBAXX_CHECK( heavy > light );
+}
+
+void desync_is_reported() {
+    session<2> s { 50 };
+    for ( int frame = 0; frame < 40; ++frame ) {
+        s.frame( 4 );
+    }
+    GBAXX_CHECK( !s.nodes[0].desynced() && !s.nodes[1].desynced() );
+
+    // Player 1 hashes its state differently from here on
+    for ( int frame = 0; frame < 40; ++frame ) {
+        s.frame( 4, 1 );
+    }
+    for ( const auto& n : s.nodes ) {
+        GBAXX_CHECK( n.desynced() );
+        GBAXX_CHECK( n.stats().first_desync >= 38 );
+    }
+}
+
+} // namespace
+
+int main() {
+    run_without_loss<2>();
+    run_without_loss<4>();
+    loss_costs_time_not_correctness();
+    desync_is_reported();
+    return gba::test::result();
+}
@@ -0,0 +1,185 @@
+#include <gba/sio/multiplayer_link.hpp>
+
+#include "check.hpp"
+
+using namespace gba;
+using namespace gba::sio;
+
+namespace {
+
+using link_type = multiplayer_link<32, 64, 64>;
+
+/**
+ * Four links wired together: every transfer, each console's latched send word reaches all four SIOMULTI slots
+ */
+struct bus {
+    link_type links[4] {};
+    uint16 latched[4] { packet::idle, packet::idle, packet::idle, packet::idle };
+    bool connected[4] { true, true, true, true };
+
+    template <class Wire>
+    void transfer( Wire&& wire ) noexcept {
+        uint16 words[4];
+        for ( unsigned ii = 0; ii < 4; ++ii ) {
+            words[ii] = connected[ii] ? wire( ii, latched[ii] ) : packet::idle;
+        }
+        for ( unsigned ii = 0; ii < 4; ++ii ) {
+            if ( connected[ii] ) {
+                latched[ii] = links[ii].transfer( words, ii );
+            }
+        }
+    }
+
+    void run( const unsigned count ) noexcept {
+        for ( unsigned ii = 0; ii < count; ++ii ) {
+            transfer( []( unsigned, const uint16 word ) noexcept {
+                return word;
+            } );
+        }
+    }
+};
+
+struct inbox {
+    uint8 data[4][64];
+    uint32 size[4];
+    uint32 packets[4];
+
+    void operator ()( const unsigned player, const uint8 * bytes, const uint32 length ) noexcept {
+        for ( uint32 ii = 0; ii < length; ++ii ) {
+            data[player][size[player] + ii] = bytes[ii];
+        }
+        size[player] += length;
+        ++packets[player];
+    }
+};
+
+void fill( uint8 * bytes, const uint32 length, const unsigned sender, const unsigned index ) noexcept {
+    for ( uint32 ii = 0; ii < length; ++ii ) {
+        bytes[ii] = uint8( sender * 64 + index * 16 + ii );
+    }
+}
+
+void everyone_hears_everyone() {
+    bus b;
+    uint8 bytes[32];
+    for ( unsigned node = 0; node < 4; ++node ) {
+        fill( bytes, 5 + node, node, 0 );
+        GBAXX_CHECK( b.links[node].send( bytes, 5 + node ) );
+        fill( bytes, 12, node, 1 );
+        GBAXX_CHECK( b.links[node].send( bytes, 12 ) );
+    }
+    b.run( 32 );
+
+    for ( unsigned node = 0; node < 4; ++node ) {
+        inbox in {};
+        b.links[node].poll( in );
+        for ( unsigned sender = 0; sender < 4; ++sender ) {
+            if ( sender == node ) {
+                GBAXX_CHECK( in.packets[sender] == 0 );
+                continue;
+            }
+
+            GBAXX_CHECK( in.packets[sender] == 2 );
+            GBAXX_CHECK( in.size[sender] == 5 + sender + 12 );
+            fill( bytes, 5 + sender, sender, 0 );
+            fill( bytes + 5 + sender, 12, sender, 1 );
+            bool same = true;
+            for ( uint32 ii = 0; ii < in.size[sender]; ++ii ) {
+                same &= in.data[sender][ii] == bytes[ii];
+            }
+            GBAXX_CHECK( same );
+
+            const auto& count = b.links[node].received( sender );
+            GBAXX_CHECK( count.packets == 2 && count.bytes == 17 + sender );
+            GBAXX_CHECK( count.checksum_errors == 0 && count.sequence_errors == 0 && count.overruns == 0 );
+        }
+        GBAXX_CHECK( b.links[node].sent().packets == 2 );
+    }
+}
+
+void corrupted_word_fails_checksum() {
+    bus b;
+    uint8 bytes[8];
+    fill( bytes, 8, 0, 0 );
+    b.links[0].send( bytes, 8 );
+    b.links[0].send( bytes, 8 );
+
+    // Flip a bit in the first frame's second payload word, as every receiver sees it
+    unsigned sent = 0;
+    for ( unsigned ii = 0; ii < 16; ++ii ) {
+        b.transfer( [&sent]( const unsigned player, const uint16 word ) noexcept {
+            if ( player == 0 && word != packet::idle && sent++ == 3 ) {
+                return uint16( word ^ 0x10 );
+            }
+            return word;
+        } );
+    }
+
+    for ( unsigned node = 1; node < 4; ++node ) {
+        inbox in {};
+        b.links[node].poll( in );
+        GBAXX_CHECK( in.packets[0] == 1 );
+        GBAXX_CHECK( b.links[node].received( 0 ).checksum_errors == 1 );
+    }
+}
+
+void lost_frame_counts_sequence_error() {
+    bus b;
+    uint8 bytes[4] = { 1, 2, 3, 4 };
+    for ( int ii = 0; ii < 3; ++ii ) {
+        b.links[2].send( bytes, 4 );
+    }
+
+    // Each frame is 5 words; the second never reaches the wire
+    unsigned sent = 0;
+    for ( unsigned ii = 0; ii < 20; ++ii ) {
+        b.transfer( [&sent]( const unsigned player, const uint16 word ) noexcept {
+            if ( player == 2 && word != packet::idle && sent++ / 5 == 1 ) {
+                return packet::idle;
+            }
+            return word;
+        } );
+    }
+
+    inbox in {};
+    b.links[0].poll( in );
+    GBAXX_CHECK( in.packets[2] == 2 );
+    GBAXX_CHECK( b.links[0].received( 2 ).sequence_errors == 1 );
+    GBAXX_CHECK( b.links[0].received( 2 ).checksum_errors == 0 );
+}
+
+void disconnected_player_is_silent() {
+    bus b;
+    b.connected[3] = false;
+    uint8 bytes[2] = { 7, 8 };
+    b.links[1].send( bytes, 2 );
+    b.run( 16 );
+
+    inbox in {};
+    b.links[0].poll( in );
+    GBAXX_CHECK( in.packets[1] == 1 );
+    GBAXX_CHECK( b.links[0].received( 3 ).words == 0 );
+    GBAXX_CHECK( b.links[0].received( 1 ).words == packet::frame_words( 2 ) );
+}
+
+void full_send_buffer_refuses() {
+    link_type link;
+    uint8 bytes[32] {};
+    unsigned queued = 0;
+    while ( link.send( bytes, 32 ) ) {
+        ++queued;
+    }
+    GBAXX_CHECK( queued == 64 / packet::frame_words( 32 ) );
+    GBAXX_CHECK( !link.send( bytes, 33 ) );
+}
+
+} // namespace
+
+int main() {
+    everyone_hears_everyone();
+    corrupted_word_fails_checksum();
+    lost_frame_counts_sequence_error();
+    disconnected_player_is_silent();
+    full_send_buffer_refuses();
+    return gba::test::result();
+}
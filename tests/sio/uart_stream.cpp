@@ -0,0 +1,168 @@
+#include <gba/sio/uart_stream.hpp>
+
+#include "check.hpp"
+
+using gba::uint8;
+using gba::uint32;
+using gba::sio::host_uart_port;
+using gba::sio::uart;
+using gba::sio::uart_stream;
+
+namespace {
+
+using stream_type = uart_stream<16, 16, host_uart_port>;
+
+// Remote side of the cable: take what the stream sent, one FIFO's worth per interrupt
+uint32 take( stream_type& stream, uint8 * out, const uint32 capacity ) {
+    uint32 n = 0;
+    uint8 value;
+    while ( n < capacity && stream.port().transmit( value ) ) {
+        out[n++] = value;
+    }
+    stream.on_serial();
+    return n;
+}
+
+void write_batches_through_the_fifo() {
+    stream_type stream;
+    stream.start( uart::baud_rate::bps_115200 );
+
+    const uint8 message[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    GBAXX_CHECK( stream.write( message, sizeof( message ) ) == sizeof( message ) );
+
+    // The first write fills the idle FIFO; the rest waits for interrupts
+    GBAXX_CHECK( stream.pending() == sizeof( message ) - host_uart_port::fifo_size );
+
+    uint8 wire[16] = {};
+    uint32 received = 0;
+    int interrupts = 0;
+    while ( received < sizeof( message ) && interrupts < 8 ) {
+        received += take( stream, wire + received, sizeof( wire ) - received );
+        ++interrupts;
+    }
+    GBAXX_CHECK( received == sizeof( message ) );
+    GBAXX_CHECK( interrupts == 3 );
+    for ( uint32 ii = 0; ii < sizeof( message ); ++ii ) {
+        GBAXX_CHECK( wire[ii] == message[ii] );
+    }
+    GBAXX_CHECK( stream.stats().sent == sizeof( message ) );
+    GBAXX_CHECK( stream.pending() == 0 );
+}
+
+void write_stops_when_the_buffer_fills() {
+    stream_type stream;
+    stream.start( uart::baud_rate::bps_115200 );
+    stream.port().set_clear_to_send( false );
+
+    uint8 data[32] = {};
+    GBAXX_CHECK( stream.write( data, sizeof( data ) ) == 16 );
+
+    // Held off by CTS: nothing leaves the FIFO
+    uint8 value;
+    GBAXX_CHECK( !stream.port().transmit( value ) );
+}
+
+void read_returns_delivered_bytes() {
+    stream_type stream;
+    stream.start( uart::baud_rate::bps_9600 );
+
+    uint8 out[8] = {};
+    GBAXX_CHECK( stream.read( out, sizeof( out ) ) == 0 );
+
+    for ( uint8 ii = 0; ii < 3; ++ii ) {
+        stream.port().deliver( uint8( 0x40 + ii ) );
+    }
+    stream.on_serial();
+    GBAXX_CHECK( stream.available() == 3 );
+    GBAXX_CHECK( stream.read( out, sizeof( out ) ) == 3 );
+    GBAXX_CHECK( out[0] == 0x40 && out[1] == 0x41 && out[2] == 0x42 );
+    GBAXX_CHECK( stream.stats().received == 3 );
+}
+
+void receiver_throttles_until_read() {
+    stream_type stream;
+    stream.start( uart::baud_rate::bps_115200 );
+    auto& port = stream.port();
+
+    // A CTS-honouring remote sends only while RTS is asserted
+    uint8 next = 0;
+    for ( int interrupts = 0; interrupts < 16; ++interrupts ) {
+        while ( port.ready_to_receive() ) {
+            port.deliver( next++ );
+        }
+        stream.on_serial();
+    }
+    GBAXX_CHECK( stream.throttled() );
+    GBAXX_CHECK( stream.stats().throttles == 1 );
+    GBAXX_CHECK( !port.ready_to_receive() );
+    GBAXX_CHECK( stream.stats().errors == 0 );
+
+    // Nothing is lost: the stream holds every byte sent, in order
+    uint8 out[16] = {};
+    const auto n = stream.read( out, sizeof( out ) );
+    GBAXX_CHECK( n > 12 );
+    for ( uint32 ii = 0; ii < n; ++ii ) {
+        GBAXX_CHECK( out[ii] == ii );
+    }
+
+    // Reading made room, so RTS is raised again and the FIFO's backlog was drained in order
+    GBAXX_CHECK( !stream.throttled() );
+    GBAXX_CHECK( port.ready_to_receive() );
+    const auto rest = stream.read( out, sizeof( out ) );
+    for ( uint32 ii = 0; ii < rest; ++ii ) {
+        GBAXX_CHECK( out[ii] == n + ii );
+    }
+    GBAXX_CHECK( n + rest == next );
+}
+
+void overrun_is_counted() {
+    stream_type stream;
+    stream.start( uart::baud_rate::bps_115200 );
+    auto& port = stream.port();
+
+    // A remote ignoring RTS overruns the FIFO
+    for ( uint32 ii = 0; ii < host_uart_port::fifo_size; ++ii ) {
+        port.deliver( uint8( ii ) );
+    }
+    GBAXX_CHECK( !port.deliver( 0xff ) );
+    stream.on_serial();
+    GBAXX_CHECK( stream.stats().errors == 1 );
+    GBAXX_CHECK( stream.available() == host_uart_port::fifo_size );
+
+    stream.on_serial();
+    GBAXX_CHECK( stream.stats().errors == 1 );
+}
+
+#if __cpp_lib_span
+void span_overloads() {
+    stream_type stream;
+    stream.start( uart::baud_rate::bps_115200 );
+
+    const uint8 message[] = { 9, 8, 7 };
+    GBAXX_CHECK( stream.write( std::span<const uint8>( message ) ) == 3 );
+    uint8 value;
+    for ( const auto expected : message ) {
+        GBAXX_CHECK( stream.port().transmit( value ) && value == expected );
+        stream.port().deliver( value );
+    }
+    stream.on_serial();
+
+    uint8 out[3] = {};
+    GBAXX_CHECK( stream.read( std::span<uint8>( out ) ) == 3 );
+    GBAXX_CHECK( out[0] == 9 && out[2] == 7 );
+}
+#endif
+
+} // namespace
+
+int main() {
+    write_batches_through_the_fifo();
+    write_stops_when_the_buffer_fills();
+    read_returns_delivered_bytes();
+    receiver_throttles_until_read();
+    overrun_is_counted();
+#if __cpp_lib_span
+    span_overloads();
+#endif
+    return gba::test::result();
+}
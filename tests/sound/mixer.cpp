@@ -0,0 +1,155 @@
+#include <gba/sound/mixer.hpp>
+
+#include "check.hpp"
+
+using namespace gba;
+
+namespace {
+
+constexpr auto unit_step = sound::mixer_step::from_data( 1 << 12 );
+
+void one_shot_stops_at_end() {
+    static const int8 data[] = { 10, 20, 30, 40 };
+    sound::mixer<1, 304> mix;
+    GBAXX_CHECK( mix.play( data, 4, unit_step ) == 0 );
+    mix.mix();
+
+    const auto * left = mix.mixed_left();
+    GBAXX_CHECK( left[0] == 10 && left[3] == 40 );
+    GBAXX_CHECK( left[4] == 0 && left[303] == 0 );
+    GBAXX_CHECK( !mix.playing( 0 ) );
+}
+
+void loop_longer_than_sample_is_clamped() {
+    static const int8 data[] = { 1, 2, 3, 4 };
+    sound::mixer<1, 304> mix;
+    mix.play( data, 4, unit_step, 7 );
+    mix.mix();
+
+    // The whole sample repeats rather than stepping back past its start
+    const auto * left = mix.mixed_left();
+    bool periodic = true;
+    for ( uint32 ii = 0; ii < 304; ++ii ) {
+        periodic &= left[ii] == data[ii % 4];
+    }
+    GBAXX_CHECK( periodic );
+    GBAXX_CHECK( mix.playing( 0 ) );
+}
+
+void partial_loop_and_pan() {
+    static const int8 data[] = { 8, 16, 24, 32 };
+    sound::mixer<1, 304> mix;
+    mix.play( data, 4, unit_step, 2 );
+    mix.set_volume( 0, 64, 32 );
+    mix.mix();
+
+    // After the first pass the last two samples repeat; panned right halves the left side
+    const auto * left = mix.mixed_left();
+    const auto * right = mix.mixed_right();
+    GBAXX_CHECK( left[0] == 4 && right[0] == 8 );
+    GBAXX_CHECK( right[4] == 24 && right[5] == 32 && right[6] == 24 );
+}
+
+void mixing_saturates() {
+    static const int8 data[] = { 127, -128 };
+    sound::mixer<4, 304> mix;
+    for ( int ii = 0; ii < 4; ++ii ) {
+        mix.play( data, 2, unit_step, 2 );
+    }
+    mix.mix();
+
+    const auto * left = mix.mixed_left();
+    GBAXX_CHECK( left[0] == 127 && left[1] == -128 );
+}
+
+/**
+ * One voice of the reference mixer: the position of output sample n is found directly as n * step, folded into the
+ * loop, rather than stepped
+ */
+struct reference_voice {
+    const int8 * data;
+    uint32 length;
+    uint32 step;
+    uint32 loop;
+    uint32 volume;
+    int32 pan;
+
+    [[nodiscard]]
+    int32 sample( const uint32 n ) const noexcept {
+        const auto end = uint_type<64>::type( length ) << 12;
+        auto position = uint_type<64>::type( n ) * step;
+        if ( position >= end ) {
+            if ( !loop ) {
+                return 0;
+            }
+            const auto start = end - ( uint_type<64>::type( loop ) << 12 );
+            position = start + ( position - start ) % ( uint_type<64>::type( loop ) << 12 );
+        }
+        return data[position >> 12];
+    }
+};
+
+int8 reference_resolve( const int32 sum ) noexcept {
+    const auto value = sum / 64 - ( sum % 64 < 0 ? 1 : 0 ); // floor
+    return int8( value > 127 ? 127 : value < -128 ? -128 : value );
+}
+
+void matches_reference_mixer() {
+    constexpr uint32 samples = 304;
+    static int8 noise[3][64];
+    uint32 seed = 99;
+    for ( auto& voice : noise ) {
+        for ( auto& value : voice ) {
+            seed = seed * 1664525 + 1013904223;
+            value = int8( seed >> 24 );
+        }
+    }
+
+    // Non-unit steps, each with its own volume and pan: a partial loop, a one-shot ending in the first page and a
+    // whole-sample loop stepping more than one sample at a time
+    const reference_voice voices[] = {
+        { noise[0], 37, 0x1800, 10, 48, -20 },
+        { noise[1], 50, 0x0a3d, 0, 64, 40 },
+        { noise[2], 23, 0x34cd, 23, 30, 0 }
+    };
+
+    static sound::mixer<3, samples> mix;
+    for ( unsigned vv = 0; vv < 3; ++vv ) {
+        const auto& voice = voices[vv];
+        mix.play( vv, voice.data, voice.length, sound::mixer_step::from_data( voice.step ), voice.loop );
+        mix.set_volume( vv, voice.volume, voice.pan );
+    }
+
+    // Two pages: the one mixed while page 0 plays, then page 0 again after vblank() flips
+    uint32 wrong = 0;
+    for ( uint32 page = 0; page < 2; ++page ) {
+        mix.mix();
+        for ( uint32 ii = 0; ii < samples; ++ii ) {
+            int32 left = 0;
+            int32 right = 0;
+            for ( const auto& voice : voices ) {
+                const auto sample = voice.sample( page * samples + ii );
+                left += sample * int32( voice.volume * uint32( voice.pan > 0 ? 64 - voice.pan : 64 ) / 64 );
+                right += sample * int32( voice.volume * uint32( voice.pan < 0 ? 64 + voice.pan : 64 ) / 64 );
+            }
+            wrong += mix.mixed_left()[ii] != reference_resolve( left );
+            wrong += mix.mixed_right()[ii] != reference_resolve( right );
+        }
+        if ( page == 0 ) {
+            mix.vblank(); // page 0 was playing, so no DMA restart
+        }
+    }
+    GBAXX_CHECK( wrong == 0 );
+    GBAXX_CHECK( mix.playing( 0 ) && !mix.playing( 1 ) && mix.playing( 2 ) );
+}
+
+} // namespace
+
+int main() {
+    one_shot_stops_at_end();
+    loop_longer_than_sample_is_clamped();
+    partial_loop_and_pan();
+    mixing_saturates();
+    matches_reference_mixer();
+    return gba::test::result();
+}
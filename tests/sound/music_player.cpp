@@ -0,0 +1,177 @@
+#include <gba/sound/music_player.hpp>
+
+#include "check.hpp"
+
+using namespace gba;
+using namespace gba::sound;
+
+namespace {
+
+constexpr wave_ram triangle = { 0x01234567, 0x89abcdef, 0xfedcba98, 0x76543210 };
+
+constexpr music_instrument instruments[] = {
+    { .volume = 12, .duty = duty::half },
+    { .volume = 15, .wave = &triangle }
+};
+
+// Square 1 with a volume past the 4-bit envelope, and the wave channel uploading its wave RAM
+constexpr music_cell cells[] = {
+    { 25, 1, music_effect::set_volume, 0x40 }, {}, { 37, 2, music_effect::none, 0 }, {},
+    { 0, 0, music_effect::volume_slide, 0xf0 }, {}, {}, {}
+};
+
+constexpr music_pattern patterns[] = { { cells, 2 } };
+constexpr uint8 order[] = { 0 };
+constexpr music_song song = { order, 1, 0, patterns, instruments, 4, 2 };
+
+using log_type = register_log<64>;
+
+uint32 square1_volume( const log_type& log ) noexcept {
+    for ( uint32 ii = log.size(); ii > 0; --ii ) {
+        if ( log[ii - 1].address == reg::snd1cnt::address ) {
+            return ( log[ii - 1].value >> 12 ) & 0xf;
+        }
+    }
+    return 0xffffffff;
+}
+
+void writes_agree_with_log() {
+    music_player<log_type> player;
+    player.play( song );
+    player.output().clear();
+
+    player.tick();
+    GBAXX_CHECK( player.output().size() == player.last_tick_writes() );
+
+    uint32 waveWords = 0;
+    for ( uint32 ii = 0; ii < player.output().size(); ++ii ) {
+        const auto address = player.output()[ii].address;
+        waveWords += address >= reg::wave_ram::address && address < reg::wave_ram::address + 16;
+    }
+    GBAXX_CHECK( waveWords == 4 );
+    GBAXX_CHECK( player.peak_tick_writes() == player.last_tick_writes() );
+}
+
+void dmg_volume_clamps_to_15() {
+    music_player<log_type> player;
+    player.play( song );
+    player.tick();
+    GBAXX_CHECK( square1_volume( player.output() ) == 15 );
+
+    // Sliding up from the clamped volume changes nothing, so square 1 is not retriggered
+    for ( int ii = 0; ii < 3; ++ii ) {
+        player.output().clear();
+        player.tick();
+        GBAXX_CHECK( player.output().size() == player.last_tick_writes() );
+        GBAXX_CHECK( square1_volume( player.output() ) == 0xffffffff );
+    }
+}
+
+constexpr int8 pcm_sample[16] = { 0, 40, 80, 120, 80, 40, 0, -40, -80, -120, -80, -40, 0, 20, 0, -20 };
+
+constexpr music_instrument song_instruments[] = {
+    { .volume = 10, .duty = duty::half },
+    { .volume = 15, .wave = &triangle },
+    { .volume = 8, .noise_stages = counter_stages::_7 },
+    { .volume = 40, .sample = pcm_sample, .sample_length = 16, .sample_rate = 8000 }
+};
+
+// Square 1, square 2, wave, noise and one PCM voice
+constexpr music_cell pattern0[] = {
+    { 25, 1, music_effect::slide_up, 4 }, { 37, 1, music_effect::note_cut, 2 }, { 13, 2, music_effect::none, 0 }, { 30, 3, music_effect::none, 0 }, { 25, 4, music_effect::none, 0 },
+    { 0, 0, music_effect::volume_slide, 0x03 }, { music_cell::note_off, 0, music_effect::none, 0 }, { 0, 0, music_effect::set_speed, 2 }, { 0, 0, music_effect::slide_down, 1 }, { 0, 0, music_effect::slide_down, 1 }
+};
+
+constexpr music_cell pattern1[] = {
+    { 30, 0, music_effect::set_volume, 6 }, {}, { music_cell::note_off, 0, music_effect::none, 0 }, {}, {},
+    {}, {}, {}, { 0, 0, music_effect::pattern_break, 1 }, {},
+    { 72, 1, music_effect::none, 0 }, {}, {}, {}, {},
+    { 72, 1, music_effect::none, 0 }, {}, {}, {}, {}
+};
+
+constexpr music_cell pattern2[] = {
+    { 72, 1, music_effect::none, 0 }, {}, {}, {}, {},
+    {}, { 49, 1, music_effect::none, 0 }, {}, {}, { music_cell::note_off, 0, music_effect::jump, 0 }
+};
+
+constexpr music_pattern song_patterns[] = { { pattern0, 2 }, { pattern1, 4 }, { pattern2, 2 } };
+constexpr uint8 song_order[] = { 0, 1, 2 };
+constexpr music_song five_channel_song = { song_order, 3, 0, song_patterns, song_instruments, 5, 3 };
+
+struct golden_write {
+    uint32 address;
+    uint32 value;
+};
+
+// Every write of play() and 13 ticks, hand-checked against the register layouts and rate tables
+constexpr golden_write golden[] = {
+    // play(): sound on, DMG channels to both sides at full volume, no sweep
+    { 0x4000084, 0x0080 }, { 0x4000080, 0xff77 }, { 0x4000060, 0x0000 },
+    // Tick 0, order 0 row 0: square 1 C4 (2048 - 501), square 2 C5, wave C3 after uploading its wave RAM to bank 1,
+    // noise note 30 (divider 2, 7 stages, shift 9), PCM at 8000Hz and volume 40
+    { 0x4000062, 0xa080 }, { 0x4000064, 0x860b },
+    { 0x4000068, 0xa080 }, { 0x400006c, 0x8706 },
+    { 0x4000070, 0x0040 }, { 0x4000090, 0x01234567 }, { 0x4000094, 0x89abcdef }, { 0x4000098, 0xfedcba98 }, { 0x400009c, 0x76543210 },
+    { 0x4000070, 0x0080 }, { 0x4000072, 0x2000 }, { 0x4000074, 0x860b },
+    { 0x4000078, 0x8000 }, { 0x400007c, 0x809a },
+    { register_log<256>::pcm_address, 8000 }, { register_log<256>::pcm_address, 40 },
+    // Ticks 1 and 2: square 1 slides up by 4 without retriggering; square 2 is cut on tick 2
+    { 0x4000064, 0x060f },
+    { 0x4000064, 0x0613 }, { 0x4000068, 0x0000 }, { 0x400006c, 0x8000 },
+    // Tick 3, row 1: square 2 note off; speed becomes 2
+    { 0x4000068, 0x0000 }, { 0x400006c, 0x8000 },
+    // Tick 4: square 1 volume slides down to 7, noise and PCM slide down
+    { 0x4000062, 0x7080 }, { 0x4000064, 0x8613 }, { 0x400007c, 0x009b }, { register_log<256>::pcm_address, 8000 - 16 },
+    // Tick 5, order 1 row 0: square 1 F4 at volume 6, keeping its instrument; wave off
+    { 0x4000062, 0x6080 }, { 0x4000064, 0x8689 }, { 0x4000070, 0x0000 },
+    // Ticks 6 to 8 write nothing; the break on row 1 skips order 2 row 0
+    // Tick 9, order 2 row 1: square 2 C6; the PCM voice stops and the song jumps back to order 0
+    { 0x4000068, 0xa080 }, { 0x400006c, 0x8783 }, { register_log<256>::pcm_address, 0 },
+    // Tick 11 repeats tick 0, tick 12 repeats tick 1
+    { 0x4000062, 0xa080 }, { 0x4000064, 0x860b },
+    { 0x4000068, 0xa080 }, { 0x400006c, 0x8706 },
+    { 0x4000070, 0x0040 }, { 0x4000090, 0x01234567 }, { 0x4000094, 0x89abcdef }, { 0x4000098, 0xfedcba98 }, { 0x400009c, 0x76543210 },
+    { 0x4000070, 0x0080 }, { 0x4000072, 0x2000 }, { 0x4000074, 0x860b },
+    { 0x4000078, 0x8000 }, { 0x400007c, 0x809a },
+    { register_log<256>::pcm_address, 8000 }, { register_log<256>::pcm_address, 40 },
+    { 0x4000064, 0x060f }
+};
+
+// Writes per tick, and the order and row each tick leaves the player at
+constexpr uint32 golden_ticks[][3] = {
+    { 16, 0, 0 }, { 1, 0, 0 }, { 3, 0, 1 }, { 2, 0, 1 }, { 4, 1, 0 }, { 3, 1, 0 }, { 0, 1, 1 },
+    { 0, 1, 1 }, { 0, 2, 1 }, { 3, 2, 1 }, { 0, 0, 0 }, { 16, 0, 0 }, { 1, 0, 1 }
+};
+
+void song_matches_golden_log() {
+    music_player<register_log<256>, 5> player;
+    player.play( five_channel_song );
+
+    uint32 wrongTicks = 0;
+    for ( const auto& expected : golden_ticks ) {
+        player.tick();
+        wrongTicks += player.last_tick_writes() != expected[0] || player.order() != expected[1] || player.row() != expected[2];
+    }
+    GBAXX_CHECK( wrongTicks == 0 );
+
+    const auto& log = player.output();
+    GBAXX_CHECK( log.size() == sizeof( golden ) / sizeof( golden[0] ) );
+    uint32 wrong = 0;
+    for ( uint32 ii = 0; ii < log.size() && ii < sizeof( golden ) / sizeof( golden[0] ); ++ii ) {
+        if ( log[ii].address != golden[ii].address || log[ii].value != golden[ii].value ) {
+            std::fprintf( stderr, "write %u is %08x = %04x, expected %08x = %04x\n", ii, log[ii].address, log[ii].value, golden[ii].address, golden[ii].value );
+            ++wrong;
+        }
+    }
+    GBAXX_CHECK( wrong == 0 );
+    GBAXX_CHECK( player.peak_tick_writes() == 16 );
+}
+
+} // namespace
+
+int main() {
+    writes_agree_with_log();
+    dmg_volume_clamps_to_15();
+    song_matches_golden_log();
+    return gba::test::result();
+}
@@ -0,0 +1,129 @@
+#include <cstring>
+
+#include <gba/system/power_manager.hpp>
+
+#include "check.hpp"
+
+using gba::idle_tracker;
+using gba::keypad;
+using gba::keypad_manager;
+using gba::power_manager;
+using gba::uint16;
+using gba::uint32;
+namespace key = gba::key;
+
+namespace {
+
+// Stands in for KEYINPUT; bits are clear while a key is held
+struct fake_keyinput {
+    using type = keypad;
+
+    static inline uint16 value = 0x3ff;
+
+    static keypad read() noexcept {
+        keypad keys;
+        std::memcpy( &keys, &value, sizeof( keys ) );
+        return keys;
+    }
+};
+
+constexpr bool times_out_after_idle_frames() {
+    idle_tracker tracker { 3 };
+    const auto first = tracker.update( 0 );
+    const auto second = tracker.update( 0 );
+    const auto third = tracker.update( 0 );
+    return !first && !second && third && tracker.expired() && tracker.idle_frames() == 3;
+}
+static_assert( times_out_after_idle_frames(), "idle_tracker must expire on the timeout frame" );
+
+void key_press_restarts_the_count() {
+    idle_tracker tracker { 5 };
+    for ( int ii = 0; ii < 4; ++ii ) {
+        GBAXX_CHECK( !tracker.update( 0 ) );
+    }
+    GBAXX_CHECK( tracker.idle_frames() == 4 );
+
+    GBAXX_CHECK( !tracker.update( key::start ) );
+    GBAXX_CHECK( tracker.idle_frames() == 0 );
+    for ( int ii = 0; ii < 4; ++ii ) {
+        GBAXX_CHECK( !tracker.update( 0 ) );
+    }
+    GBAXX_CHECK( tracker.update( 0 ) );
+
+    // Stays expired without counting past the timeout
+    for ( int ii = 0; ii < 100; ++ii ) {
+        tracker.update( 0 );
+    }
+    GBAXX_CHECK( tracker.expired() && tracker.idle_frames() == 5 );
+
+    tracker.reset();
+    GBAXX_CHECK( !tracker.expired() && tracker.idle_frames() == 0 );
+}
+
+void bits_above_the_keys_are_ignored() {
+    idle_tracker tracker { 2 };
+    GBAXX_CHECK( !tracker.update( 0xfc00 ) );
+    GBAXX_CHECK( tracker.update( 0xfc00 ) );
+}
+
+void timeout_can_change() {
+    idle_tracker tracker { 10 };
+    for ( int ii = 0; ii < 4; ++ii ) {
+        tracker.update( 0 );
+    }
+    tracker.set_timeout( 4 );
+    GBAXX_CHECK( tracker.timeout() == 4 );
+    GBAXX_CHECK( tracker.expired() );
+
+    tracker.set_timeout( 60 );
+    GBAXX_CHECK( !tracker.update( 0 ) );
+    GBAXX_CHECK( tracker.idle_frames() == 5 );
+}
+
+void follows_keypad_manager() {
+    keypad_manager<fake_keyinput> keypad;
+    idle_tracker tracker { 3 };
+
+    // key_mask() sets every bit above the ten keys when none is held; they must not count as input
+    fake_keyinput::value = 0x3ff;
+    GBAXX_CHECK( !tracker.update( keypad.poll() ) );
+    GBAXX_CHECK( tracker.idle_frames() == 1 );
+
+    fake_keyinput::value = uint16( 0x3ff & ~0x1 );
+    GBAXX_CHECK( !tracker.update( keypad.poll() ) );
+    GBAXX_CHECK( tracker.idle_frames() == 0 );
+
+    fake_keyinput::value = 0x3ff;
+    for ( int ii = 0; ii < 2; ++ii ) {
+        GBAXX_CHECK( !tracker.update( keypad.poll() ) );
+    }
+    GBAXX_CHECK( tracker.update( keypad.poll() ) );
+}
+
+void power_manager_waits_for_the_timeout() {
+    keypad_manager<fake_keyinput> keypad;
+    power_manager power { key::select | key::start, 120 };
+
+    // Held input keeps it awake indefinitely; stopping itself needs the hardware
+    fake_keyinput::value = uint16( 0x3ff & ~0x10 );
+    for ( int ii = 0; ii < 500; ++ii ) {
+        GBAXX_CHECK( !power.update( keypad.poll() ) );
+    }
+    fake_keyinput::value = 0x3ff;
+    for ( int ii = 0; ii < 119; ++ii ) {
+        GBAXX_CHECK( !power.update( keypad.poll() ) );
+    }
+    GBAXX_CHECK( power.tracker().idle_frames() == 119 );
+    GBAXX_CHECK( power.sleeps() == 0 );
+}
+
+} // namespace
+
+int main() {
+    key_press_restarts_the_count();
+    bits_above_the_keys_are_ignored();
+    timeout_can_change();
+    follows_keypad_manager();
+    power_manager_waits_for_the_timeout();
+    return gba::test::result();
+}